@@ -1,11 +1,11 @@
 
 if [ "$#" -lt 1 ]; then
-  echo "At least one argument required. The first argument should be 'install', 'test' or 'docs'."
+  echo "At least one argument required. The first argument should be 'install', 'test', 'bench' or 'docs'."
   exit
 fi
 
-if [ "docs" != $1 ] && [ "test" != $1 ] && [ "install" != $1 ] ; then
-  echo "The first argument should be 'install', 'test' or 'docs'."
+if [ "docs" != $1 ] && [ "test" != $1 ] && [ "bench" != $1 ] && [ "install" != $1 ] ; then
+  echo "The first argument should be 'install', 'test', 'bench' or 'docs'."
   exit
 fi
 
@@ -21,13 +21,24 @@ if [ "docs" = $1 ]; then
   "src/string.c" \
   "src/string_split.c" \
   "src/string_fmt.c" \
+  "src/string_compact.c" \
+  "src/string_intern.c" \
+  "src/string_rope.c" \
+  "src/string_view.c" \
+  "src/string_packed.c" \
+  "src/string_list.c" \
+  "src/string_searcher.c" \
+  "src/string_matcher.c" \
+  "src/string_alloc.c" \
+  "src/string_stats.c" \
   "src/string_err.c"
 
   rm tmp/ss.h
   rmdir tmp
 fi
 
-# Command to perform tests.
+# Command to perform tests. The suite runs twice, the second
+# time with the struct and the buffer in a single allocation.
 if [ "test" = $1 ]; then
   rm -rf build
   cmake -S . -DSS_ALLOC_EXIT=ON -B build/
@@ -36,6 +47,27 @@ if [ "test" = $1 ]; then
   cd ..
   ./build/ss_tests
 
+  rm -rf build
+  cmake -S . -DSS_ALLOC_EXIT=ON -DSS_SINGLE_ALLOC=ON -B build/
+  cd build
+  cmake --build .
+  cd ..
+  ./build/ss_tests
+
+  rm tmp/ss.h
+  rmdir tmp
+fi
+
+# Command to run the benchmarks.
+if [ "bench" = $1 ]; then
+  rm -rf build
+  cmake -S . -DSS_ALLOC_EXIT=ON -DCMAKE_BUILD_TYPE=Release -B build/
+  cd build
+  cmake --build .
+  cd ..
+  ./build/growth_bench
+  ./build/search_bench
+
   rm tmp/ss.h
   rmdir tmp
 fi
@@ -45,6 +77,9 @@ if [ "install" = $1 ]; then
 
   # List of options to be chosen.
   WITH_EXIT_OPTION="--with-exit"
+  SINGLE_ALLOC_OPTION="--single-alloc"
+  STATS_OPTION="--stats"
+  NO_SIMD_OPTION="--no-simd"
   OPTIONS=""
   for var in "$@"
   do
@@ -52,6 +87,18 @@ if [ "install" = $1 ]; then
         echo "${WITH_EXIT_OPTION} option selected"
         OPTIONS="${OPTIONS} -DSS_ALLOC_EXIT=ON"
       fi
+      if [ $var = $SINGLE_ALLOC_OPTION ]; then
+        echo "${SINGLE_ALLOC_OPTION} option selected"
+        OPTIONS="${OPTIONS} -DSS_SINGLE_ALLOC=ON"
+      fi
+      if [ $var = $STATS_OPTION ]; then
+        echo "${STATS_OPTION} option selected"
+        OPTIONS="${OPTIONS} -DSS_STATS=ON"
+      fi
+      if [ $var = $NO_SIMD_OPTION ]; then
+        echo "${NO_SIMD_OPTION} option selected"
+        OPTIONS="${OPTIONS} -DSS_NO_SIMD=ON"
+      fi
   done
 
   rm -rf build
@@ -1,8 +1,13 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "options.h"
+#include "alloc.h"
+#include "stats.h"
 
 /*
+ * All the memory of the library goes through an allocator vtable. If `alloc` is NULL
+ * the allocator currently set with `ss_set_allocator` is used.
+ *
  * If SS_ALLOC_EXIT is defined (through the CMake options at compile time), failures
  * in memory allocation will abort the program. In this case the user doesn't need
  * to check returned string pointers or string errors. Otherwise, the default behaviour
@@ -11,8 +16,11 @@
 
 #ifdef SS_ALLOC_EXIT
 
-void *ss_malloc(size_t size) {
-    void *ptr = malloc(size);
+void *ss_malloc(const ss_allocator *alloc, size_t size) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    SS_STAT_ADD(stat_n_malloc, 1);
+    SS_STAT_ADD(stat_malloc_bytes, size);
+    void *ptr = alloc->malloc(alloc->ctx, size);
     if (ptr == NULL) {
         printf("ss_lib: cannot allocate memory\n");
         exit(1);
@@ -20,8 +28,11 @@ void *ss_malloc(size_t size) {
     return ptr;
 }
 
-void *ss_realloc(void *ptr, size_t size) {
-    void *new_ptr = realloc(ptr, size);
+void *ss_realloc(const ss_allocator *alloc, void *ptr, size_t size) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    SS_STAT_ADD(stat_n_realloc, 1);
+    SS_STAT_ADD(stat_realloc_bytes, size);
+    void *new_ptr = alloc->realloc(alloc->ctx, ptr, size);
     if (new_ptr == NULL) {
         printf("ss_lib: cannot allocate memory\n");
         exit(1);
@@ -31,12 +42,24 @@ void *ss_realloc(void *ptr, size_t size) {
 
 #else
 
-void *ss_malloc(size_t size) {
-    return malloc(size);
+void *ss_malloc(const ss_allocator *alloc, size_t size) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    SS_STAT_ADD(stat_n_malloc, 1);
+    SS_STAT_ADD(stat_malloc_bytes, size);
+    return alloc->malloc(alloc->ctx, size);
 }
 
-void *ss_realloc(void *ptr, size_t size) {
-    return realloc(ptr, size);
+void *ss_realloc(const ss_allocator *alloc, void *ptr, size_t size) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    SS_STAT_ADD(stat_n_realloc, 1);
+    SS_STAT_ADD(stat_realloc_bytes, size);
+    return alloc->realloc(alloc->ctx, ptr, size);
 }
 
 #endif
+
+void ss_dealloc(const ss_allocator *alloc, void *ptr) {
+    if (ptr == NULL) return;
+    if (alloc == NULL) alloc = ss_get_allocator();
+    alloc->free(alloc->ctx, ptr);
+}
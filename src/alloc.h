@@ -2,7 +2,17 @@
 #ifndef SS_ALLOC_H
 #define SS_ALLOC_H
 
-void *ss_malloc(size_t size);
-void *ss_realloc(void *ptr, size_t size);
+#include "string_alloc.h"
+
+void *ss_malloc(const ss_allocator *alloc, size_t size);
+void *ss_realloc(const ss_allocator *alloc, void *ptr, size_t size);
+void ss_dealloc(const ss_allocator *alloc, void *ptr);
+const ss_allocator *ss_default_allocator(void);
+
+int ss_map_eligible(const ss_allocator *alloc, size_t size);
+char *ss_map(size_t size);
+char *ss_remap(char *ptr, size_t old_size, size_t new_size);
+void ss_unmap(char *ptr, size_t size);
+void ss_unmap_unused(char *ptr, size_t used, size_t size);
 
 #endif
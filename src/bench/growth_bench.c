@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../string.h"
+#include "../string_alloc.h"
+
+// Benchmark of the growth policies. Each policy is measured on two workloads:
+// building a big string with many small appends, and building many small
+// strings with a few appends each. For each run the elapsed time, the number
+// of allocator calls and the memory allocated but unused are reported.
+
+#define BIG_TARGET (64 * 1024 * 1024)
+#define SMALL_STRINGS (200 * 1000)
+
+typedef struct bench_stats {
+    size_t n_malloc;
+    size_t n_realloc;
+} bench_stats;
+
+typedef struct bench_policy {
+    const char *name;
+    ss_growth growth;
+} bench_policy;
+
+static void *bench_malloc(void *ctx, size_t size);
+static void *bench_realloc(void *ctx, void *ptr, size_t size);
+static void bench_free(void *ctx, void *ptr);
+static double now_ms(void);
+static void bench_big_string(const bench_policy *policy, bench_stats *stats);
+static void bench_small_strings(const bench_policy *policy, bench_stats *stats);
+
+int main(void) {
+    bench_policy policies[] = {
+        {"geometric x2 (default)", {.kind = growth_geometric, .factor = 2}},
+        {"geometric x1.5", {.kind = growth_geometric, .factor = 1.5}},
+        {"capped 1MiB", {.kind = growth_capped, .limit = 1024 * 1024}},
+        {"size class", {.kind = growth_size_class}},
+        {"exact", {.kind = growth_exact}},
+    };
+    int n_policies = sizeof(policies) / sizeof(policies[0]);
+
+    bench_stats stats;
+    ss_allocator alloc = {
+        .malloc = bench_malloc,
+        .realloc = bench_realloc,
+        .free = bench_free,
+        .ctx = &stats
+    };
+    ss_set_allocator(&alloc);
+
+    printf("\n  big string: %d MiB built with 64 bytes appends\n\n", BIG_TARGET / (1024 * 1024));
+    printf("  %-24s %12s %12s %12s %14s\n", "policy", "time (ms)", "mallocs", "reallocs", "unused (KiB)");
+    for (int i = 0; i < n_policies; i++) {
+        bench_big_string(&policies[i], &stats);
+    }
+
+    printf("\n  small strings: %d strings built with 4 appends of 6 bytes\n\n", SMALL_STRINGS);
+    printf("  %-24s %12s %12s %12s %14s\n", "policy", "time (ms)", "mallocs", "reallocs", "unused (KiB)");
+    for (int i = 0; i < n_policies; i++) {
+        bench_small_strings(&policies[i], &stats);
+    }
+
+    ss_set_allocator(NULL);
+    ss_set_growth(NULL);
+    return 0;
+}
+
+static void bench_big_string(const bench_policy *policy, bench_stats *stats) {
+    const char chunk[] = "0123456789012345678901234567890123456789012345678901234567890123";
+    ss_set_growth(&policy->growth);
+    *stats = (bench_stats){0};
+
+    double start = now_ms();
+    ss s = ss_new_from_raw("");
+    while (s->len < BIG_TARGET) {
+        ss_concat_raw_len(s, chunk, 64);
+    }
+    double elapsed = now_ms() - start;
+
+    printf("  %-24s %12.2f %12zu %12zu %14zu\n",
+        policy->name, elapsed, stats->n_malloc, stats->n_realloc, s->free / 1024);
+    ss_free(s);
+}
+
+static void bench_small_strings(const bench_policy *policy, bench_stats *stats) {
+    ss *strings = malloc(sizeof(ss) * SMALL_STRINGS);
+    if (strings == NULL) {
+        printf("cannot allocate benchmark memory\n");
+        exit(1);
+    }
+    ss_set_growth(&policy->growth);
+    *stats = (bench_stats){0};
+
+    double start = now_ms();
+    size_t unused = 0;
+    for (int i = 0; i < SMALL_STRINGS; i++) {
+        ss s = ss_new_from_raw("key");
+        for (int j = 0; j < 4; j++) ss_concat_raw_len(s, ":field", 6);
+        unused += s->free;
+        strings[i] = s;
+    }
+    double elapsed = now_ms() - start;
+
+    printf("  %-24s %12.2f %12zu %12zu %14zu\n",
+        policy->name, elapsed, stats->n_malloc, stats->n_realloc, unused / 1024);
+    for (int i = 0; i < SMALL_STRINGS; i++) ss_free(strings[i]);
+    free(strings);
+}
+
+static void *bench_malloc(void *ctx, size_t size) {
+    ((bench_stats *)ctx)->n_malloc++;
+    return malloc(size);
+}
+
+static void *bench_realloc(void *ctx, void *ptr, size_t size) {
+    ((bench_stats *)ctx)->n_realloc++;
+    return realloc(ptr, size);
+}
+
+static void bench_free(void *ctx, void *ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
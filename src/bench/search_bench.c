@@ -0,0 +1,303 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../string.h"
+#include "../search.h"
+#include "../string_searcher.h"
+
+// Benchmark of the substring search. For each needle length the needle is
+// searched in a big haystack where it occurs only at the end, so the whole
+// haystack is scanned, with ss_index, the Two-Way search alone and the
+// glibc strstr and memmem. Two haystacks are measured: random lowercase
+// text, where the first and last bytes of the needle rarely match together,
+// and a periodic one ("aaa...ab" in "aaa...a"), which makes naive searches
+// quadratic. The backward searches are measured the same way, with the
+// needle only at the start, against the repeated strstr calls previously
+// used by ss_index_last. Two more backward haystacks are dense: one with
+// a near match of the needle (first and last bytes equal, a middle byte
+// different) every two needle lengths, where every block has candidates to
+// verify, and one with real matches at the same distance, where all of
+// them are visited from the end with ss_index_last_before. The reported
+// speed is the haystack size over the best time. Finally the haystack is searched as many short records, to
+// compare preparing the needle for each record (ss_search, as ss_index
+// does) with a searcher prepared once.
+
+#define HAYSTACK_SIZE (16 * 1024 * 1024)
+#define RUNS 10
+#define RECORD_SIZE 64
+
+typedef size_t (*search_fn)(ss haystack, const char *needle, size_t needle_len);
+
+// Kinds of haystacks: random text, periodic text, random text with dense
+// near matches and random text with dense matches of the needle.
+typedef enum haystack_kind {
+    haystack_random,
+    haystack_periodic,
+    haystack_near,
+    haystack_dense
+} haystack_kind;
+
+typedef struct bench_search {
+    const char *name;
+    search_fn fn;
+} bench_search;
+
+static size_t search_ss_index(ss haystack, const char *needle, size_t needle_len);
+static size_t search_two_way(ss haystack, const char *needle, size_t needle_len);
+static size_t search_strstr(ss haystack, const char *needle, size_t needle_len);
+static size_t search_memmem(ss haystack, const char *needle, size_t needle_len);
+static size_t search_searcher(ss haystack, const char *needle, size_t needle_len);
+static size_t search_ss_index_last(ss haystack, const char *needle, size_t needle_len);
+static size_t search_two_way_last(ss haystack, const char *needle, size_t needle_len);
+static size_t search_strstr_last(ss haystack, const char *needle, size_t needle_len);
+static size_t search_all_ss_index_last(ss haystack, const char *needle, size_t needle_len);
+static size_t search_all_two_way_last(ss haystack, const char *needle, size_t needle_len);
+static size_t search_all_strstr(ss haystack, const char *needle, size_t needle_len);
+static void bench_haystack(const char *title, haystack_kind kind, int backward, const bench_search *searches,
+                           int n_searches);
+static void bench_records(void);
+static double now_ms(void);
+
+int main(void) {
+    bench_search searches[] = {
+        {"ss_index", search_ss_index},
+        {"two-way", search_two_way},
+        {"strstr", search_strstr},
+        {"memmem", search_memmem},
+        {"ss_searcher", search_searcher},
+    };
+    int n_searches = sizeof(searches) / sizeof(searches[0]);
+
+    bench_search last_searches[] = {
+        {"ss_index_last", search_ss_index_last},
+        {"two-way", search_two_way_last},
+        {"strstr loop", search_strstr_last},
+    };
+    int n_last_searches = sizeof(last_searches) / sizeof(last_searches[0]);
+
+    bench_search all_searches[] = {
+        {"ss_index_last", search_all_ss_index_last},
+        {"two-way", search_all_two_way_last},
+        {"strstr loop", search_all_strstr},
+    };
+    int n_all_searches = sizeof(all_searches) / sizeof(all_searches[0]);
+
+    bench_haystack("random text", haystack_random, 0, searches, n_searches);
+    bench_haystack("periodic text", haystack_periodic, 0, searches, n_searches);
+    bench_haystack("random text, backward", haystack_random, 1, last_searches, n_last_searches);
+    bench_haystack("periodic text, backward", haystack_periodic, 1, last_searches, n_last_searches);
+    bench_haystack("dense near matches, backward", haystack_near, 1, last_searches, n_last_searches);
+    bench_haystack("dense matches, all of them backward", haystack_dense, 1, all_searches, n_all_searches);
+    bench_records();
+    return 0;
+}
+
+static void bench_haystack(const char *title, haystack_kind kind, int backward, const bench_search *searches,
+                           int n_searches) {
+    int periodic = kind == haystack_periodic;
+    size_t lengths[] = {1, 2, 3, 4, 8, 16, 32, 64, 256, 1024};
+    int n_lengths = sizeof(lengths) / sizeof(lengths[0]);
+
+    ss haystack = ss_new_empty_with_free(HAYSTACK_SIZE);
+    char *needle = malloc(lengths[n_lengths - 1] + 1);
+    if (haystack == NULL || needle == NULL) {
+        printf("cannot allocate benchmark memory\n");
+        exit(1);
+    }
+
+    printf("\n  %s: %d MiB haystack, speed in GiB/s\n\n", title, HAYSTACK_SIZE / (1024 * 1024));
+    printf("  %-8s", "needle");
+    for (int k = 0; k < n_searches; k++) printf(" %14s", searches[k].name);
+    printf("\n");
+
+    for (int i = 0; i < n_lengths; i++) {
+        size_t len = lengths[i];
+        srand(42);
+        for (size_t j = 0; j < HAYSTACK_SIZE; j++) {
+            haystack->buf[j] = periodic ? 'a' : (char)('a' + rand() % 26);
+        }
+        for (size_t j = 0; j < len; j++) {
+            needle[j] = periodic ? 'a' : (char)('a' + rand() % 26);
+        }
+        if (periodic) needle[backward ? 0 : len - 1] = 'b';
+        needle[len] = '\0';
+        size_t want = backward ? 0 : HAYSTACK_SIZE - len;
+        // Plant a copy of the needle every two needle lengths, changing its
+        // middle byte for the near matches (or its last one if the needle
+        // has no middle).
+        if (kind == haystack_near || kind == haystack_dense) {
+            for (size_t j = 0; j + len <= HAYSTACK_SIZE; j += 2 * len) {
+                memcpy(haystack->buf + j, needle, len);
+                if (kind == haystack_dense) continue;
+                size_t k = len > 2 ? len / 2 : len - 1;
+                haystack->buf[j + k] = needle[k] == 'a' ? 'b' : 'a';
+            }
+        }
+        // Break the random occurrences of the needle in the text, changing
+        // their last byte, so that it's found only at the end (or only at
+        // the start for the backward searches).
+        char *start = haystack->buf + (backward ? len : 0);
+        char *end = haystack->buf + (backward ? HAYSTACK_SIZE : HAYSTACK_SIZE - len);
+        for (char *p = start; kind != haystack_dense && (p = memmem(p, end - p, needle, len)) != NULL;) {
+            p[len - 1] = p[len - 1] == 'a' ? 'b' : 'a';
+        }
+        memcpy(haystack->buf + want, needle, len);
+        haystack->buf[HAYSTACK_SIZE] = '\0';
+        haystack->len = HAYSTACK_SIZE;
+        haystack->free = 0;
+
+        printf("  %-8zu", len);
+        for (int k = 0; k < n_searches; k++) {
+            double best = -1;
+            size_t pos = 0;
+            for (int run = 0; run < RUNS; run++) {
+                double start = now_ms();
+                pos = searches[k].fn(haystack, needle, len);
+                double elapsed = now_ms() - start;
+                if (best < 0 || elapsed < best) best = elapsed;
+            }
+            if (pos != want) {
+                printf(" %14s", "wrong");
+                continue;
+            }
+            printf(" %14.2f", HAYSTACK_SIZE / (best / 1000) / (1024.0 * 1024 * 1024));
+        }
+        printf("\n");
+    }
+
+    free(needle);
+    ss_free(haystack);
+}
+
+// Search the needles in the haystack split in records of RECORD_SIZE
+// bytes, as when matching the lines of a file, counting the records that
+// contain the needle.
+static void bench_records(void) {
+    size_t lengths[] = {2, 4, 8, 16, 32};
+    int n_lengths = sizeof(lengths) / sizeof(lengths[0]);
+
+    char *haystack = malloc(HAYSTACK_SIZE);
+    if (haystack == NULL) {
+        printf("cannot allocate benchmark memory\n");
+        exit(1);
+    }
+    srand(42);
+    for (size_t j = 0; j < HAYSTACK_SIZE; j++) haystack[j] = (char)('a' + rand() % 26);
+
+    printf("\n  %d byte records: %d MiB haystack, speed in GiB/s\n\n", RECORD_SIZE, HAYSTACK_SIZE / (1024 * 1024));
+    printf("  %-8s %14s %14s\n", "needle", "ss_search", "ss_searcher");
+
+    for (int i = 0; i < n_lengths; i++) {
+        size_t len = lengths[i];
+        const char *needle = haystack + HAYSTACK_SIZE / 2;
+        ss_searcher searcher = ss_searcher_new_raw_len(needle, len);
+        double best[2] = {-1, -1};
+        size_t found[2] = {0, 0};
+
+        for (int run = 0; run < RUNS; run++) {
+            for (int k = 0; k < 2; k++) {
+                double start = now_ms();
+                found[k] = 0;
+                for (size_t off = 0; off < HAYSTACK_SIZE; off += RECORD_SIZE) {
+                    size_t pos = k == 0 ? ss_search(haystack + off, RECORD_SIZE, needle, len)
+                                        : ss_searcher_find_raw_len(searcher, haystack + off, RECORD_SIZE);
+                    found[k] += pos != (size_t)-1;
+                }
+                double elapsed = now_ms() - start;
+                if (best[k] < 0 || elapsed < best[k]) best[k] = elapsed;
+            }
+        }
+
+        printf("  %-8zu", len);
+        for (int k = 0; k < 2; k++) {
+            if (found[k] != found[0] || found[k] == 0) printf(" %14s", "wrong");
+            else printf(" %14.2f", HAYSTACK_SIZE / (best[k] / 1000) / (1024.0 * 1024 * 1024));
+        }
+        printf("\n");
+        ss_searcher_free(searcher);
+    }
+    free(haystack);
+}
+
+static size_t search_ss_index(ss haystack, const char *needle, size_t needle_len) {
+    (void)needle_len;
+    return ss_index(haystack, needle);
+}
+
+static size_t search_two_way(ss haystack, const char *needle, size_t needle_len) {
+    return ss_search_two_way(haystack->buf, haystack->len, needle, needle_len);
+}
+
+static size_t search_strstr(ss haystack, const char *needle, size_t needle_len) {
+    (void)needle_len;
+    char *p = strstr(haystack->buf, needle);
+    return p != NULL ? (size_t)(p - haystack->buf) : (size_t)-1;
+}
+
+static size_t search_memmem(ss haystack, const char *needle, size_t needle_len) {
+    char *p = memmem(haystack->buf, haystack->len, needle, needle_len);
+    return p != NULL ? (size_t)(p - haystack->buf) : (size_t)-1;
+}
+
+static size_t search_searcher(ss haystack, const char *needle, size_t needle_len) {
+    ss_searcher searcher = ss_searcher_new_raw_len(needle, needle_len);
+    size_t pos = ss_searcher_find(searcher, haystack);
+    ss_searcher_free(searcher);
+    return pos;
+}
+
+static size_t search_ss_index_last(ss haystack, const char *needle, size_t needle_len) {
+    (void)needle_len;
+    return ss_index_last(haystack, needle);
+}
+
+static size_t search_two_way_last(ss haystack, const char *needle, size_t needle_len) {
+    return ss_search_last_two_way(haystack->buf, haystack->len, needle, needle_len);
+}
+
+static size_t search_strstr_last(ss haystack, const char *needle, size_t needle_len) {
+    (void)needle_len;
+    char *last = NULL;
+    for (char *p = haystack->buf; (p = strstr(p, needle)) != NULL; p++) last = p;
+    return last != NULL ? (size_t)(last - haystack->buf) : (size_t)-1;
+}
+
+// Visit all the occurrences of the needle from the end with
+// ss_index_last_before, overlapping ones included, and return the first.
+static size_t search_all_ss_index_last(ss haystack, const char *needle, size_t needle_len) {
+    size_t first = -1;
+    size_t end = haystack->len;
+    for (size_t pos; (pos = ss_index_last_before(haystack, needle, end)) != (size_t)-1;) {
+        first = pos;
+        end = pos + needle_len - 1;
+    }
+    return first;
+}
+
+static size_t search_all_two_way_last(ss haystack, const char *needle, size_t needle_len) {
+    size_t first = -1;
+    size_t end = haystack->len;
+    for (size_t pos; (pos = ss_search_last_two_way(haystack->buf, end, needle, needle_len)) != (size_t)-1;) {
+        first = pos;
+        end = pos + needle_len - 1;
+    }
+    return first;
+}
+
+// Visit all the occurrences of the needle from the start with strstr.
+static size_t search_all_strstr(ss haystack, const char *needle, size_t needle_len) {
+    (void)needle_len;
+    char *first = NULL;
+    for (char *p = haystack->buf; (p = strstr(p, needle)) != NULL; p++) {
+        if (first == NULL) first = p;
+    }
+    return first != NULL ? (size_t)(first - haystack->buf) : (size_t)-1;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
@@ -0,0 +1,115 @@
+#include <string.h>
+#include "charset.h"
+#include "simd.h"
+
+// Kernels scanning a buffer for the bytes of a set.
+enum kernel {
+    kernel_scalar,
+    kernel_memchr,
+    kernel_sse2,
+    kernel_avx2
+};
+
+static size_t find_scalar(const ss_charset *set, const char *s, size_t len);
+#ifdef SS_SIMD_X86
+static size_t find_sse2(const ss_charset *set, const char *s, size_t len);
+static size_t find_avx2(const ss_charset *set, const char *s, size_t len);
+#endif
+
+/*
+ * Build the set `set` of the bytes of the null terminated string `chars`.
+ * Repeated bytes are counted once. An empty (or NULL) string builds an
+ * empty set, which matches no byte.
+ */
+void ss_charset_init(ss_charset *set, const char *chars) {
+    memset(set->map, 0, sizeof(set->map));
+    set->n = 0;
+
+    size_t distinct = 0;
+    for (const unsigned char *c = (const unsigned char *)(chars != NULL ? chars : ""); *c; c++) {
+        if (set->map[*c >> 3] & (1u << (*c & 7))) continue;
+        set->map[*c >> 3] |= (unsigned char)(1u << (*c & 7));
+        if (distinct < SS_CHARSET_MAX_SIMD) set->chars[distinct] = *c;
+        distinct++;
+    }
+
+    set->n = distinct <= SS_CHARSET_MAX_SIMD ? (int)distinct : 0;
+    set->kernel = kernel_scalar;
+    if (distinct == 1) set->kernel = kernel_memchr;
+    if (distinct > 1 && distinct <= SS_CHARSET_MAX_SIMD) {
+#ifdef SS_SIMD_X86
+        set->kernel = ss_cpu_has_avx2() ? kernel_avx2 : kernel_sse2;
+#endif
+    }
+}
+
+/*
+ * Returns the position of the first byte of the `len` bytes starting at
+ * `s` that belongs to the set `set`, or `len` if there is none.
+ */
+size_t ss_charset_find(const ss_charset *set, const char *s, size_t len) {
+    switch (set->kernel) {
+        case kernel_memchr: {
+            const char *p = memchr(s, set->chars[0], len);
+            return p != NULL ? (size_t)(p - s) : len;
+        }
+#ifdef SS_SIMD_X86
+        case kernel_sse2:
+            return find_sse2(set, s, len);
+        case kernel_avx2:
+            return find_avx2(set, s, len);
+#endif
+        default:
+            return find_scalar(set, s, len);
+    }
+}
+
+// Scan the buffer one byte at a time, looking the bytes up in the bitmap.
+static size_t find_scalar(const ss_charset *set, const char *s, size_t len) {
+    const unsigned char *p = (const unsigned char *)s;
+    for (size_t i = 0; i < len; i++) {
+        if (set->map[p[i] >> 3] & (1u << (p[i] & 7))) return i;
+    }
+    return len;
+}
+
+#ifdef SS_SIMD_X86
+
+// Scan the buffer 16 bytes at a time: each block is compared with every
+// byte of the set, the matches are merged and the position of the first
+// one is taken from the mask of the block. The tail is scanned by
+// find_scalar.
+static size_t find_sse2(const ss_charset *set, const char *s, size_t len) {
+    __m128i chars[SS_CHARSET_MAX_SIMD];
+    for (int k = 0; k < set->n; k++) chars[k] = _mm_set1_epi8((char)set->chars[k]);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i hits = _mm_cmpeq_epi8(block, chars[0]);
+        for (int k = 1; k < set->n; k++) hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, chars[k]));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hits);
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + find_scalar(set, s + i, len - i);
+}
+
+// Same as find_sse2 with blocks of 32 bytes, compiled for AVX2 and called
+// only if the CPU supports it.
+__attribute__((target("avx2")))
+static size_t find_avx2(const ss_charset *set, const char *s, size_t len) {
+    __m256i chars[SS_CHARSET_MAX_SIMD];
+    for (int k = 0; k < set->n; k++) chars[k] = _mm256_set1_epi8((char)set->chars[k]);
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i hits = _mm256_cmpeq_epi8(block, chars[0]);
+        for (int k = 1; k < set->n; k++) hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(block, chars[k]));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(hits);
+        if (mask != 0) return i + __builtin_ctz(mask);
+    }
+    return i + find_sse2(set, s + i, len - i);
+}
+
+#endif
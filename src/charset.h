@@ -0,0 +1,27 @@
+#ifndef SS_CHARSET_H
+#define SS_CHARSET_H
+
+#include <stddef.h>
+
+/*
+ * A set of bytes, used to find the first byte of a buffer that belongs to
+ * the set (e.g. any of several delimiters). The set keeps a bitmap for the
+ * scalar scan and, when it's small, the list of its bytes, which the SIMD
+ * kernels compare against a whole block of the buffer at once. The kernel
+ * is chosen when the set is built: AVX2 if the CPU supports it, then SSE2,
+ * then the scalar bitmap scan (see simd.h).
+ */
+
+#define SS_CHARSET_MAX_SIMD 16
+
+typedef struct ss_charset {
+    unsigned char map[32];
+    unsigned char chars[SS_CHARSET_MAX_SIMD];
+    int n;
+    int kernel;
+} ss_charset;
+
+void ss_charset_init(ss_charset *set, const char *chars);
+size_t ss_charset_find(const ss_charset *set, const char *s, size_t len);
+
+#endif
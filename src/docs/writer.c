@@ -80,6 +80,36 @@ ss gen_funcs_documentation(func_doc *funcs, int funcs_n) {
         if (strcmp(funcs[i].func_name->buf, "ss_sprintf_va_cat") == 0) {
             ss_concat_raw(api_docs, "#### String formatting\n");
         }
+        if (strcmp(funcs[i].func_name->buf, "ss_compact_new_from_raw_len_free") == 0) {
+            ss_concat_raw(api_docs, "#### Compact strings\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_intern_raw_len") == 0) {
+            ss_concat_raw(api_docs, "#### String interning\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_rope_new") == 0) {
+            ss_concat_raw(api_docs, "#### Ropes\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_view_from_raw_len") == 0) {
+            ss_concat_raw(api_docs, "#### String views\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_packed_new") == 0) {
+            ss_concat_raw(api_docs, "#### Packed lists\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_list_new") == 0) {
+            ss_concat_raw(api_docs, "#### String lists\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_searcher_new_raw_len") == 0) {
+            ss_concat_raw(api_docs, "#### Searchers\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_matcher_new") == 0) {
+            ss_concat_raw(api_docs, "#### Multi-pattern search\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_set_allocator") == 0) {
+            ss_concat_raw(api_docs, "#### Memory allocation\n");
+        }
+        if (strcmp(funcs[i].func_name->buf, "ss_stats_get") == 0) {
+            ss_concat_raw(api_docs, "#### Statistics\n");
+        }
         if (strcmp(funcs[i].func_name->buf, "ss_err_str") == 0) {
             ss_concat_raw(api_docs, "#### Error handling\n");
         }
@@ -105,6 +135,36 @@ ss gen_funcs_documentation(func_doc *funcs, int funcs_n) {
         if (strcmp(doc.func_name->buf, "ss_sprintf_va_cat") == 0) {
             ss_concat_raw(api_docs, "## String formatting\n\n");
         }
+        if (strcmp(doc.func_name->buf, "ss_compact_new_from_raw_len_free") == 0) {
+            ss_concat_raw(api_docs, "## Compact strings\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_intern_raw_len") == 0) {
+            ss_concat_raw(api_docs, "## String interning\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_rope_new") == 0) {
+            ss_concat_raw(api_docs, "## Ropes\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_view_from_raw_len") == 0) {
+            ss_concat_raw(api_docs, "## String views\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_packed_new") == 0) {
+            ss_concat_raw(api_docs, "## Packed lists\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_list_new") == 0) {
+            ss_concat_raw(api_docs, "## String lists\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_searcher_new_raw_len") == 0) {
+            ss_concat_raw(api_docs, "## Searchers\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_matcher_new") == 0) {
+            ss_concat_raw(api_docs, "## Multi-pattern search\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_set_allocator") == 0) {
+            ss_concat_raw(api_docs, "## Memory allocation\n\n");
+        }
+        if (strcmp(doc.func_name->buf, "ss_stats_get") == 0) {
+            ss_concat_raw(api_docs, "## Statistics\n\n");
+        }
         if (strcmp(doc.func_name->buf, "ss_err_str") == 0) {
             ss_concat_raw(api_docs, "## Error handling\n\n");
         }
@@ -0,0 +1,8 @@
+#ifndef SS_INTERN_H
+#define SS_INTERN_H
+
+#include "string.h"
+
+void ss_set_interned(ss s, int interned);
+
+#endif
@@ -0,0 +1,616 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include "search.h"
+#include "simd.h"
+
+// Bytes verified by the filters, beyond the bytes scanned, before falling
+// back to the Two-Way algorithm.
+#define VERIFY_BUDGET 256
+
+static size_t filter_memchr(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume);
+static int over_budget(size_t verified, size_t scanned, size_t needle_len);
+static size_t filter_last_memrchr(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume);
+static size_t two_way(const unsigned char *y, size_t len, const unsigned char *x, size_t m, int backward);
+static void factorize(const unsigned char *x, size_t m, int backward, size_t *ell, size_t *period, int *periodic);
+static size_t two_way_factorized(const unsigned char *y, size_t len, const unsigned char *x, size_t m,
+                                 size_t ell, size_t period, int periodic, int backward);
+static int byte_rank(unsigned char c);
+static size_t horspool(const ss_needle *needle, const char *s, size_t len, size_t *resume);
+static size_t max_suffix(const unsigned char *x, size_t m, size_t *period, int inverted, int backward);
+static size_t last_byte(const char *s, size_t len, char c);
+#ifdef SS_SIMD_X86
+static size_t filter_sse2(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume);
+static size_t filter_avx2(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume);
+static size_t filter_last_sse2(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume);
+static size_t filter_last_avx2(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume);
+static size_t filter_rare_sse2(const ss_needle *needle, const char *s, size_t len, size_t *resume);
+static size_t filter_rare_avx2(const ss_needle *needle, const char *s, size_t len, size_t *resume);
+#endif
+
+/*
+ * Returns the position of the first occurrence of the `needle_len` bytes
+ * of `needle` in the `len` bytes of `s`, or -1 if there is none. An empty
+ * needle matches at position zero.
+ */
+size_t ss_search(const char *s, size_t len, const char *needle, size_t needle_len) {
+    if (needle_len == 0) return 0;
+    if (needle_len > len) return -1;
+    if (needle_len == 1) {
+        const char *p = memchr(s, needle[0], len);
+        return p != NULL ? (size_t)(p - s) : (size_t)-1;
+    }
+
+    size_t resume;
+    size_t pos;
+#ifdef SS_SIMD_X86
+    if (ss_cpu_has_avx2()) pos = filter_avx2(s, len, needle, needle_len, &resume);
+    else pos = filter_sse2(s, len, needle, needle_len, &resume);
+#else
+    pos = filter_memchr(s, len, needle, needle_len, &resume);
+#endif
+    if (pos != (size_t)-1 || resume == len) return pos;
+
+    pos = ss_search_two_way(s + resume, len - resume, needle, needle_len);
+    return pos != (size_t)-1 ? resume + pos : pos;
+}
+
+/*
+ * Returns the position of the first occurrence of `needle` in `s` like
+ * ss_search, using only the Two-Way algorithm (Crochemore and Perrin).
+ * The needle is split at a critical factorization in a left and a right
+ * part: the right part is matched left to right and then the left part
+ * right to left, shifting by the period of the needle (or more) on a
+ * mismatch. It takes O(len + needle_len) time and constant space.
+ */
+size_t ss_search_two_way(const char *s, size_t len, const char *needle, size_t needle_len) {
+    if (needle_len == 0) return 0;
+    if (needle_len > len) return -1;
+    return two_way((const unsigned char *)s, len, (const unsigned char *)needle, needle_len, 0);
+}
+
+/*
+ * Returns the position of the last occurrence of the `needle_len` bytes
+ * of `needle` in the `len` bytes of `s`, or -1 if there is none. The
+ * buffer is scanned backward from its end, with the same filters of
+ * ss_search run on blocks taken from the end (memrchr for single bytes)
+ * and the Two-Way algorithm run on the reversed buffer and needle as
+ * fallback, so it takes linear time. An empty needle matches at `len`.
+ */
+size_t ss_search_last(const char *s, size_t len, const char *needle, size_t needle_len) {
+    if (needle_len == 0) return len;
+    if (needle_len > len) return -1;
+    if (needle_len == 1) return last_byte(s, len, needle[0]);
+
+    size_t resume;
+    size_t pos;
+#ifdef SS_SIMD_X86
+    if (ss_cpu_has_avx2()) pos = filter_last_avx2(s, len, needle, needle_len, &resume);
+    else pos = filter_last_sse2(s, len, needle, needle_len, &resume);
+#else
+    pos = filter_last_memrchr(s, len, needle, needle_len, &resume);
+#endif
+    if (pos != (size_t)-1 || resume < needle_len) return pos;
+    return ss_search_last_two_way(s, resume, needle, needle_len);
+}
+
+/*
+ * Returns the position of the last occurrence of `needle` in `s` like
+ * ss_search_last, using only the Two-Way algorithm on the reversed buffer
+ * and needle. It takes O(len + needle_len) time and constant space.
+ */
+size_t ss_search_last_two_way(const char *s, size_t len, const char *needle, size_t needle_len) {
+    if (needle_len == 0) return len;
+    if (needle_len > len) return -1;
+    size_t pos = two_way((const unsigned char *)s, len, (const unsigned char *)needle, needle_len, 1);
+    return pos != (size_t)-1 ? len - needle_len - pos : pos;
+}
+
+/*
+ * Prepare the `len` bytes of `ptr` to be searched with ss_needle_search,
+ * computing all the tables that ss_search derives at each call.
+ */
+void ss_needle_init(ss_needle *needle, const char *ptr, size_t len) {
+    const unsigned char *x = (const unsigned char *)ptr;
+    needle->ptr = ptr;
+    needle->len = len;
+    needle->rare1 = 0;
+    needle->rare2 = len > 1 ? len - 1 : 0;
+    needle->ell = 0;
+    needle->period = 1;
+    needle->periodic = 0;
+
+    // Horspool shift: distance of the last occurrence of each byte in the
+    // needle (its last byte excluded) from the end of the needle.
+    for (int c = 0; c < 256; c++) needle->shift[c] = len;
+    for (size_t i = 0; i + 1 < len; i++) needle->shift[x[i]] = len - 1 - i;
+
+    // The rarest byte, then the rarest one at another offset, preferring
+    // a different value so that the two compares filter more.
+    for (size_t i = 1; i < len; i++) {
+        if (byte_rank(x[i]) < byte_rank(x[needle->rare1])) needle->rare1 = i;
+    }
+    int found = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (i == needle->rare1) continue;
+        int rank = byte_rank(x[i]) + (x[i] == x[needle->rare1] ? 256 : 0);
+        int best = byte_rank(x[needle->rare2]) + (x[needle->rare2] == x[needle->rare1] ? 256 : 0);
+        if (!found || rank < best) needle->rare2 = i;
+        found = 1;
+    }
+    memset(needle->vec1, len > 0 ? x[needle->rare1] : 0, sizeof(needle->vec1));
+    memset(needle->vec2, len > 0 ? x[needle->rare2] : 0, sizeof(needle->vec2));
+
+    if (len > 0) factorize(x, len, 0, &needle->ell, &needle->period, &needle->periodic);
+}
+
+/*
+ * Returns the position of the first occurrence of the needle `needle` in
+ * the `len` bytes of `s`, or -1 if there is none, like ss_search. The
+ * candidates are found comparing blocks of the buffer with the two rarest
+ * bytes of the needle (SIMD when available) or with the Horspool scan,
+ * which skips up to the needle length for each compare. Both fall back to
+ * the Two-Way algorithm when they verify too many candidates.
+ */
+size_t ss_needle_search(const ss_needle *needle, const char *s, size_t len) {
+    size_t m = needle->len;
+    if (m == 0) return 0;
+    if (m > len) return -1;
+    if (m == 1) {
+        const char *p = memchr(s, needle->ptr[0], len);
+        return p != NULL ? (size_t)(p - s) : (size_t)-1;
+    }
+
+    size_t resume;
+    size_t pos;
+#ifdef SS_SIMD_X86
+    if (ss_cpu_has_avx2()) pos = filter_rare_avx2(needle, s, len, &resume);
+    else pos = filter_rare_sse2(needle, s, len, &resume);
+#else
+    pos = horspool(needle, s, len, &resume);
+#endif
+    if (pos != (size_t)-1 || resume == len || len - resume < m) return pos;
+
+    pos = two_way_factorized((const unsigned char *)s + resume, len - resume, (const unsigned char *)needle->ptr, m,
+                             needle->ell, needle->period, needle->periodic, 0);
+    return pos != (size_t)-1 ? resume + pos : pos;
+}
+
+// Returns the byte `i` of the `n` bytes of `p`, counting from the end if
+// `backward` is not zero, so that the same code searches the reversed
+// buffer without copying it.
+static inline unsigned char at(const unsigned char *p, size_t n, size_t i, int backward) {
+    return backward ? p[n - 1 - i] : p[i];
+}
+
+// Two-Way search of the `m` bytes of `x` in the `len` bytes of `y`, or of
+// the reversed needle in the reversed buffer if `backward` is not zero.
+// Returns the position of the match in the (reversed) buffer, or -1.
+static size_t two_way(const unsigned char *y, size_t len, const unsigned char *x, size_t m, int backward) {
+    size_t ell, period;
+    int periodic;
+    factorize(x, m, backward, &ell, &period, &periodic);
+    return two_way_factorized(y, len, x, m, ell, period, periodic, backward);
+}
+
+// Compute the critical factorization of the `m` bytes of `x` (reversed if
+// `backward` is not zero): the critical position `ell` is the start of the
+// right part (the longer of the two maximal suffixes), `period` the period
+// of the needle if the left part repeats in the right one (`periodic`).
+static void factorize(const unsigned char *x, size_t m, int backward, size_t *ell, size_t *period, int *periodic) {
+    size_t p, q;
+    size_t i = max_suffix(x, m, &p, 0, backward);
+    size_t j = max_suffix(x, m, &q, 1, backward);
+    *ell = i >= j ? i : j;
+    *period = i >= j ? p : q;
+
+    *periodic = *ell + *period <= m;
+    for (size_t k = 0; *periodic && k < *ell; k++) {
+        *periodic = at(x, m, k, backward) == at(x, m, k + *period, backward);
+    }
+}
+
+// Two-Way search of `x` in `y` like two_way, with the factorization of
+// the needle already computed by factorize.
+static size_t two_way_factorized(const unsigned char *y, size_t len, const unsigned char *x, size_t m,
+                                 size_t ell, size_t period, int periodic, int backward) {
+    if (periodic) {
+        // Periodic needle: after a partial match of the right part, the
+        // prefix of length `memory` is known to match and is skipped.
+        size_t memory = 0;
+        for (size_t pos = 0; pos <= len - m;) {
+            size_t k = ell > memory ? ell : memory;
+            while (k < m && at(x, m, k, backward) == at(y, len, pos + k, backward)) k++;
+            if (k < m) {
+                pos += k - ell + 1;
+                memory = 0;
+                continue;
+            }
+            k = ell;
+            while (k > memory && at(x, m, k - 1, backward) == at(y, len, pos + k - 1, backward)) k--;
+            if (k <= memory) return pos;
+            pos += period;
+            memory = m - period;
+        }
+    } else {
+        // Non periodic needle: the shift after a full match of the right
+        // part is larger than both parts.
+        size_t shift = (ell > m - ell ? ell : m - ell) + 1;
+        for (size_t pos = 0; pos <= len - m;) {
+            size_t k = ell;
+            while (k < m && at(x, m, k, backward) == at(y, len, pos + k, backward)) k++;
+            if (k < m) {
+                pos += k - ell + 1;
+                continue;
+            }
+            k = ell;
+            while (k > 0 && at(x, m, k - 1, backward) == at(y, len, pos + k - 1, backward)) k--;
+            if (k == 0) return pos;
+            pos += shift;
+        }
+    }
+    return -1;
+}
+
+// Compute the maximal suffix of the `m` bytes of `x` (reversed if
+// `backward` is not zero) for the byte order, or the inverted order if
+// `inverted` is not zero. Returns the start of the suffix and sets
+// `period` to its period.
+static size_t max_suffix(const unsigned char *x, size_t m, size_t *period, int inverted, int backward) {
+    size_t start = 0;
+    size_t j = 1;
+    size_t k = 0;
+    *period = 1;
+
+    while (j + k < m) {
+        unsigned char a = at(x, m, j + k, backward);
+        unsigned char b = at(x, m, start + k, backward);
+        if (a == b) {
+            if (k + 1 == *period) {
+                j += *period;
+                k = 0;
+            } else {
+                k++;
+            }
+        } else if ((a < b) != (inverted != 0)) {
+            j += k + 1;
+            k = 0;
+            *period = j - start;
+        } else {
+            start = j;
+            j = start + 1;
+            k = 0;
+            *period = 1;
+        }
+    }
+    return start;
+}
+
+// Returns the position of the last occurrence of the byte `c` in the
+// `len` bytes of `s`, or -1.
+static size_t last_byte(const char *s, size_t len, char c) {
+#ifdef __GLIBC__
+    const char *p = memrchr(s, c, len);
+    return p != NULL ? (size_t)(p - s) : (size_t)-1;
+#else
+    while (len-- > 0) {
+        if (s[len] == c) return len;
+    }
+    return -1;
+#endif
+}
+
+// Returns 1 if the filters verified too many bytes for the `scanned`
+// bytes of the buffer, so that the search must switch to Two-Way.
+static int over_budget(size_t verified, size_t scanned, size_t needle_len) {
+    return verified > 2 * scanned + 4 * needle_len + VERIFY_BUDGET;
+}
+
+// Portable filter: candidates are found with memchr on the first byte of
+// the needle, then checked on the last byte and verified with memcmp.
+// Returns the position of the match, or -1 setting `resume` to the
+// position where the search must go on with Two-Way (`len` if the whole
+// buffer was scanned).
+static size_t filter_memchr(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume) {
+    const char *end = s + len - needle_len + 1;
+    const char *p = s;
+    size_t verified = 0;
+
+    while (p < end) {
+        p = memchr(p, needle[0], end - p);
+        if (p == NULL) break;
+        if (p[needle_len - 1] == needle[needle_len - 1]) {
+            if (memcmp(p + 1, needle + 1, needle_len - 2) == 0) return p - s;
+            verified += needle_len;
+            if (over_budget(verified, p - s, needle_len)) {
+                *resume = p - s + 1;
+                return -1;
+            }
+        }
+        p++;
+    }
+    *resume = len;
+    return -1;
+}
+
+// Estimate of how common the byte `c` is in text and source code, the
+// lower the rarer. Only the order matters, to choose the bytes compared
+// by the filter.
+static int byte_rank(unsigned char c) {
+    static const char letters[] = "zqxjkvbpygfwmucldrhsnioate";
+    if (c == ' ') return 255;
+    if (c == '\n') return 220;
+    if (c >= 'a' && c <= 'z') return 190 + (int)(strchr(letters, c) - letters);
+    if (c >= 'A' && c <= 'Z') return 150 + (int)(strchr(letters, c - 'A' + 'a') - letters);
+    if (c >= '0' && c <= '9') return 140;
+    if (c != '\0' && strchr(",.;:-_()/'\"=\t", c) != NULL) return 130;
+    if (c == '\0') return 100;
+    if (c < 128) return 60;
+    return 40;
+}
+
+// Portable filter of a prepared needle: the Boyer-Moore-Horspool scan
+// compares the byte of the buffer aligned with the end of the needle, and
+// on a match the rarest byte before the whole needle, then it shifts by
+// the distance of that byte from the end of the needle. Returns the
+// position of the match, or -1 setting `resume` like filter_memchr.
+static size_t horspool(const ss_needle *needle, const char *s, size_t len, size_t *resume) {
+    const unsigned char *y = (const unsigned char *)s;
+    const unsigned char *x = (const unsigned char *)needle->ptr;
+    size_t m = needle->len;
+    size_t rare = needle->rare1;
+    size_t verified = 0;
+
+    for (size_t i = 0; i + m <= len;) {
+        unsigned char c = y[i + m - 1];
+        if (c == x[m - 1] && y[i + rare] == x[rare]) {
+            if (memcmp(y + i, x, m - 1) == 0) return i;
+            verified += m;
+            if (over_budget(verified, i, m)) {
+                *resume = i + 1;
+                return -1;
+            }
+        }
+        i += needle->shift[c];
+    }
+    *resume = len;
+    return -1;
+}
+
+// Portable backward filter: candidates are found with memrchr on the
+// first byte of the needle, from the last possible position down, then
+// checked like in filter_memchr. Returns the position of the match, or -1
+// setting `resume` to the length of the prefix of `s` still to search
+// with Two-Way (less than `needle_len` if the whole buffer was scanned).
+static size_t filter_last_memrchr(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume) {
+    size_t end = len - needle_len + 1;
+    size_t verified = 0;
+
+    while (end > 0) {
+        size_t pos = last_byte(s, end, needle[0]);
+        if (pos == (size_t)-1) break;
+        if (s[pos + needle_len - 1] == needle[needle_len - 1]) {
+            if (memcmp(s + pos + 1, needle + 1, needle_len - 2) == 0) return pos;
+            verified += needle_len;
+            if (over_budget(verified, len - pos, needle_len)) {
+                *resume = pos + needle_len - 1;
+                return -1;
+            }
+        }
+        end = pos;
+    }
+    *resume = 0;
+    return -1;
+}
+
+#ifdef SS_SIMD_X86
+
+// Find the candidates 16 at a time, comparing a block of the buffer with
+// the first byte of the needle and the block `needle_len - 1` bytes ahead
+// with the last one, then verify each candidate with memcmp. The last
+// positions, which don't fill a block, are left to filter_memchr.
+static size_t filter_sse2(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume) {
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    size_t verified = 0;
+
+    size_t i = 0;
+    for (; i + needle_len - 1 + 16 <= len; i += 16) {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(s + i + needle_len - 1));
+        __m128i hits = _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hits);
+        while (mask != 0) {
+            size_t pos = i + __builtin_ctz(mask);
+            if (memcmp(s + pos + 1, needle + 1, needle_len - 2) == 0) return pos;
+            verified += needle_len;
+            if (over_budget(verified, pos, needle_len)) {
+                *resume = pos + 1;
+                return -1;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    size_t pos = filter_memchr(s + i, len - i, needle, needle_len, resume);
+    *resume += i;
+    return pos != (size_t)-1 ? i + pos : pos;
+}
+
+// Same as filter_sse2 with blocks of 32 bytes, compiled for AVX2 and
+// called only if the CPU supports it. Two blocks are checked for each
+// iteration, since candidates are rare on most inputs.
+__attribute__((target("avx2")))
+static size_t filter_avx2(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume) {
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    size_t verified = 0;
+
+    size_t i = 0;
+    for (; i + needle_len - 1 + 64 <= len; i += 64) {
+        const char *p = s + i;
+        const char *q = s + i + needle_len - 1;
+        __m256i hits_lo = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), first),
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)q), last));
+        __m256i hits_hi = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 32)), first),
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(q + 32)), last));
+        if (_mm256_testz_si256(_mm256_or_si256(hits_lo, hits_hi), _mm256_or_si256(hits_lo, hits_hi))) continue;
+
+        unsigned long long mask = (unsigned)_mm256_movemask_epi8(hits_lo)
+            | (unsigned long long)(unsigned)_mm256_movemask_epi8(hits_hi) << 32;
+        while (mask != 0) {
+            size_t pos = i + __builtin_ctzll(mask);
+            if (memcmp(s + pos + 1, needle + 1, needle_len - 2) == 0) return pos;
+            verified += needle_len;
+            if (over_budget(verified, pos, needle_len)) {
+                *resume = pos + 1;
+                return -1;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    size_t pos = filter_sse2(s + i, len - i, needle, needle_len, resume);
+    *resume += i;
+    return pos != (size_t)-1 ? i + pos : pos;
+}
+
+// Backward version of filter_sse2: the blocks are taken from the end of
+// the buffer and the candidates of each block are verified from the last
+// one. The first positions, which don't fill a block, are left to
+// filter_last_memrchr.
+static size_t filter_last_sse2(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume) {
+    __m128i first = _mm_set1_epi8(needle[0]);
+    __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    size_t verified = 0;
+
+    size_t end = len - needle_len + 1;
+    for (; end >= 16; end -= 16) {
+        size_t i = end - 16;
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(s + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(s + i + needle_len - 1));
+        __m128i hits = _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hits);
+        while (mask != 0) {
+            int bit = 31 - __builtin_clz(mask);
+            size_t pos = i + bit;
+            if (memcmp(s + pos + 1, needle + 1, needle_len - 2) == 0) return pos;
+            verified += needle_len;
+            if (over_budget(verified, len - pos, needle_len)) {
+                *resume = pos + needle_len - 1;
+                return -1;
+            }
+            mask &= ~(1u << bit);
+        }
+    }
+
+    return filter_last_memrchr(s, end + needle_len - 1, needle, needle_len, resume);
+}
+
+// Same as filter_last_sse2 with blocks of 32 bytes, compiled for AVX2 and
+// called only if the CPU supports it.
+__attribute__((target("avx2")))
+static size_t filter_last_avx2(const char *s, size_t len, const char *needle, size_t needle_len, size_t *resume) {
+    __m256i first = _mm256_set1_epi8(needle[0]);
+    __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    size_t verified = 0;
+
+    size_t end = len - needle_len + 1;
+    for (; end >= 32; end -= 32) {
+        size_t i = end - 32;
+        __m256i block_first = _mm256_loadu_si256((const __m256i *)(s + i));
+        __m256i block_last = _mm256_loadu_si256((const __m256i *)(s + i + needle_len - 1));
+        __m256i hits = _mm256_and_si256(_mm256_cmpeq_epi8(block_first, first), _mm256_cmpeq_epi8(block_last, last));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(hits);
+        while (mask != 0) {
+            int bit = 31 - __builtin_clz(mask);
+            size_t pos = i + bit;
+            if (memcmp(s + pos + 1, needle + 1, needle_len - 2) == 0) return pos;
+            verified += needle_len;
+            if (over_budget(verified, len - pos, needle_len)) {
+                *resume = pos + needle_len - 1;
+                return -1;
+            }
+            mask &= ~(1u << bit);
+        }
+    }
+
+    return filter_last_sse2(s, end + needle_len - 1, needle, needle_len, resume);
+}
+
+// Filter of a prepared needle: like filter_sse2, comparing the blocks at
+// the offsets of the two rarest bytes of the needle with their precomputed
+// vectors, so that fewer candidates reach the verification. The last
+// positions, which don't fill a block, are left to horspool.
+static size_t filter_rare_sse2(const ss_needle *needle, const char *s, size_t len, size_t *resume) {
+    __m128i rare1 = _mm_loadu_si128((const __m128i *)needle->vec1);
+    __m128i rare2 = _mm_loadu_si128((const __m128i *)needle->vec2);
+    size_t m = needle->len;
+    size_t verified = 0;
+
+    size_t i = 0;
+    for (; i + m - 1 + 16 <= len; i += 16) {
+        __m128i block1 = _mm_loadu_si128((const __m128i *)(s + i + needle->rare1));
+        __m128i block2 = _mm_loadu_si128((const __m128i *)(s + i + needle->rare2));
+        __m128i hits = _mm_and_si128(_mm_cmpeq_epi8(block1, rare1), _mm_cmpeq_epi8(block2, rare2));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hits);
+        while (mask != 0) {
+            size_t pos = i + __builtin_ctz(mask);
+            if (memcmp(s + pos, needle->ptr, m) == 0) return pos;
+            verified += m;
+            if (over_budget(verified, pos, m)) {
+                *resume = pos + 1;
+                return -1;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    size_t pos = horspool(needle, s + i, len - i, resume);
+    *resume += i;
+    return pos != (size_t)-1 ? i + pos : pos;
+}
+
+// Same as filter_rare_sse2 with blocks of 32 bytes, compiled for AVX2 and
+// called only if the CPU supports it. Two blocks are checked for each
+// iteration, as in filter_avx2.
+__attribute__((target("avx2")))
+static size_t filter_rare_avx2(const ss_needle *needle, const char *s, size_t len, size_t *resume) {
+    __m256i rare1 = _mm256_loadu_si256((const __m256i *)needle->vec1);
+    __m256i rare2 = _mm256_loadu_si256((const __m256i *)needle->vec2);
+    size_t m = needle->len;
+    size_t verified = 0;
+
+    size_t i = 0;
+    for (; i + m - 1 + 64 <= len; i += 64) {
+        const char *p = s + i + needle->rare1;
+        const char *q = s + i + needle->rare2;
+        __m256i hits_lo = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), rare1),
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)q), rare2));
+        __m256i hits_hi = _mm256_and_si256(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 32)), rare1),
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(q + 32)), rare2));
+        if (_mm256_testz_si256(_mm256_or_si256(hits_lo, hits_hi), _mm256_or_si256(hits_lo, hits_hi))) continue;
+
+        unsigned long long mask = (unsigned)_mm256_movemask_epi8(hits_lo)
+            | (unsigned long long)(unsigned)_mm256_movemask_epi8(hits_hi) << 32;
+        while (mask != 0) {
+            size_t pos = i + __builtin_ctzll(mask);
+            if (memcmp(s + pos, needle->ptr, m) == 0) return pos;
+            verified += m;
+            if (over_budget(verified, pos, m)) {
+                *resume = pos + 1;
+                return -1;
+            }
+            mask &= mask - 1;
+        }
+    }
+
+    size_t pos = filter_rare_sse2(needle, s + i, len - i, resume);
+    *resume += i;
+    return pos != (size_t)-1 ? i + pos : pos;
+}
+
+#endif
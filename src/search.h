@@ -0,0 +1,47 @@
+#ifndef SS_SEARCH_H
+#define SS_SEARCH_H
+
+#include <stddef.h>
+
+/*
+ * Substring search on buffers of known length, used by the index and split
+ * functions. The search doesn't stop at null bytes and it never reads past
+ * the end of the buffers. Candidates are found with a filter on the first
+ * and the last byte of the needle (SIMD when available, see simd.h, memchr
+ * otherwise) and then verified. If the verifications take more than a
+ * linear budget, e.g. on periodic inputs, the search goes on with the
+ * Two-Way algorithm, which runs in linear time on any input. The backward
+ * searches run the same filters and Two-Way from the end of the buffer.
+ */
+
+size_t ss_search(const char *s, size_t len, const char *needle, size_t needle_len);
+size_t ss_search_two_way(const char *s, size_t len, const char *needle, size_t needle_len);
+size_t ss_search_last(const char *s, size_t len, const char *needle, size_t needle_len);
+size_t ss_search_last_two_way(const char *s, size_t len, const char *needle, size_t needle_len);
+
+/*
+ * A needle prepared once to be searched in many buffers (see ss_searcher).
+ * Besides the needle, it keeps the Boyer-Moore-Horspool shift of each byte
+ * for the portable scan, the offsets of the two rarest bytes of the needle
+ * (by a static estimate of their frequency in text), which the SIMD filter
+ * compares instead of the first and the last byte, the same bytes repeated
+ * over a whole vector and the critical factorization of the Two-Way
+ * fallback. The needle bytes aren't copied, they must outlive the struct.
+ */
+typedef struct ss_needle {
+    const char *ptr;
+    size_t len;
+    size_t shift[256];
+    size_t rare1;
+    size_t rare2;
+    unsigned char vec1[32];
+    unsigned char vec2[32];
+    size_t ell;
+    size_t period;
+    int periodic;
+} ss_needle;
+
+void ss_needle_init(ss_needle *needle, const char *ptr, size_t len);
+size_t ss_needle_search(const ss_needle *needle, const char *s, size_t len);
+
+#endif
@@ -0,0 +1,16 @@
+#include "simd.h"
+
+#ifdef SS_SIMD_X86
+
+// 1 if the CPU running the program supports AVX2, 0 otherwise. It stays
+// zero, selecting the SSE2 kernels, if the library is used by another
+// constructor before the detection runs.
+int ss_avx2 = 0;
+
+__attribute__((constructor))
+static void detect_cpu(void) {
+    __builtin_cpu_init();
+    ss_avx2 = __builtin_cpu_supports("avx2") != 0;
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef SS_SIMD_H
+#define SS_SIMD_H
+
+#include "options.h"
+
+/*
+ * The SIMD kernels of the library (byte sets and substring search) are
+ * compiled only for x86 with GCC or Clang, where SSE2 is the baseline.
+ * The AVX2 kernels are compiled with a target attribute and called only if
+ * ss_cpu_has_avx2 reports that the running CPU supports them. The CPU is
+ * detected once when the program is loaded, so that the check is a plain
+ * load in the search loops. When
+ * SS_NO_SIMD is defined (through the CMake options at compile time) only
+ * the portable kernels are compiled.
+ */
+
+#if !defined(SS_NO_SIMD) && defined(__GNUC__) && defined(__SSE2__)
+#define SS_SIMD_X86
+#include <immintrin.h>
+
+extern int ss_avx2;
+
+static inline int ss_cpu_has_avx2(void) {
+    return ss_avx2;
+}
+#endif
+
+#endif
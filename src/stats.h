@@ -0,0 +1,36 @@
+#ifndef SS_STATS_H
+#define SS_STATS_H
+
+#include "options.h"
+#include "string_stats.h"
+
+/*
+ * Internal counters of the library, one for each field of the `ss_stats` struct.
+ * When SS_STATS is not defined (through the CMake options at compile time), the
+ * SS_STAT_ADD macro expands to nothing and the counters are compiled out.
+ */
+
+typedef enum ss_stat {
+    stat_n_malloc = 0,
+    stat_malloc_bytes,
+    stat_n_realloc,
+    stat_realloc_bytes,
+    stat_n_concat_realloc,
+    stat_n_prepend_realloc,
+    stat_memmove_bytes,
+    stat_n_live,
+    stat_count,
+} ss_stat;
+
+#ifdef SS_STATS
+
+void ss_stat_add(ss_stat stat, long long n);
+#define SS_STAT_ADD(stat, n) ss_stat_add((stat), (long long)(n))
+
+#else
+
+#define SS_STAT_ADD(stat, n) ((void)0)
+
+#endif
+
+#endif
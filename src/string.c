@@ -1,8 +1,79 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
 #include "string.h"
 #include "alloc.h"
+#include "stats.h"
+#include "intern.h"
+#include "search.h"
+#include "options.h"
+
+// The string buffer is stored in the same allocation of the string
+// struct, right after it. The buffer can't be resized in place, since
+// that would move the struct itself and invalidate the ss pointer held
+// by the caller, so growing it means moving it to a separate buffer.
+#define SS_FLAG_EMBEDDED 1u
+// The string buffer is the inline array of the string struct. Small
+// strings are stored there, avoiding the allocation of the buffer.
+#define SS_FLAG_INLINE 2u
+// The string buffer is provided by the caller (e.g. a stack array)
+// and it's never freed by the library.
+#define SS_FLAG_EXTERNAL_BUF 8u
+// Buffers that can't be reallocated nor freed on their own.
+#define SS_FLAG_INTERNAL_BUF (SS_FLAG_EMBEDDED | SS_FLAG_INLINE | SS_FLAG_EXTERNAL_BUF)
+// The string buffer is an anonymous memory mapping, used for big
+// strings. It grows with mremap, avoiding copies of the content.
+#define SS_FLAG_MAPPED 4u
+// The string struct is provided by the caller and it's not freed.
+#define SS_FLAG_EXTERNAL_STRUCT 16u
+// The string buffer is shared with other strings (see ss_clone_shared)
+// and it's immutable: the string detaches, copying the content to its
+// own buffer, before any modification.
+#define SS_FLAG_SHARED 32u
+
+// The string is owned by the intern table (see ss_intern_raw_len). It
+// can't be modified and ss_free is a no-op on it.
+#define SS_FLAG_INTERNED 64u
+// Prepends grow the front space of the string (see
+// ss_reserve_front_space) instead of moving the content.
+#define SS_FLAG_FRONT 128u
+// Slices and left trims move the start of the string forward instead of
+// moving the content (see ss_set_offset_mode).
+#define SS_FLAG_OFFSET 256u
+
+// Reference counted block holding a shared string buffer.
+typedef struct shared_buf {
+    atomic_size_t refs;
+    char data[];
+} shared_buf;
+
+static const ss_growth default_growth = {
+    .kind = growth_geometric,
+    .factor = 2,
+    .limit = 0
+};
+
+static const ss_growth *global_growth = &default_growth;
+
+static size_t compact_threshold = 4096;
+
+static ss_err resize_buf(ss s, size_t avail);
+static ss_err share_buf(ss s);
+static void release_shared_buf(ss s);
+static void release_buf(ss s);
+static ss_err move_buf(ss s, size_t head, size_t avail);
+static ss_err detach(ss s);
+static ss_err ensure_front(ss s, size_t avail);
+static ss_err ensure_free(ss s, size_t avail);
+static void compact(ss s);
+static void cut_front(ss s, size_t start, size_t len);
+static size_t front_space(ss s);
+static const ss_growth *string_growth(ss s);
+static ss_err set_growth(ss s, const ss_growth *growth);
+static size_t growth_capacity(const ss_growth *growth, size_t len);
 
 /*
  * Build a new string copying the provided `init` C string of length `len` (the length argument doesn't
@@ -16,31 +87,104 @@
  *
  * The returned string has length `len`, but additional `avail` bytes are allocated. This overallocation
  * is often useful because it's reduces the probability of future reallocations when the string is
- * manipulated.
+ * manipulated. Small strings, whose `len` + `avail` + 1 bytes fit in `SS_INLINE_CAP` bytes, are stored
+ * inline in the string struct and don't need a separate buffer. If the library is compiled with the
+ * single allocation option, the string struct and the buffer of bigger strings share one allocation.
+ * In both cases the buffer is moved to a separate allocation only when the string needs more space
+ * than the one available.
  *
  * Returns the newly generated string or NULL if the allocation fails.
  */
 ss ss_new_from_raw_len_free(const char *init, size_t len, size_t avail) {
-    if (init == NULL) return ss_new_empty();
+    return ss_new_from_raw_len_free_alloc(NULL, init, len, avail);
+}
 
-    char *buf = ss_malloc(sizeof(char) * (len + avail + 1));
-    if (buf == NULL) {
-        return NULL;
+/*
+ * Build a new string exactly like `ss_new_from_raw_len_free`, but allocating its memory with the
+ * provided `alloc` allocator instead of the one set with `ss_set_allocator`. The string remembers
+ * its allocator: all the future reallocations of the string buffer and the final `ss_free` go
+ * through it, as well as the strings cloned from it. If `alloc` is NULL the allocator currently
+ * set with `ss_set_allocator` is used.
+ *
+ * Returns the newly generated string or NULL if the allocation fails.
+ */
+ss ss_new_from_raw_len_free_alloc(const ss_allocator *alloc, const char *init, size_t len, size_t avail) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    if (init == NULL) {
+        init = "";
+        len = 0;
+        avail = 0;
     }
 
+    ss s;
+    char *buf;
+    unsigned int flags;
+
+    if (len + avail + 1 <= SS_INLINE_CAP) {
+        // Small strings fit in the inline array,
+        // only the struct must be allocated.
+        s = ss_malloc(alloc, sizeof(struct ss));
+        if (s == NULL) {
+            return NULL;
+        }
+        buf = s->inl;
+        flags = SS_FLAG_INLINE;
+    } else if (ss_map_eligible(alloc, len + avail + 1)) {
+        // Big strings live in a memory mapping.
+        s = ss_malloc(alloc, sizeof(struct ss));
+        if (s == NULL) {
+            return NULL;
+        }
+
+        buf = ss_map(len + avail + 1);
+        if (buf == NULL) {
+            ss_dealloc(alloc, s);
+            return NULL;
+        }
+        flags = SS_FLAG_MAPPED;
+    } else {
+#ifdef SS_SINGLE_ALLOC
+        // One allocation for both the struct and the buffer,
+        // the buffer starts right after the struct.
+        s = ss_malloc(alloc, sizeof(struct ss) + sizeof(char) * (len + avail + 1));
+        if (s == NULL) {
+            return NULL;
+        }
+        buf = (char *)(s + 1);
+        flags = SS_FLAG_EMBEDDED;
+#else
+        // The buffer is allocated last, so that allocators
+        // growing their most recent block in place (like
+        // arenas) can also grow the buffer in place.
+        s = ss_malloc(alloc, sizeof(struct ss));
+        if (s == NULL) {
+            return NULL;
+        }
+
+        buf = ss_malloc(alloc, sizeof(char) * (len + avail + 1));
+        if (buf == NULL) {
+            ss_dealloc(alloc, s);
+            return NULL;
+        }
+        flags = 0;
+#endif
+    }
+
+    // Fields are set one by one, assigning a compound literal would
+    // wipe out the inline buffer, which overlaps the front space and
+    // the growth policy.
     memcpy(buf, init, len);
     buf[len] = END_STRING;
-
-    ss s = ss_malloc(sizeof(struct ss));
-    if (s == NULL) {
-        free(buf);
-        return NULL;
+    s->len = len;
+    s->free = avail;
+    s->buf = buf;
+    s->alloc = alloc;
+    s->flags = flags;
+    if (!(flags & SS_FLAG_INLINE)) {
+        s->head = 0;
+        s->growth = NULL;
     }
-    *s = (struct ss){
-        .len = len,
-        .free = avail,
-        .buf = buf
-    };
+    SS_STAT_ADD(stat_n_live, 1);
 
     return s;
 }
@@ -51,18 +195,24 @@ ss ss_new_from_raw_len_free(const char *init, size_t len, size_t avail) {
  * provided `len`, the exceeding bytes are discarded. The caller is responsible for providing
  * valid values for the arguments. If the `init` string is NULL a new empty ss string is returned.
  * The new ss string is heap allocated and a pointer to it is returned. The function is basically
- * a shorthand for `ss_new_raw_len_cap(init, len, len)`. The string must be freed after use with
- * the provided `ss_free` function.
+ * a shorthand for `ss_new_raw_len_cap(init, len, len)` with the default growth policy. The string
+ * must be freed after use with the provided `ss_free` function.
  *
- * The returned string has length `len`, but additional `len` bytes are allocated. This overallocation
+ * The returned string has length `len`, but additional bytes are allocated as dictated by the growth
+ * policy set with `ss_set_growth` (`len` additional bytes with the default policy). This overallocation
  * is often useful because it's reduces the probability of future reallocations when the string is
- * manipulated.
+ * manipulated. Strings up to `SS_INLINE_CAP` - 1 bytes long are always stored inline, with the space
+ * left in the inline array as free space, even if the growth policy asks for more.
  *
  * Returns the newly generated string or NULL if the allocation fails.
  */
 ss ss_new_from_raw_len(const char *init, size_t len) {
     if (init == NULL) return ss_new_empty();
-    return ss_new_from_raw_len_free(init, len, len);
+    size_t avail = growth_capacity(global_growth, len) - len;
+    // The policy space is only a hint: a string that fits the inline
+    // array takes the space left there instead of moving to the heap.
+    if (len + 1 <= SS_INLINE_CAP && len + avail + 1 > SS_INLINE_CAP) avail = SS_INLINE_CAP - len - 1;
+    return ss_new_from_raw_len_free(init, len, avail);
 }
 
 /*
@@ -71,7 +221,8 @@ ss ss_new_from_raw_len(const char *init, size_t len) {
  * NULL a new empty ss string is returned. The returned string must be freed after use with the
  * provided `ss_free` function.
  *
- * The returned string has length `strlen(init)`, but additional `strlen(init)` bytes are allocated.
+ * The returned string has length `strlen(init)`, but additional bytes are allocated as dictated by
+ * the growth policy set with `ss_set_growth` (`strlen(init)` additional bytes with the default policy).
  * This overallocation is often useful because it's reduces the probability of future reallocations
  * when the string is manipulated.
  *
@@ -79,8 +230,7 @@ ss ss_new_from_raw_len(const char *init, size_t len) {
  */
 ss ss_new_from_raw(const char *init) {
     if (init == NULL) return ss_new_empty();
-    size_t len = strlen(init);
-    return ss_new_from_raw_len_free(init, len, len);
+    return ss_new_from_raw_len(init, strlen(init));
 }
 
 /*
@@ -107,16 +257,167 @@ ss ss_new_empty(void) {
     return ss_new_from_raw_len("", 0);
 }
 
+/*
+ * Build a new empty string on memory provided by the caller, without any heap allocation: `hdr` is
+ * used as the string struct and `buf`, of `size` bytes, as the string buffer. Both are usually local
+ * variables, which makes the function useful for scratch strings (formatting a log line, building a
+ * key for a lookup) living only inside a function. The string has length zero and `size` - 1 bytes
+ * of free space. All the functions of the library work on the returned string: when an operation
+ * (a concat, a format or a `ss_grow` as an example) needs more space than `size` bytes, the content
+ * is moved to a heap buffer, allocated with the allocator set with `ss_set_allocator`. The string must
+ * still be released with `ss_free`, which frees only the heap buffer, if any, and never `hdr` or `buf`.
+ * Both `hdr` and `buf` must outlive the string. If `size` is zero or `buf` is NULL the function
+ * returns NULL.
+ *
+ * Returns the string built on `hdr`, that is `hdr` itself, or NULL if the arguments are not valid.
+ */
+ss ss_new_on_buf(struct ss *hdr, char *buf, size_t size) {
+    if (hdr == NULL || buf == NULL || size == 0) return NULL;
+
+    buf[0] = END_STRING;
+    hdr->len = 0;
+    hdr->free = size - 1;
+    hdr->buf = buf;
+    hdr->alloc = ss_get_allocator();
+    hdr->growth = NULL;
+    hdr->flags = SS_FLAG_EXTERNAL_BUF | SS_FLAG_EXTERNAL_STRUCT;
+    hdr->head = 0;
+    SS_STAT_ADD(stat_n_live, 1);
+
+    return hdr;
+}
+
 /*
  * Build and return a clone of the provided ss string `s`. The new string and the old one are
  * independent and both of them must be freed after use with the `ss_free` function. Cloning a
  * string is useful when, for example, we want to mutate a string while also retaining the
- * original content. The string `s` is not modified.
+ * original content. The clone is allocated with the same allocator of `s` and has its same growth
+ * policy. The string `s` is not modified.
  *
  * Returns the cloned string or NULL if the allocation fails.
  */
 ss ss_clone(ss s) {
-    return ss_new_from_raw_len_free(s->buf, s->len, s->free);
+    ss clone = ss_new_from_raw_len_free_alloc(s->alloc, s->buf, s->len, s->free);
+    if (clone == NULL) return NULL;
+    if (!(s->flags & SS_FLAG_INLINE) && set_growth(clone, s->growth) != err_none) {
+        ss_free(clone);
+        return NULL;
+    }
+    return clone;
+}
+
+/*
+ * Build and return a copy-on-write clone of the provided ss string `s`. Instead of copying the
+ * content, the clone shares the buffer of `s` through an atomic reference count, so cloning big
+ * strings is fast and the memory used grows with the number of distinct contents, not with the
+ * number of copies. Shared buffers are never modified: the first mutating call on one of the strings
+ * (concat, prepend, slice, trim, case conversion, grow, shrink, ...) gives it a private copy of the
+ * content first. The first shared clone of a string moves its content to a reference counted buffer,
+ * so the buffer of `s` may change, while the following clones only allocate the string struct. Small
+ * strings stored inline are cheap to copy and they are cloned with `ss_clone`. Both strings must be
+ * freed after use with `ss_free`, the shared buffer is released with the last string using it. The
+ * strings can be moved to different threads, but a single string must not be used by two threads at
+ * the same time. Mutating calls that can't report errors leave the string untouched if the private
+ * copy can't be allocated.
+ *
+ * Returns the cloned string or NULL if the allocation fails.
+ */
+ss ss_clone_shared(ss s) {
+    if (s->flags & (SS_FLAG_INLINE | SS_FLAG_INTERNED)) return ss_clone(s);
+
+    if (!(s->flags & SS_FLAG_SHARED)) {
+        ss_err err = share_buf(s);
+        if (err) {
+            return NULL;
+        }
+    }
+
+    ss clone = ss_malloc(s->alloc, sizeof(struct ss));
+    if (clone == NULL) {
+        return NULL;
+    }
+
+    shared_buf *shared = (shared_buf *)(s->buf - offsetof(shared_buf, data));
+    atomic_fetch_add_explicit(&shared->refs, 1, memory_order_relaxed);
+    clone->len = s->len;
+    clone->free = s->free;
+    clone->buf = s->buf;
+    clone->alloc = s->alloc;
+    clone->growth = s->growth;
+    clone->flags = SS_FLAG_SHARED;
+    clone->head = 0;
+    SS_STAT_ADD(stat_n_live, 1);
+
+    return clone;
+}
+
+// Move the content of the string `s` to a new reference counted
+// buffer, releasing the previous buffer if owned.
+static ss_err share_buf(ss s) {
+    shared_buf *shared = ss_malloc(s->alloc, sizeof(shared_buf) + s->len + 1 + s->free);
+    if (shared == NULL) {
+        return err_alloc;
+    }
+    atomic_init(&shared->refs, 1);
+    memcpy(shared->data, s->buf, s->len + 1);
+
+    release_buf(s);
+    s->flags = (s->flags & ~(SS_FLAG_INTERNAL_BUF | SS_FLAG_MAPPED)) | SS_FLAG_SHARED;
+    s->buf = shared->data;
+    s->head = 0;
+    return err_none;
+}
+
+static void release_shared_buf(ss s) {
+    shared_buf *shared = (shared_buf *)(s->buf - offsetof(shared_buf, data));
+    if (atomic_fetch_sub_explicit(&shared->refs, 1, memory_order_acq_rel) == 1) {
+        ss_dealloc(s->alloc, shared);
+    }
+}
+
+// Release the buffer of the string `s`, according to its kind.
+static void release_buf(ss s) {
+    if (s->flags & SS_FLAG_SHARED) release_shared_buf(s);
+    else if (s->flags & SS_FLAG_MAPPED) ss_unmap(s->buf - s->head, s->head + s->len + 1 + s->free);
+    else if (!(s->flags & SS_FLAG_INTERNAL_BUF)) ss_dealloc(s->alloc, s->buf - s->head);
+}
+
+// Move the content of the string `s` to a new private buffer with `head`
+// bytes of front space and `avail` free bytes, releasing the old buffer.
+// Buffers above the mmap threshold are mapped. In case of failure the
+// string is left untouched.
+static ss_err move_buf(ss s, size_t head, size_t avail) {
+    size_t size = head + s->len + 1 + avail;
+    int mapped = ss_map_eligible(s->alloc, size);
+    char *block = mapped ? ss_map(size) : ss_malloc(s->alloc, sizeof(char) * size);
+    if (block == NULL) {
+        return err_alloc;
+    }
+    memcpy(block + head, s->buf, s->len + 1);
+
+    release_buf(s);
+    // Moving out of the inline array frees the space
+    // of the growth policy, which is the default one.
+    if (s->flags & SS_FLAG_INLINE) s->growth = NULL;
+    s->flags &= ~(SS_FLAG_INTERNAL_BUF | SS_FLAG_MAPPED | SS_FLAG_SHARED);
+    if (mapped) s->flags |= SS_FLAG_MAPPED;
+    s->buf = block + head;
+    s->head = head;
+    s->free = avail;
+    return err_none;
+}
+
+// Make the buffer of `s` writable, copying it if it's shared.
+static ss_err detach(ss s) {
+    if (s->flags & SS_FLAG_INTERNED) return err_immutable;
+    if (!(s->flags & SS_FLAG_SHARED)) return err_none;
+    return move_buf(s, s->head, s->free);
+}
+
+// Mark or unmark the string `s` as owned by the intern table.
+void ss_set_interned(ss s, int interned) {
+    if (interned) s->flags |= SS_FLAG_INTERNED;
+    else s->flags &= ~SS_FLAG_INTERNED;
 }
 
 /*
@@ -130,14 +431,61 @@ ss ss_clone(ss s) {
  * of failure the ss string `s` is still valid and must be freed after use.
  */
 ss_err ss_set_free_space(ss s, size_t avail) {
+    return resize_buf(s, avail);
+}
+
+// Resize the buffer of the string `s` in order to have exactly `avail` free
+// bytes after the string content, keeping its front space. Embedded and
+// inline buffers can't be reallocated, so they are resized in place while
+// the new space fits their capacity, or moved to a separate buffer when
+// they must grow beyond it. Shared buffers are always copied to a private
+// buffer. Buffers above the mmap threshold are moved to a memory mapping,
+// which then grows with mremap. In case of failure the string is left
+// untouched.
+static ss_err resize_buf(ss s, size_t avail) {
     size_t new_space = s->len + 1 + avail;
 
-    char *new_buf = ss_realloc(s->buf, sizeof(char) * new_space);
-    if (new_buf == NULL) {
+    if (s->flags & SS_FLAG_INTERNED) {
+        return err_immutable;
+    }
+    if (s->flags & SS_FLAG_SHARED) {
+        return move_buf(s, 0, avail);
+    }
+
+    if (s->flags & SS_FLAG_INTERNAL_BUF) {
+        size_t cap = s->flags & SS_FLAG_INLINE
+            ? SS_INLINE_CAP - front_space(s)
+            : s->len + 1 + s->free;
+        if (new_space <= cap) {
+            s->free = avail;
+            return err_none;
+        }
+        return move_buf(s, front_space(s), avail);
+    }
+
+    if (s->flags & SS_FLAG_MAPPED) {
+        char *block = ss_remap(s->buf - s->head, s->head + s->len + 1 + s->free, s->head + new_space);
+        if (block == NULL) {
+            return err_alloc;
+        }
+        s->buf = block + s->head;
+        s->free = avail;
+        return err_none;
+    }
+
+    if (ss_map_eligible(s->alloc, s->head + new_space)) {
+        return move_buf(s, s->head, avail);
+    }
+
+    // We need to alias the reallocated buffer to
+    // avoid overwriting the original pointer in
+    // case of failures.
+    char *block = ss_realloc(s->alloc, s->buf - s->head, sizeof(char) * (s->head + new_space));
+    if (block == NULL) {
         return err_alloc;
     }
 
-    s->buf = new_buf;
+    s->buf = block + s->head;
     s->free = avail;
     return err_none;
 }
@@ -146,35 +494,256 @@ ss_err ss_set_free_space(ss s, size_t avail) {
  * Enlarge the allocated and available space not already used by the string `s` to be at least `avail`
  * bytes long. The operation doesn't change the stored string, it only changes the available space beyond
  * the string end. The function is useful to reserve more space earlier in order to avoid frequent
- * reallocations later. If enough space is already present the function is a no-op. The string `s`
- * is modified in place.
+ * reallocations later. If enough space is already present the function doesn't reallocate. A shared
+ * string (see `ss_clone_shared`) gets its own copy of the content, so that the reserved space can be
+ * written directly. The string `s` is modified in place.
  *
  * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
  * failure the ss string `s` is still valid and must be freed after use.
  */
 ss_err ss_reserve_free_space(ss s, size_t avail) {
-    if (s->free >= avail) return err_none;
+    if (s->free >= avail) return detach(s);
     return ss_set_free_space(s, avail);
 }
 
 /*
- * Deallocate the memory used by the ss string `s`. The string can't be used after being freed
- * since it will point to deallocated memory.
+ * Reserve at least `avail` bytes of free space before the beginning of the string `s`, besides the
+ * free space after its end. Prepending to a string usually moves the whole content forward to make
+ * room, while the front space is consumed by the prepend functions without moving the content. Once
+ * some front space is reserved, the string also grows its front space following its growth policy
+ * when a prepend needs more space than the available one, so a loop of prepends (e.g. encoders adding
+ * length headers and framing) costs amortized O(1) per prepended byte. Passing zero just enables the
+ * front growth. The reserved space is not counted in `free`. The string `s` is modified in place.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
+ * failure the ss string `s` is still valid and must be freed after use.
+ */
+ss_err ss_reserve_front_space(ss s, size_t avail) {
+    if (s->flags & SS_FLAG_INTERNED) return err_immutable;
+    if (avail > front_space(s)) {
+        ss_err err = move_buf(s, avail, s->free);
+        if (err) {
+            return err;
+        }
+    }
+    s->flags |= SS_FLAG_FRONT;
+    return err_none;
+}
+
+/*
+ * Enable (`enabled` not zero) or disable the offset mode of the string `s`. Slicing and trimming a
+ * string usually move the remaining content to the beginning of the buffer, which costs O(n) for each
+ * call. In offset mode the string instead keeps a start offset into its buffer: `ss_slice`, `ss_trim`
+ * and `ss_trim_left` just move the start of the string forward, in O(1), and the bytes left behind
+ * become front space, which prepends can reuse. This suits strings consumed from the front, like the
+ * buffer of a streaming parser dropping each parsed prefix. The content is moved back to the beginning
+ * of the buffer (compacted) only when the front space reaches the threshold set with
+ * `ss_set_compact_threshold` and the string length, or when a concat or grow needs that space. Since
+ * each compaction moves at most as many bytes as the ones consumed before it, consuming a string costs
+ * amortized O(1) per byte. Disabling the mode doesn't compact the string.
+ */
+void ss_set_offset_mode(ss s, int enabled) {
+    if (enabled) s->flags |= SS_FLAG_OFFSET;
+    else s->flags &= ~SS_FLAG_OFFSET;
+}
+
+/*
+ * Set the minimum front space, in bytes, strings in offset mode (see `ss_set_offset_mode`) accumulate
+ * before being compacted by slice and trim functions. A compaction also needs the front space to be at
+ * least as big as the string length, so that the bytes moved are paid by the bytes consumed. Higher
+ * thresholds mean fewer compactions but more memory left unused. The default threshold is 4096 bytes.
+ * The function is not thread safe and should be called before manipulating strings, usually at program
+ * startup.
+ */
+void ss_set_compact_threshold(size_t threshold) {
+    compact_threshold = threshold;
+}
+
+/*
+ * Set the growth policy used by default by all the strings. The policy decides how much space is
+ * allocated when a string must grow (in concat, prepend, grow and formatting functions) and how much
+ * free space the `ss_new_from_raw` and `ss_new_from_raw_len` constructors reserve. Given the length `n`
+ * needed by the string, the policy kinds allocate space for:
+ *
+ * - `growth_geometric`: `n * factor` bytes (`factor` must be >= 1)
+ * - `growth_capped`: `2 * n` bytes while `n` is below `limit`, `n + limit` bytes after that
+ * - `growth_size_class`: `n` bytes rounded up to the allocator size classes (four classes for each
+ * power of two) and to multiples of the page size for big strings
+ * - `growth_exact`: exactly `n` bytes
+ *
+ * Passing NULL restores the default policy, which is geometric with factor 2 (the allocated space is
+ * doubled). The `growth` struct is not copied and must remain valid as long as it's used. The function
+ * is not thread safe and should be called before manipulating strings, usually at program startup.
+ */
+void ss_set_growth(const ss_growth *growth) {
+    global_growth = growth != NULL ? growth : &default_growth;
+}
+
+/*
+ * Set the growth policy of the string `s`, overriding the one set with `ss_set_growth` (see that function
+ * for the available policies). Passing NULL makes the string follow again the default policy. The policy
+ * is inherited by the clones of the string. The `growth` struct is not copied and must remain valid as
+ * long as the string uses it. Small strings stored inline keep their content in the space of the policy,
+ * so setting a policy moves them to a separate buffer.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the string can't be moved out of the
+ * inline array. In case of failure the string `s` keeps its previous policy.
+ */
+ss_err ss_set_growth_str(ss s, const ss_growth *growth) {
+    return set_growth(s, growth);
+}
+
+// Set the growth policy of the string `s`, moving it out of the inline
+// array first if the policy isn't the default one.
+static ss_err set_growth(ss s, const ss_growth *growth) {
+    if (s->flags & SS_FLAG_INLINE) {
+        if (growth == NULL) return err_none;
+        if (s->flags & SS_FLAG_INTERNED) return err_immutable;
+        ss_err err = move_buf(s, front_space(s), s->free);
+        if (err) {
+            return err;
+        }
+    }
+    s->growth = growth;
+    return err_none;
+}
+
+// Return the growth policy followed by the string `s`, its own or
+// the default one. Strings stored inline always follow the default.
+static const ss_growth *string_growth(ss s) {
+    if (!(s->flags & SS_FLAG_INLINE) && s->growth != NULL) return s->growth;
+    return global_growth;
+}
+
+// Return the front space of the string `s`, the bytes of its buffer
+// before the string start. Strings stored inline don't keep it, since
+// it's the offset of the string start into the inline array.
+static size_t front_space(ss s) {
+    if (s->flags & SS_FLAG_INLINE) return (size_t)(s->buf - s->inl);
+    return s->head;
+}
+
+// Return the capacity (without the null terminator) the growth policy `growth`
+// allocates for a string needing `len` bytes. The result is at least `len`.
+static size_t growth_capacity(const ss_growth *growth, size_t len) {
+    size_t cap;
+    switch (growth->kind) {
+        case growth_geometric: {
+            double want = (double)len * (growth->factor > 1 ? growth->factor : 1);
+            cap = want < (double)(SIZE_MAX / 2) ? (size_t)want : len;
+            break;
+        }
+        case growth_capped:
+            cap = len < growth->limit ? len * 2 : len + growth->limit;
+            break;
+        case growth_size_class: {
+            // Classes are multiples of 16 bytes up to 128, then four
+            // classes per power of two (as in jemalloc). Above the page
+            // size the allocation is also rounded to a page multiple.
+            size_t size = len + 1;
+            size_t step = 16;
+            if (size > 128) {
+                size_t pow = 128;
+                while (pow < size / 2 + 1 && pow < SIZE_MAX / 4) pow *= 2;
+                step = pow / 4;
+            }
+            if (size > 4096 && step < 4096) step = 4096;
+            size = (size + step - 1) / step * step;
+            cap = size - 1;
+            break;
+        }
+        case growth_exact:
+        default:
+            cap = len;
+    }
+    return cap < len ? len : cap;
+}
+
+// Make sure the string `s` has at least `avail` writable bytes of front space,
+// growing it as dictated by the string growth policy if that's not the case.
+static ss_err ensure_front(ss s, size_t avail) {
+    if (avail <= front_space(s)) return detach(s);
+    SS_STAT_ADD(stat_n_prepend_realloc, 1);
+    return move_buf(s, growth_capacity(string_growth(s), s->len + avail) - s->len, s->free);
+}
+
+// Make sure the string `s` has at least `avail` writable free bytes, growing
+// the buffer as dictated by the string growth policy if that's not the case.
+static ss_err ensure_free(ss s, size_t avail) {
+    if (avail <= s->free) return detach(s);
+
+    // Strings in offset mode reclaim
+    // their front space before growing.
+    if ((s->flags & SS_FLAG_OFFSET) && front_space(s) != 0) {
+        ss_err err = detach(s);
+        if (err) {
+            return err;
+        }
+        compact(s);
+        if (avail <= s->free) return err_none;
+    }
+
+    return resize_buf(s, growth_capacity(string_growth(s), s->len + avail) - s->len);
+}
+
+// Move the content of the string `s` to the beginning of its
+// buffer, turning the front space into free space.
+static void compact(ss s) {
+    size_t head = front_space(s);
+    memmove(s->buf - head, s->buf, s->len + 1);
+    SS_STAT_ADD(stat_memmove_bytes, s->len);
+    s->buf -= head;
+    s->free += head;
+    if (!(s->flags & SS_FLAG_INLINE)) s->head = 0;
+}
+
+// Drop the first `start` bytes of the string `s` and keep the following
+// `len` ones. Strings in offset mode move their start forward, and they
+// are compacted once the front space is big enough to pay for it, while
+// the other strings move the kept bytes to the beginning of the buffer.
+static void cut_front(ss s, size_t start, size_t len) {
+    if (start != 0 && (s->flags & SS_FLAG_OFFSET)) {
+        s->buf += start;
+        if (!(s->flags & SS_FLAG_INLINE)) s->head += start;
+        s->free += s->len - start - len;
+    } else {
+        if (start != 0) {
+            memmove(s->buf, s->buf + start, len);
+            SS_STAT_ADD(stat_memmove_bytes, len);
+        }
+        s->free += s->len - len;
+    }
+    s->buf[len] = END_STRING;
+    s->len = len;
+
+    if ((s->flags & SS_FLAG_OFFSET) && front_space(s) >= compact_threshold && front_space(s) >= len) {
+        compact(s);
+    }
+}
+
+/*
+ * Deallocate the memory used by the ss string `s`, using the allocator the string was created with.
+ * The string can't be used after being freed since it will point to deallocated memory. The struct
+ * and the buffer provided to `ss_new_on_buf` are not freed, since they belong to the caller. Interned
+ * strings belong to the intern table, so the function is a no-op on them.
  */
 void ss_free(ss s) {
     if (s == NULL || s->buf == NULL) return;
-    free(s->buf);
+    if (s->flags & SS_FLAG_INTERNED) return;
+    release_buf(s);
     s->buf = NULL,
     s->len = 0;
     s->free = 0;
-    free(s);
+    if (!(s->flags & SS_FLAG_EXTERNAL_STRUCT)) ss_dealloc(s->alloc, s);
+    SS_STAT_ADD(stat_n_live, -1);
 }
 
 /*
  * Grow the `s` string to have the specified length `len`. Note that here the function enlarges
- * the string buffer itself, eventually allocates more space. New bytes inserted will be set
- * to zero and they will be safe to be written. If the specified length `len` is smaller than the
- * current length, the function is a no-op. The string `s` is modified in place.
+ * the string buffer itself, eventually allocates more space following the growth policy of the
+ * string. New bytes inserted will be set to zero and they will be safe to be written. If the
+ * specified length `len` is smaller than the current length, the function is a no-op. The string
+ * `s` is modified in place.
  *
  * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
  * failure the ss string `s` is still valid and must be freed after use.
@@ -182,7 +751,7 @@ void ss_free(ss s) {
 ss_err ss_grow(ss s, size_t len) {
     if (len <= s->len) return err_none;
 
-    ss_err err = ss_reserve_free_space(s, len - s->len);
+    ss_err err = ensure_free(s, len - s->len);
     if (err) {
         return err;
     }
@@ -200,13 +769,19 @@ ss_err ss_grow(ss s, size_t len) {
  * The total allocated space is left untouched, while the free space grows. The bytes in the string buffer
  * after the `len`-th one are not cleaned, they are just considered unused and not valid to be read or
  * written. If the length `len` is greater than the current string length the function is a no-op.
- * The string `s` is modified in place.
+ * If the string buffer is memory mapped (see `ss_set_mmap_threshold`), the pages left unused are given
+ * back to the operating system. The string `s` is modified in place.
  */
 void ss_shrink(ss s, size_t len) {
     if (len >= s->len) return;
+    if (detach(s)) return;
     s->free += s->len - len;
     s->buf[len] = END_STRING;
     s->len = len;
+
+    if (s->flags & SS_FLAG_MAPPED) {
+        ss_unmap_unused(s->buf - s->head, s->head + s->len + 1, s->head + s->len + 1 + s->free);
+    }
 }
 
 /*
@@ -223,37 +798,57 @@ void ss_clear(ss s) {
 /*
  * Returns the position (0-indexed) of the starting position of the first occurrence of the substring
  * `needle` in the ss string `haystack` provided as first argument. Returns -1 if no occurrence is
- * found or if `needle` is NULL or an empty string. The string `haystack` is not modified.
+ * found or if `needle` is NULL or an empty string. The whole string is searched, null bytes included,
+ * using its length: candidates are found with a SIMD filter on the first and the last byte of the
+ * needle and, on inputs where too many candidates fail, the search goes on with the Two-Way algorithm,
+ * so it always takes linear time. The string `haystack` is not modified.
  */
 size_t ss_index(ss haystack, const char *needle) {
     if (needle == NULL || *needle == '\0') return -1;
-    char *sub_ptr = strstr(haystack->buf, needle);
-    return sub_ptr != NULL
-        ? sub_ptr - haystack->buf
-        : -1;
+    return ss_search(haystack->buf, haystack->len, needle, strlen(needle));
 }
 
 /*
  * Returns the position (0-indexed) of the starting position of the last occurrence of the substring
  * `needle` in the ss string `haystack` provided as first argument. Returns -1 if no occurrence is
- * found or if `needle` is NULL or an empty string. The string `haystack` is not modified.
+ * found or if `needle` is NULL or an empty string. The whole string is searched backward from its end,
+ * null bytes included, with the same SIMD filter of `ss_index` (or memrchr for single chars) and the
+ * Two-Way algorithm on the reversed string as fallback, so it takes linear time no matter how many
+ * occurrences there are. The string `haystack` is not modified.
  */
 size_t ss_index_last(ss haystack, const char *needle) {
     if (needle == NULL || *needle == '\0') return -1;
+    return ss_search_last(haystack->buf, haystack->len, needle, strlen(needle));
+}
 
-    char *str_ptr = haystack->buf;
-    char *result = NULL;
-    while (1) {
-        char *pos = strstr(str_ptr, needle);
-        if (pos == NULL) break;
-        result = pos;
-        str_ptr = pos + 1;
-    }
-    if (result == NULL) {
-        return -1;
-    }
+/*
+ * Returns the position (0-indexed) of the first occurrence of the substring `needle` in the ss string
+ * `haystack` starting at or after the position `from`, searching like `ss_index` only the bytes from
+ * `from` to the end. Returns -1 if no occurrence is found, if `needle` is NULL or an empty string or if
+ * `from` is greater than the string length. The occurrences can be iterated by calling the function
+ * again from the position after the last one found (plus the needle length to skip overlapping
+ * occurrences), without scanning again the bytes before it. The string `haystack` is not modified.
+ */
+size_t ss_index_from(ss haystack, const char *needle, size_t from) {
+    if (needle == NULL || *needle == '\0') return -1;
+    if (from > haystack->len) return -1;
+    size_t pos = ss_search(haystack->buf + from, haystack->len - from, needle, strlen(needle));
+    return pos != (size_t)-1 ? from + pos : pos;
+}
 
-    return result - haystack->buf;
+/*
+ * Returns the position (0-indexed) of the last occurrence of the substring `needle` in the ss string
+ * `haystack` ending at or before the position `end`, searching like `ss_index_last` only the first
+ * `end` bytes. An `end` greater than the string length is reduced to be equal to it. Returns -1 if no
+ * occurrence is found or if `needle` is NULL or an empty string. The occurrences can be iterated from
+ * the end of the string by calling the function again with `end` set to the position of the last one
+ * found (plus the needle length minus one to include overlapping occurrences). The string `haystack`
+ * is not modified.
+ */
+size_t ss_index_last_before(ss haystack, const char *needle, size_t end) {
+    if (needle == NULL || *needle == '\0') return -1;
+    if (end > haystack->len) end = haystack->len;
+    return ss_search_last(haystack->buf, end, needle, strlen(needle));
 }
 
 /*
@@ -261,10 +856,10 @@ size_t ss_index_last(ss haystack, const char *needle) {
  * is greater than `s2_len`, exceeding bytes are discarded. The `s2` C string is appended to the string
  * `s1`, eventually growing the allocated space for `s1`. The strategy used in concat functions is the
  * following: if the string `s1` has enough allocated space to contain also the string `s2` the content
- * of the latter is simply appended, otherwise the `s1` string will be grown in order to have total
- * allocated space equal to (2*n + 1 for the null terminator) bytes, where n is the resulting (concatenated)
- * string length. In this case, both the final `len` and the free space `free` will be equal to n. The
- * string `s1` is modified in place.
+ * of the latter is simply appended, otherwise the `s1` string will be grown following its growth policy.
+ * With the default policy the total allocated space becomes equal to (2*n + 1 for the null terminator)
+ * bytes, where n is the resulting (concatenated) string length. In this case, both the final `len` and
+ * the free space `free` will be equal to n. The string `s1` is modified in place.
  *
  * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
  * failure the ss string `s1` is still valid and must be freed after use.
@@ -272,18 +867,10 @@ size_t ss_index_last(ss haystack, const char *needle) {
 ss_err ss_concat_raw_len(ss s1, const char *s2, size_t s2_len) {
     size_t new_len = s1->len + s2_len;
 
-    if (s2_len > s1->free) {
-        // We need to alias the reallocated buffer to
-        // avoid overwriting the original pointer in
-        // case of failures.
-        size_t new_alloc = new_len * 2 + 1;
-        char *new_buf = ss_realloc(s1->buf, sizeof(char) * new_alloc);
-        if (new_buf == NULL) {
-            return err_alloc;
-        }
-
-        s1->free = new_alloc - 1 - s1->len;
-        s1->buf = new_buf;
+    if (s2_len > s1->free) SS_STAT_ADD(stat_n_concat_realloc, 1);
+    ss_err err = ensure_free(s1, s2_len);
+    if (err) {
+        return err;
     }
 
     // Copy the s2 string starting the copy at
@@ -329,10 +916,11 @@ ss_err ss_concat_str(ss s1, ss s2) {
  * greater than `s1_len`, exceeding bytes are discarded. The `s1` C string is prepended to the ss
  * string `s2`, eventually growing the allocated space for the latter. The strategy used in prepend
  * functions is the following: if the string `s2` has enough allocated space to contain also the string
- * `s1` the content is simply prepended, otherwise the `s2` string will be grown in order to have
- * allocated space of (2*n + 1 for the null terminator) bytes, where n is the resulting string length.
- * In this case, both the final `len` and the free space `free` will be equal to n. The string `s2`
- * is modified in place.
+ * `s1` the content is simply prepended, otherwise the `s2` string will be grown following its growth
+ * policy. With the default policy the allocated space becomes (2*n + 1 for the null terminator) bytes,
+ * where n is the resulting string length. In this case, both the final `len` and the free space `free`
+ * will be equal to n. Strings with front space (see `ss_reserve_front_space`) take the prepended
+ * content there, without moving the existing content. The string `s2` is modified in place.
  *
  * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
  * failure the string `s2` is still valid and must be freed after use.
@@ -340,23 +928,30 @@ ss_err ss_concat_str(ss s1, ss s2) {
 ss_err ss_prepend_raw_len(const char *s1, ss s2, size_t s1_len) {
     size_t new_len = s2->len + s1_len;
 
-    if (s1_len > s2->free) {
-        // We need to alias the reallocated buffer to
-        // avoid overwriting the original pointer in
-        // case of failures.
-        size_t new_alloc = new_len * 2 + 1;
-        char *new_buf = ss_realloc(s2->buf, sizeof(char) * new_alloc);
-        if (new_buf == NULL) {
-            return err_alloc;
+    // Strings with front space take the new
+    // content there, without moving the old one.
+    if (s1_len <= front_space(s2) || (s2->flags & SS_FLAG_FRONT)) {
+        ss_err err = ensure_front(s2, s1_len);
+        if (err) {
+            return err;
         }
+        s2->buf -= s1_len;
+        if (!(s2->flags & SS_FLAG_INLINE)) s2->head -= s1_len;
+        memcpy(s2->buf, s1, s1_len);
+        s2->len = new_len;
+        return err_none;
+    }
 
-        s2->free = new_alloc - 1 - s2->len;
-        s2->buf = new_buf;
+    if (s1_len > s2->free) SS_STAT_ADD(stat_n_prepend_realloc, 1);
+    ss_err err = ensure_free(s2, s1_len);
+    if (err) {
+        return err;
     }
 
     // Make space for the string to prepend, then
     // copy that string at the beginning.
     memmove(s2->buf + s1_len, s2->buf, s2->len);
+    SS_STAT_ADD(stat_memmove_bytes, s2->len);
     memcpy(s2->buf, s1, s1_len);
     s2->buf[new_len] = END_STRING;
     s2->len = new_len;
@@ -398,31 +993,31 @@ ss_err ss_prepend_str(ss s1, ss s2) {
  * starts from the position `str_index` (inclusive) and ends at `end_index` (not inclusive). If the
  * `str_index` is >= of the original string length no changes are made. If the end index is < of `str_index`
  * no changes are made. If `end_index` > of the string length, `end_index` is reduced to be equal to the
- * string length before slicing the string. The string `s` is modified in place.
+ * string length before slicing the string. Strings in offset mode (see `ss_set_offset_mode`) drop the bytes
+ * before `str_index` in O(1), without moving the substring. The string `s` is modified in place.
  */
 void ss_slice(ss s, size_t str_index, size_t end_index) {
     if (str_index >= s->len) return;
     if (end_index < str_index) return;
+    if (detach(s)) return;
 
     // After this, start index will range from 0 to s->len-1,
     // while end index will range from start_index to s->len.
     size_t _end_index = end_index;
     if (end_index > s->len) _end_index = s->len;
 
-    size_t len = _end_index - str_index;
-    memmove(s->buf, &s->buf[str_index], len);
-    s->free += s->len - len;
-    s->buf[len] = END_STRING;
-    s->len = len;
+    cut_front(s, str_index, _end_index - str_index);
 }
 
 /*
  * Removes characters contained in the `cutset` string from both the start and the end of the
  * ss string `s`. After the trimming operation, the string length is reduced while the allocation
  * size is left untouched, but more free space will be available. If all characters are trimmed
- * the result is a valid but empty string. The string `s` is modified in place.
+ * the result is a valid but empty string. Strings in offset mode (see `ss_set_offset_mode`) drop
+ * the leading characters without moving the rest of the content. The string `s` is modified in place.
  */
 void ss_trim(ss s, const char *cutset) {
+    if (detach(s)) return;
     size_t start = 0;
     size_t end = s->len - 1;
 
@@ -434,34 +1029,25 @@ void ss_trim(ss s, const char *cutset) {
     while ((end > start) && strchr(cutset, s->buf[end])) end--;
 
     size_t len = start > end ? 0 : (end - start + 1);
-    if (start != 0) {
-        memmove(s->buf, s->buf + start, len);
-    }
-
-    s->free += s->len - len;
-    s->buf[len] = END_STRING;
-    s->len = len;
+    cut_front(s, start, len);
 }
 
 /*
  * Removes characters contained in the `cutset` string from the start of the ss string `s`.
  * After the trimming operation, the string length is reduced while the allocation size
  * is left untouched, but more free space will be available. If all characters are trimmed
- * the result is a valid but empty string. The string `s` is modified in place.
+ * the result is a valid but empty string. Strings in offset mode (see `ss_set_offset_mode`)
+ * drop the leading characters without moving the rest of the content. The string `s` is
+ * modified in place.
  */
 void ss_trim_left(ss s, const char *cutset) {
+    if (detach(s)) return;
     size_t start = 0;
     size_t last = s->len - 1;
 
     while ((start <= last) && strchr(cutset, s->buf[start])) start++;
     size_t len = start > last ? 0 : (last - start + 1);
-    if (start != 0) {
-        memmove(s->buf, s->buf + start, len);
-    }
-
-    s->free += s->len - len;
-    s->buf[len] = END_STRING;
-    s->len = len;
+    cut_front(s, start, len);
 }
 
 /*
@@ -471,6 +1057,7 @@ void ss_trim_left(ss s, const char *cutset) {
  * the result is a valid but empty string. The string `s` is modified in place.
  */
 void ss_trim_right(ss s, const char *cutset) {
+    if (detach(s)) return;
     size_t last = s->len - 1;
 
     while ((last >= 0) && strchr(cutset, s->buf[last])) {
@@ -489,6 +1076,7 @@ void ss_trim_right(ss s, const char *cutset) {
  * The string `s` is modified in place.
  */
 void ss_to_lower(ss s) {
+    if (detach(s)) return;
     for (int i = 0; i < s->len; i++) {
         s->buf[i] = tolower(s->buf[i]);
     }
@@ -499,6 +1087,7 @@ void ss_to_lower(ss s) {
  * The string `s` is modified in place.
  */
 void ss_to_upper(ss s) {
+    if (detach(s)) return;
     for (int i = 0; i < s->len; i++) {
         s->buf[i] = toupper(s->buf[i]);
     }
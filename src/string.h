@@ -4,23 +4,62 @@
 
 #include <stdio.h>
 #include "string_err.h"
+#include "string_alloc.h"
 
 #define END_STRING (char)'\0'
+#define SS_INLINE_CAP 22
+
+typedef enum ss_growth_kind {
+    growth_geometric = 0,
+    growth_capped = 1,
+    growth_size_class = 2,
+    growth_exact = 3
+} ss_growth_kind;
+
+typedef struct ss_growth {
+    ss_growth_kind kind;
+    double factor;
+    size_t limit;
+} ss_growth;
 
 typedef struct ss {
     size_t len;
     size_t free;
     char *buf;
+
+    // Private bookkeeping, not part of the public API. Small strings
+    // store their content in place of the fields only used by strings
+    // with a separate buffer, and `flags` starts both layouts.
+    const ss_allocator *alloc;
+    union {
+        struct {
+            unsigned short flags;
+            size_t head;
+            const ss_growth *growth;
+        };
+        struct {
+            unsigned short inl_flags;
+            char inl[SS_INLINE_CAP];
+        };
+    };
 } *ss;
 
 ss ss_new_from_raw_len_free(const char *init, size_t len, size_t avail);
+ss ss_new_from_raw_len_free_alloc(const ss_allocator *alloc, const char *init, size_t len, size_t avail);
 ss ss_new_from_raw_len(const char *init, size_t len);
 ss ss_new_from_raw(const char *init);
 ss ss_new_empty_with_free(size_t avail);
 ss ss_new_empty(void);
+ss ss_new_on_buf(struct ss *hdr, char *buf, size_t size);
 ss ss_clone(ss s);
+ss ss_clone_shared(ss s);
 ss_err ss_set_free_space(ss s, size_t avail);
 ss_err ss_reserve_free_space(ss s, size_t avail);
+ss_err ss_reserve_front_space(ss s, size_t avail);
+void ss_set_offset_mode(ss s, int enabled);
+void ss_set_compact_threshold(size_t threshold);
+void ss_set_growth(const ss_growth *growth);
+ss_err ss_set_growth_str(ss s, const ss_growth *growth);
 void ss_free(ss s);
 
 ss_err ss_grow(ss s, size_t len);
@@ -28,6 +67,8 @@ void ss_shrink(ss s, size_t len);
 void ss_clear(ss s);
 size_t ss_index(ss haystack, const char *needle);
 size_t ss_index_last(ss haystack, const char *needle);
+size_t ss_index_from(ss haystack, const char *needle, size_t from);
+size_t ss_index_last_before(ss haystack, const char *needle, size_t end);
 ss_err ss_concat_raw_len(ss s1, const char *s2, size_t s2_len);
 ss_err ss_concat_raw(ss s1, const char *s2);
 ss_err ss_concat_str(ss s1, ss s2);
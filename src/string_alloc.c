@@ -0,0 +1,380 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "options.h"
+#include "string_alloc.h"
+#include "alloc.h"
+#include "stats.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+static void *default_malloc(void *ctx, size_t size);
+static void *default_realloc(void *ctx, void *ptr, size_t size);
+static void default_free(void *ctx, void *ptr);
+
+static const ss_allocator default_allocator = {
+    .malloc = default_malloc,
+    .realloc = default_realloc,
+    .free = default_free,
+    .ctx = NULL
+};
+
+static const ss_allocator *global_allocator = &default_allocator;
+static size_t mmap_threshold = 0;
+static int mmap_huge_pages = 0;
+
+/*
+ * Set the allocator used by default to allocate, reallocate and free the memory of strings and string
+ * lists. The allocator is a vtable of `malloc`, `realloc` and `free` functions, each one receiving the
+ * user provided `ctx` pointer as first argument. Passing NULL restores the default allocator, based on
+ * the standard library functions. Each string remembers the allocator it was created with, so strings
+ * created before the call keep using the previous allocator for their whole life. Arrays of views and
+ * compact strings don't, so they must be freed before the call, or managed with the `_alloc` variants
+ * of their functions. The `alloc` allocator must remain valid as long as there are strings using it.
+ * The function is not thread safe and should be called before creating strings, usually at program
+ * startup.
+ */
+void ss_set_allocator(const ss_allocator *alloc) {
+    global_allocator = alloc != NULL ? alloc : &default_allocator;
+}
+
+/*
+ * Return the allocator currently used by default to allocate strings and string lists. If no allocator
+ * was set with `ss_set_allocator`, the default allocator based on the standard library functions is
+ * returned.
+ */
+const ss_allocator *ss_get_allocator(void) {
+    return global_allocator;
+}
+
+/*
+ * Set the size (in bytes) above which string buffers are moved from the heap to anonymous memory
+ * mappings. Mapped buffers grow with `mremap`, which remaps the pages instead of copying the buffer,
+ * so building very big strings (hundreds of MB or more) avoids copying the whole content on each
+ * reallocation. Shrinking or clearing a mapped string releases the unused pages to the operating
+ * system, while the string capacity is kept. Only strings allocated with the default allocator are
+ * mapped, since custom allocators must keep control of their memory. The mapping is transparent to
+ * the rest of the API. A threshold of zero (the default) disables the memory mapped buffers. The
+ * option is available only on Linux, elsewhere the function is a no-op. The function is not thread
+ * safe and should be called at program startup.
+ */
+void ss_set_mmap_threshold(size_t threshold) {
+#ifdef __linux__
+    mmap_threshold = threshold;
+#else
+    (void)threshold;
+#endif
+}
+
+/*
+ * Enable (`enabled` different from zero) or disable the use of transparent huge pages for the memory
+ * mapped string buffers (see `ss_set_mmap_threshold`). Huge pages reduce the TLB misses when scanning
+ * very big strings. The option is only a hint to the operating system and it's disabled by default.
+ */
+void ss_set_mmap_huge_pages(int enabled) {
+    mmap_huge_pages = enabled;
+}
+
+// Return the standard library allocator, for memory owned
+// by the library itself rather than by the caller.
+const ss_allocator *ss_default_allocator(void) {
+    return &default_allocator;
+}
+
+// Report whether a buffer of `size` bytes allocated with `alloc` must
+// be memory mapped, according to the current mmap threshold.
+int ss_map_eligible(const ss_allocator *alloc, size_t size) {
+    if (mmap_threshold == 0 || size < mmap_threshold) return 0;
+    return alloc == &default_allocator || (alloc == NULL && global_allocator == &default_allocator);
+}
+
+#ifdef __linux__
+
+static size_t page_round(size_t size) {
+    static size_t page_size = 0;
+    if (page_size == 0) page_size = (size_t)sysconf(_SC_PAGESIZE);
+    return (size + page_size - 1) / page_size * page_size;
+}
+
+static char *map_failure(void) {
+#ifdef SS_ALLOC_EXIT
+    printf("ss_lib: cannot allocate memory\n");
+    exit(1);
+#endif
+    return NULL;
+}
+
+// Map an anonymous region able to contain `size` bytes.
+char *ss_map(size_t size) {
+    size_t map_size = page_round(size);
+    SS_STAT_ADD(stat_n_malloc, 1);
+    SS_STAT_ADD(stat_malloc_bytes, map_size);
+    char *ptr = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return map_failure();
+    }
+    if (mmap_huge_pages) madvise(ptr, map_size, MADV_HUGEPAGE);
+    return ptr;
+}
+
+// Resize a region mapped with `ss_map`, letting the kernel move
+// the pages elsewhere instead of copying them if needed.
+char *ss_remap(char *ptr, size_t old_size, size_t new_size) {
+    size_t old_map_size = page_round(old_size);
+    size_t new_map_size = page_round(new_size);
+    if (old_map_size == new_map_size) return ptr;
+
+    SS_STAT_ADD(stat_n_realloc, 1);
+    SS_STAT_ADD(stat_realloc_bytes, new_map_size);
+
+    char *new_ptr = mremap(ptr, old_map_size, new_map_size, MREMAP_MAYMOVE);
+    if (new_ptr == MAP_FAILED) {
+        return map_failure();
+    }
+    if (mmap_huge_pages) madvise(new_ptr, new_map_size, MADV_HUGEPAGE);
+    return new_ptr;
+}
+
+void ss_unmap(char *ptr, size_t size) {
+    munmap(ptr, page_round(size));
+}
+
+// Give back to the OS the pages of the mapped region of `size` bytes
+// after the first `used` ones. The region stays mapped, the released
+// pages will be zero-filled on the next access.
+void ss_unmap_unused(char *ptr, size_t used, size_t size) {
+    size_t start = page_round(used);
+    size_t end = page_round(size);
+    if (start < end) madvise(ptr + start, end - start, MADV_DONTNEED);
+}
+
+#else
+
+char *ss_map(size_t size) {
+    (void)size;
+    return NULL;
+}
+
+char *ss_remap(char *ptr, size_t old_size, size_t new_size) {
+    (void)ptr;
+    (void)old_size;
+    (void)new_size;
+    return NULL;
+}
+
+void ss_unmap(char *ptr, size_t size) {
+    (void)ptr;
+    (void)size;
+}
+
+void ss_unmap_unused(char *ptr, size_t used, size_t size) {
+    (void)ptr;
+    (void)used;
+    (void)size;
+}
+
+#endif
+
+static void *default_malloc(void *ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void *default_realloc(void *ctx, void *ptr, size_t size) {
+    (void)ctx;
+    return realloc(ptr, size);
+}
+
+static void default_free(void *ctx, void *ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+// Arena chunks are linked in allocation order and reused after
+// a reset. The chunk data starts right after the chunk struct.
+typedef struct arena_chunk {
+    struct arena_chunk *next;
+    size_t size;
+    size_t used;
+} arena_chunk;
+
+struct ss_arena {
+    ss_allocator alloc;
+    const ss_allocator *backing;
+    arena_chunk *head;
+    arena_chunk *cur;
+    char *last;
+    size_t chunk_size;
+};
+
+// Every arena block is preceded by its size and both the
+// size and the blocks are aligned to this boundary.
+#define ARENA_ALIGN sizeof(size_t)
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+static void *arena_malloc(void *ctx, size_t size);
+static void *arena_realloc(void *ctx, void *ptr, size_t size);
+static void arena_free(void *ctx, void *ptr);
+
+/*
+ * Create a new arena allocator. An arena hands out memory by bumping a pointer inside big chunks
+ * of `chunk_size` bytes (or a default size of 64 KiB if `chunk_size` is zero), allocated with the
+ * allocator currently set with `ss_set_allocator`. Strings, lists and temporary buffers are allocated
+ * from the arena by passing `ss_arena_allocator(arena)` to the `_alloc` variants of the library
+ * functions, or by setting it as the global allocator. Growing the most recently allocated block
+ * happens in place, while freeing single blocks is a no-op (except for the most recent block, whose
+ * space is reclaimed): the memory is released all at once with `ss_arena_reset` or `ss_arena_free`.
+ * This makes the arena ideal for many strings sharing the same lifetime, e.g. the strings built
+ * while serving a request. The arena is not thread safe.
+ *
+ * Returns the new arena or NULL if the allocation fails.
+ */
+ss_arena ss_arena_new(size_t chunk_size) {
+    const ss_allocator *backing = ss_get_allocator();
+    ss_arena arena = backing->malloc(backing->ctx, sizeof(struct ss_arena));
+    if (arena == NULL) {
+        return NULL;
+    }
+
+    *arena = (struct ss_arena){
+        .alloc = {
+            .malloc = arena_malloc,
+            .realloc = arena_realloc,
+            .free = arena_free,
+            .ctx = arena
+        },
+        .backing = backing,
+        .head = NULL,
+        .cur = NULL,
+        .last = NULL,
+        .chunk_size = chunk_size > 0 ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE
+    };
+    return arena;
+}
+
+/*
+ * Return the allocator handing out memory from the arena `arena`. The allocator can be passed to the
+ * `_alloc` variants of the library functions or set as the global allocator with `ss_set_allocator`.
+ * The allocator is valid as long as the arena is not freed.
+ */
+const ss_allocator *ss_arena_allocator(ss_arena arena) {
+    return &arena->alloc;
+}
+
+/*
+ * Release at once all the memory allocated from the arena `arena` in constant time. The arena chunks
+ * are kept and reused for the following allocations, so an arena reset at the end of each request
+ * avoids allocating memory in steady state. All the strings and lists allocated from the arena can't
+ * be used after the reset, and they must not be freed.
+ */
+void ss_arena_reset(ss_arena arena) {
+    arena->cur = arena->head;
+    arena->last = NULL;
+    if (arena->cur != NULL) arena->cur->used = 0;
+}
+
+/*
+ * Deallocate the arena `arena` and all the memory allocated from it. All the strings and lists allocated
+ * from the arena can't be used after the arena is freed, and they must not be freed on their own.
+ */
+void ss_arena_free(ss_arena arena) {
+    if (arena == NULL) return;
+    arena_chunk *chunk = arena->head;
+    while (chunk != NULL) {
+        arena_chunk *next = chunk->next;
+        arena->backing->free(arena->backing->ctx, chunk);
+        chunk = next;
+    }
+    arena->backing->free(arena->backing->ctx, arena);
+}
+
+// Return the first chunk, starting from the current one, with at least `need`
+// free bytes. Chunks following the current one are leftovers of a previous
+// reset and are reused when big enough, otherwise a new chunk is linked right
+// after the current one.
+static arena_chunk *arena_chunk_with(ss_arena arena, size_t need) {
+    arena_chunk *cur = arena->cur;
+    if (cur != NULL && cur->size - cur->used >= need) return cur;
+
+    arena_chunk *next = cur != NULL ? cur->next : arena->head;
+    if (next != NULL && next->size >= need) {
+        next->used = 0;
+        arena->cur = next;
+        return next;
+    }
+
+    size_t size = need > arena->chunk_size ? need : arena->chunk_size;
+    arena_chunk *chunk = arena->backing->malloc(arena->backing->ctx, sizeof(arena_chunk) + size);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    *chunk = (arena_chunk){
+        .next = next,
+        .size = size,
+        .used = 0
+    };
+    if (cur != NULL) cur->next = chunk;
+    else arena->head = chunk;
+    arena->cur = chunk;
+    return chunk;
+}
+
+static void *arena_malloc(void *ctx, size_t size) {
+    ss_arena arena = ctx;
+    size_t need = ARENA_ALIGN + (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+
+    arena_chunk *chunk = arena_chunk_with(arena, need);
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    char *block = (char *)(chunk + 1) + chunk->used;
+    *(size_t *)block = need - ARENA_ALIGN;
+    chunk->used += need;
+    arena->last = block + ARENA_ALIGN;
+    return arena->last;
+}
+
+static void *arena_realloc(void *ctx, void *ptr, size_t size) {
+    ss_arena arena = ctx;
+    if (ptr == NULL) return arena_malloc(ctx, size);
+
+    size_t *block_size = (size_t *)((char *)ptr - ARENA_ALIGN);
+    size_t new_size = (size + ARENA_ALIGN - 1) / ARENA_ALIGN * ARENA_ALIGN;
+
+    // The most recent block sits at the end of the used
+    // part of the current chunk: it can be resized in place
+    // as long as the chunk has enough room.
+    if (ptr == arena->last) {
+        arena_chunk *cur = arena->cur;
+        size_t start = (char *)ptr - (char *)(cur + 1);
+        if (start + new_size <= cur->size) {
+            cur->used = start + new_size;
+            *block_size = new_size;
+            return ptr;
+        }
+    } else if (new_size <= *block_size) {
+        return ptr;
+    }
+
+    void *new_ptr = arena_malloc(ctx, size);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, *block_size < size ? *block_size : size);
+    return new_ptr;
+}
+
+static void arena_free(void *ctx, void *ptr) {
+    ss_arena arena = ctx;
+    if (ptr != arena->last) return;
+
+    // Only the most recent block can be reclaimed, moving
+    // back the bump pointer of the current chunk.
+    arena->cur->used = (char *)ptr - ARENA_ALIGN - (char *)(arena->cur + 1);
+    arena->last = NULL;
+}
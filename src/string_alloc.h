@@ -0,0 +1,25 @@
+
+#ifndef SS_STRING_ALLOC_H
+#define SS_STRING_ALLOC_H
+
+#include <stddef.h>
+
+typedef struct ss_allocator {
+    void *(*malloc)(void *ctx, size_t size);
+    void *(*realloc)(void *ctx, void *ptr, size_t size);
+    void (*free)(void *ctx, void *ptr);
+    void *ctx;
+} ss_allocator;
+
+typedef struct ss_arena *ss_arena;
+
+void ss_set_allocator(const ss_allocator *alloc);
+const ss_allocator *ss_get_allocator(void);
+void ss_set_mmap_threshold(size_t threshold);
+void ss_set_mmap_huge_pages(int enabled);
+ss_arena ss_arena_new(size_t chunk_size);
+const ss_allocator *ss_arena_allocator(ss_arena arena);
+void ss_arena_reset(ss_arena arena);
+void ss_arena_free(ss_arena arena);
+
+#endif
@@ -0,0 +1,371 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "string.h"
+#include "string_compact.h"
+#include "alloc.h"
+#include "stats.h"
+
+// Header classes of compact strings. The header is placed right before
+// the string buffer and contains the `len` and `free` fields, both as
+// wide as the class requires, followed by one byte storing the class.
+typedef enum compact_class {
+    class_8 = 0,
+    class_16 = 1,
+    class_32 = 2,
+    class_64 = 3
+} compact_class;
+
+static const size_t field_size[] = {1, 2, 4, 8};
+
+static compact_class class_for(size_t cap);
+static size_t header_size(compact_class c);
+static size_t read_field(const char *field, compact_class c);
+static void write_field(char *field, compact_class c, size_t value);
+static void write_header(ss_compact s, compact_class c, size_t len, size_t avail);
+
+/*
+ * Build a new compact string copying the provided `init` C string of length `len` and allocating
+ * additional `avail` bytes. Compact strings are meant for big collections of short strings: instead
+ * of the `ss` struct, the length and the free space are stored in a small header placed right before
+ * the string buffer, using 8, 16, 32 or 64 bits fields depending on the allocated space. A string up
+ * to 255 bytes has a 3 bytes header, while a `ss` string always needs a struct and a pointer to it.
+ * The header class is promoted automatically when the string grows. A compact string is a pointer
+ * to its null terminated buffer, so it can be used wherever a C string is expected. If `init` is NULL
+ * a new empty string is returned. The string is allocated with the allocator set with `ss_set_allocator`.
+ * Since the header has no room for an allocator, the string must be reallocated and freed with the same
+ * allocator: the global one must not change while the string is alive, or the string must be managed
+ * with the `_alloc` variants of the compact functions.
+ *
+ * Returns the newly generated string or NULL if the allocation fails.
+ */
+ss_compact ss_compact_new_from_raw_len_free(const char *init, size_t len, size_t avail) {
+    return ss_compact_new_from_raw_len_free_alloc(NULL, init, len, avail);
+}
+
+/*
+ * Build a new compact string exactly like `ss_compact_new_from_raw_len_free`, but allocating it with
+ * the provided `alloc` allocator. Compact strings don't remember their allocator, so the string must
+ * be grown with `ss_compact_set_free_space_alloc`, `ss_compact_grow_alloc` and
+ * `ss_compact_concat_raw_len_alloc` and freed with `ss_compact_free_alloc`, passing the same `alloc`.
+ * If `alloc` is NULL the allocator currently set with `ss_set_allocator` is used.
+ *
+ * Returns the newly generated string or NULL if the allocation fails.
+ */
+ss_compact ss_compact_new_from_raw_len_free_alloc(const ss_allocator *alloc, const char *init, size_t len, size_t avail) {
+    if (init == NULL) {
+        init = "";
+        len = 0;
+        avail = 0;
+    }
+
+    compact_class c = class_for(len + avail);
+    char *block = ss_malloc(alloc, header_size(c) + len + avail + 1);
+    if (block == NULL) {
+        return NULL;
+    }
+
+    ss_compact s = block + header_size(c);
+    memcpy(s, init, len);
+    s[len] = END_STRING;
+    write_header(s, c, len, avail);
+    SS_STAT_ADD(stat_n_live, 1);
+    return s;
+}
+
+/*
+ * Build a new compact string copying the provided `init` C string of length `len`, without any free
+ * space. It is a shorthand for `ss_compact_new_from_raw_len_free(init, len, 0)`.
+ *
+ * Returns the newly generated string or NULL if the allocation fails.
+ */
+ss_compact ss_compact_new_from_raw_len(const char *init, size_t len) {
+    return ss_compact_new_from_raw_len_free(init, len, 0);
+}
+
+/*
+ * Build a new compact string copying the provided null terminated `init` C string, without any free
+ * space. If `init` is NULL a new empty string is returned.
+ *
+ * Returns the newly generated string or NULL if the allocation fails.
+ */
+ss_compact ss_compact_new_from_raw(const char *init) {
+    if (init == NULL) return ss_compact_new_from_raw_len_free(NULL, 0, 0);
+    return ss_compact_new_from_raw_len_free(init, strlen(init), 0);
+}
+
+/*
+ * Build a new compact string copying the content of the ss string `s`, without any free space. It is
+ * useful to store in a compact form strings built with the rest of the library.
+ *
+ * Returns the newly generated string or NULL if the allocation fails.
+ */
+ss_compact ss_compact_from_ss(ss s) {
+    return ss_compact_new_from_raw_len_free(s->buf, s->len, 0);
+}
+
+/*
+ * Build a new ss string copying the content of the compact string `s`, in order to use the whole
+ * library API on it. The ss string must be freed after use with `ss_free`.
+ *
+ * Returns the newly generated string or NULL if the allocation fails.
+ */
+ss ss_compact_to_ss(ss_compact s) {
+    return ss_new_from_raw_len(s, ss_compact_len(s));
+}
+
+/*
+ * Returns the length of the compact string `s`, without the null terminator.
+ */
+size_t ss_compact_len(ss_compact s) {
+    compact_class c = (compact_class)(unsigned char)s[-1];
+    return read_field(s - header_size(c), c);
+}
+
+/*
+ * Returns the free space of the compact string `s`, that is the allocated bytes after the string
+ * content, not counting the null terminator.
+ */
+size_t ss_compact_free_space(ss_compact s) {
+    compact_class c = (compact_class)(unsigned char)s[-1];
+    return read_field(s - header_size(c) + field_size[c], c);
+}
+
+/*
+ * Returns the size in bytes of the header placed before the buffer of the compact string `s`: 3, 5,
+ * 9 or 17 bytes, depending on the allocated space.
+ */
+size_t ss_compact_header_size(ss_compact s) {
+    return header_size((compact_class)(unsigned char)s[-1]);
+}
+
+/*
+ * Set the free space of the compact string `s` to be exactly `avail` bytes, reallocating the string.
+ * The header class is chosen again from the new allocated space, so the header is promoted to wider
+ * fields when the string grows and demoted when it shrinks. Since the string may be moved, `s` is
+ * passed by pointer and updated in place.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the string `s` is still valid and must be freed after use.
+ */
+ss_err ss_compact_set_free_space(ss_compact *s, size_t avail) {
+    return ss_compact_set_free_space_alloc(NULL, s, avail);
+}
+
+/*
+ * Set the free space of the compact string `s` exactly like `ss_compact_set_free_space`, reallocating
+ * the string with the `alloc` allocator it was created with. If `alloc` is NULL the allocator currently
+ * set with `ss_set_allocator` is used.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the string `s` is still valid and must be freed after use.
+ */
+ss_err ss_compact_set_free_space_alloc(const ss_allocator *alloc, ss_compact *s, size_t avail) {
+    ss_compact buf = *s;
+    size_t len = ss_compact_len(buf);
+    size_t old_free = ss_compact_free_space(buf);
+    compact_class old_c = (compact_class)(unsigned char)buf[-1];
+    compact_class new_c = class_for(len + avail);
+    size_t old_hdr = header_size(old_c);
+    size_t new_hdr = header_size(new_c);
+    char *block = buf - old_hdr;
+
+    // A narrower header needs the content to be moved back
+    // before the reallocation truncates the block.
+    if (new_hdr < old_hdr) memmove(block + new_hdr, buf, len + 1);
+
+    char *new_block = ss_realloc(alloc, block, new_hdr + len + avail + 1);
+    if (new_block == NULL) {
+        if (new_hdr < old_hdr) {
+            memmove(buf, block + new_hdr, len + 1);
+            write_header(buf, old_c, len, old_free);
+        }
+        return err_alloc;
+    }
+
+    if (new_hdr > old_hdr) memmove(new_block + new_hdr, new_block + old_hdr, len + 1);
+    *s = new_block + new_hdr;
+    write_header(*s, new_c, len, avail);
+    return err_none;
+}
+
+/*
+ * Grow the compact string `s` to have the specified length `len`. New bytes are set to zero. When
+ * the free space is not enough, the string is reallocated doubling the needed space and its header
+ * is promoted if the new space requires wider fields. If `len` is smaller than the current length
+ * the function is a no-op. Since the string may be moved, `s` is passed by pointer and updated in
+ * place.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the string `s` is still valid and must be freed after use.
+ */
+ss_err ss_compact_grow(ss_compact *s, size_t len) {
+    return ss_compact_grow_alloc(NULL, s, len);
+}
+
+/*
+ * Grow the compact string `s` exactly like `ss_compact_grow`, reallocating the string with the `alloc`
+ * allocator it was created with. If `alloc` is NULL the allocator currently set with `ss_set_allocator`
+ * is used.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the string `s` is still valid and must be freed after use.
+ */
+ss_err ss_compact_grow_alloc(const ss_allocator *alloc, ss_compact *s, size_t len) {
+    size_t old_len = ss_compact_len(*s);
+    if (len <= old_len) return err_none;
+
+    if (len - old_len > ss_compact_free_space(*s)) {
+        ss_err err = ss_compact_set_free_space_alloc(alloc, s, 2 * len - old_len);
+        if (err) {
+            return err;
+        }
+    }
+
+    compact_class c = (compact_class)(unsigned char)(*s)[-1];
+    memset(*s + old_len, 0, len - old_len);
+    (*s)[len] = END_STRING;
+    write_header(*s, c, len, ss_compact_free_space(*s) - (len - old_len));
+    return err_none;
+}
+
+/*
+ * Concatenate the C string `s2` of length `s2_len` to the compact string `s1`. When the free space is
+ * not enough, the string is reallocated doubling the needed space and its header is promoted if the
+ * new space requires wider fields. Since the string may be moved, `s1` is passed by pointer and
+ * updated in place.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the string `s1` is still valid and must be freed after use.
+ */
+ss_err ss_compact_concat_raw_len(ss_compact *s1, const char *s2, size_t s2_len) {
+    return ss_compact_concat_raw_len_alloc(NULL, s1, s2, s2_len);
+}
+
+/*
+ * Concatenate the C string `s2` of length `s2_len` to the compact string `s1` exactly like
+ * `ss_compact_concat_raw_len`, reallocating the string with the `alloc` allocator it was created with.
+ * If `alloc` is NULL the allocator currently set with `ss_set_allocator` is used.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the string `s1` is still valid and must be freed after use.
+ */
+ss_err ss_compact_concat_raw_len_alloc(const ss_allocator *alloc, ss_compact *s1, const char *s2, size_t s2_len) {
+    size_t len = ss_compact_len(*s1);
+
+    if (s2_len > ss_compact_free_space(*s1)) {
+        SS_STAT_ADD(stat_n_concat_realloc, 1);
+        ss_err err = ss_compact_set_free_space_alloc(alloc, s1, len + 2 * s2_len);
+        if (err) {
+            return err;
+        }
+    }
+
+    compact_class c = (compact_class)(unsigned char)(*s1)[-1];
+    memcpy(*s1 + len, s2, s2_len);
+    (*s1)[len + s2_len] = END_STRING;
+    write_header(*s1, c, len + s2_len, ss_compact_free_space(*s1) - s2_len);
+    return err_none;
+}
+
+/*
+ * Concatenate the null terminated C string `s2` to the compact string `s1`. It is a shorthand for
+ * `ss_compact_concat_raw_len(s1, s2, strlen(s2))`. If `s2` is NULL the function is a no-op.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the string `s1` is still valid and must be freed after use.
+ */
+ss_err ss_compact_concat_raw(ss_compact *s1, const char *s2) {
+    if (s2 == NULL) return err_none;
+    return ss_compact_concat_raw_len(s1, s2, strlen(s2));
+}
+
+/*
+ * Free the compact string `s`, header included, with the allocator set with `ss_set_allocator`. If `s`
+ * is NULL the function is a no-op.
+ */
+void ss_compact_free(ss_compact s) {
+    ss_compact_free_alloc(NULL, s);
+}
+
+/*
+ * Free the compact string `s`, header included, with the `alloc` allocator it was created with. If
+ * `alloc` is NULL the allocator currently set with `ss_set_allocator` is used. If `s` is NULL the
+ * function is a no-op.
+ */
+void ss_compact_free_alloc(const ss_allocator *alloc, ss_compact s) {
+    if (s == NULL) return;
+    ss_dealloc(alloc, s - ss_compact_header_size(s));
+    SS_STAT_ADD(stat_n_live, -1);
+}
+
+// Choose the narrowest header class whose fields can store `cap`.
+static compact_class class_for(size_t cap) {
+    if (cap <= UINT8_MAX) return class_8;
+    if (cap <= UINT16_MAX) return class_16;
+    if (cap <= UINT32_MAX) return class_32;
+    return class_64;
+}
+
+static size_t header_size(compact_class c) {
+    return 2 * field_size[c] + 1;
+}
+
+// Fields are read and written with memcpy, since
+// the header doesn't respect any alignment.
+static size_t read_field(const char *field, compact_class c) {
+    switch (c) {
+        case class_8: {
+            uint8_t value;
+            memcpy(&value, field, sizeof(value));
+            return value;
+        }
+        case class_16: {
+            uint16_t value;
+            memcpy(&value, field, sizeof(value));
+            return value;
+        }
+        case class_32: {
+            uint32_t value;
+            memcpy(&value, field, sizeof(value));
+            return value;
+        }
+        default: {
+            uint64_t value;
+            memcpy(&value, field, sizeof(value));
+            return (size_t)value;
+        }
+    }
+}
+
+static void write_field(char *field, compact_class c, size_t value) {
+    switch (c) {
+        case class_8: {
+            uint8_t v = (uint8_t)value;
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+        case class_16: {
+            uint16_t v = (uint16_t)value;
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+        case class_32: {
+            uint32_t v = (uint32_t)value;
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+        default: {
+            uint64_t v = (uint64_t)value;
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+    }
+}
+
+static void write_header(ss_compact s, compact_class c, size_t len, size_t avail) {
+    char *hdr = s - header_size(c);
+    write_field(hdr, c, len);
+    write_field(hdr + field_size[c], c, avail);
+    s[-1] = (char)c;
+}
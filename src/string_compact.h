@@ -0,0 +1,27 @@
+#ifndef SS_STRING_COMPACT_H
+#define SS_STRING_COMPACT_H
+
+#include "string.h"
+
+typedef char *ss_compact;
+
+ss_compact ss_compact_new_from_raw_len_free(const char *init, size_t len, size_t avail);
+ss_compact ss_compact_new_from_raw_len_free_alloc(const ss_allocator *alloc, const char *init, size_t len, size_t avail);
+ss_compact ss_compact_new_from_raw_len(const char *init, size_t len);
+ss_compact ss_compact_new_from_raw(const char *init);
+ss_compact ss_compact_from_ss(ss s);
+ss ss_compact_to_ss(ss_compact s);
+size_t ss_compact_len(ss_compact s);
+size_t ss_compact_free_space(ss_compact s);
+size_t ss_compact_header_size(ss_compact s);
+ss_err ss_compact_set_free_space(ss_compact *s, size_t avail);
+ss_err ss_compact_set_free_space_alloc(const ss_allocator *alloc, ss_compact *s, size_t avail);
+ss_err ss_compact_grow(ss_compact *s, size_t len);
+ss_err ss_compact_grow_alloc(const ss_allocator *alloc, ss_compact *s, size_t len);
+ss_err ss_compact_concat_raw_len(ss_compact *s1, const char *s2, size_t s2_len);
+ss_err ss_compact_concat_raw_len_alloc(const ss_allocator *alloc, ss_compact *s1, const char *s2, size_t s2_len);
+ss_err ss_compact_concat_raw(ss_compact *s1, const char *s2);
+void ss_compact_free(ss_compact s);
+void ss_compact_free_alloc(const ss_allocator *alloc, ss_compact s);
+
+#endif
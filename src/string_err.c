@@ -3,6 +3,7 @@
 static const char err_str_none[] = "";
 static const char err_str_alloc[] = "allocation error";
 static const char err_str_format[] = "formatting error";
+static const char err_str_immutable[] = "immutable string error";
 static const char err_str_unknown[] = "unknown error";
 
 /*
@@ -17,6 +18,8 @@ const char *ss_err_str(ss_err err) {
             return err_str_alloc;
         case err_format:
             return err_str_format;
+        case err_immutable:
+            return err_str_immutable;
         default:
             return err_str_unknown;
     }
@@ -5,7 +5,8 @@
 typedef enum ss_err {
     err_none = 0,
     err_alloc = 1,
-    err_format = 2
+    err_format = 2,
+    err_immutable = 3
 } ss_err;
 
 const char *ss_err_str(ss_err err);
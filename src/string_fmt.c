@@ -1,21 +1,23 @@
 #include <stdlib.h>
-#include <strings.h>
+#include <string.h>
 #include <stdarg.h>
 #include "string.h"
+#include "string_fmt.h"
 #include "alloc.h"
 
 /*
  * Formats the string and concatenates it to the `s` string. Formatting is performed using the usual
  * C formatting directive. The function accepts a `va_list` to accommodate a variable number of arguments.
  * The argument list should be started (`va_start`) before providing it to this function and must be ended
- * (`va_end`) after the function call. The `s` string is modified in place.
+ * (`va_end`) after the function call. Temporary buffers are allocated with the allocator of `s`. The `s`
+ * string is modified in place.
  *
  * Returns `err_none` (zero) in case of success or an error if case of reallocation or formatting errors.
  * In case of failure the `s` is still valid and must be freed after use.
  */
 ss_err ss_sprintf_va_cat(ss s, const char *format, va_list arg_list) {
     size_t buf_len = sizeof(char) * strlen(format) * 2 + 1;
-    char *buf = ss_malloc(buf_len);
+    char *buf = ss_malloc(s->alloc, buf_len);
     if (buf == NULL) {
         return err_alloc;
     }
@@ -34,7 +36,7 @@ ss_err ss_sprintf_va_cat(ss s, const char *format, va_list arg_list) {
         n_written = vsnprintf(buf, buf_len, format, arg_list_copy);
         if (n_written < 0) {
             // vsnprintf encoding error
-            free(buf);
+            ss_dealloc(s->alloc, buf);
             return err_format;
         }
 
@@ -46,9 +48,9 @@ ss_err ss_sprintf_va_cat(ss s, const char *format, va_list arg_list) {
         if (n_written < buf_len) break;
 
         buf_len *= 2;
-        char *new_buf = ss_realloc(buf, buf_len);
+        char *new_buf = ss_realloc(s->alloc, buf, buf_len);
         if (new_buf == NULL) {
-            free(buf);
+            ss_dealloc(s->alloc, buf);
             return err_alloc;
         }
         buf = new_buf;
@@ -57,7 +59,7 @@ ss_err ss_sprintf_va_cat(ss s, const char *format, va_list arg_list) {
     // Finally, concat the ss string with the
     // formatted C string and return any error.
     ss_err err = ss_concat_raw_len(s, buf, n_written);
-    free(buf);
+    ss_dealloc(s->alloc, buf);
     return err;
 }
 
@@ -71,7 +73,18 @@ ss_err ss_sprintf_va_cat(ss s, const char *format, va_list arg_list) {
  * Returns the formatted string in case of success or NULL in case of allocations errors.
  */
 ss ss_sprintf_va(const char *format, va_list arg_list) {
-    ss s = ss_new_empty();
+    return ss_sprintf_va_alloc(NULL, format, arg_list);
+}
+
+/*
+ * Formats and returns a string exactly like `ss_sprintf_va`, but allocating the returned string with
+ * the provided `alloc` allocator. If `alloc` is NULL the allocator currently set with `ss_set_allocator`
+ * is used. The returned string must be freed after use with the dedicated `ss_free` function.
+ *
+ * Returns the formatted string in case of success or NULL in case of allocations errors.
+ */
+ss ss_sprintf_va_alloc(const ss_allocator *alloc, const char *format, va_list arg_list) {
+    ss s = ss_new_from_raw_len_free_alloc(alloc, "", 0, 0);
     if (s == NULL) return NULL;
     ss_err err = ss_sprintf_va_cat(s, format, arg_list);
     if (err) {
@@ -103,16 +116,24 @@ ss_err ss_sprintf_cat(ss s, const char *format, ...) {
  * Returns the formatted string in case of success or NULL in case of allocations errors.
  */
 ss ss_sprintf(const char *format, ...) {
-    ss s = ss_new_empty();
-    if (s == NULL) return NULL;
+    va_list arg_list;
+    va_start(arg_list, format);
+    ss s = ss_sprintf_va_alloc(NULL, format, arg_list);
+    va_end(arg_list);
+    return s;
+}
 
+/*
+ * Formats and returns a new string exactly like `ss_sprintf`, but allocating the returned string with
+ * the provided `alloc` allocator. If `alloc` is NULL the allocator currently set with `ss_set_allocator`
+ * is used. The returned string must be freed after use as usual with the dedicated `ss_free` function.
+ *
+ * Returns the formatted string in case of success or NULL in case of allocations errors.
+ */
+ss ss_sprintf_alloc(const ss_allocator *alloc, const char *format, ...) {
     va_list arg_list;
     va_start(arg_list, format);
-    ss_err err = ss_sprintf_va_cat(s, format, arg_list);
+    ss s = ss_sprintf_va_alloc(alloc, format, arg_list);
     va_end(arg_list);
-    if (err) {
-        ss_free(s);
-        return NULL;
-    }
     return s;
 }
\ No newline at end of file
@@ -7,7 +7,9 @@
 
 ss_err ss_sprintf_va_cat(ss s, const char *format, va_list arg_list);
 ss ss_sprintf_va(const char *format, va_list arg_list);
+ss ss_sprintf_va_alloc(const ss_allocator *alloc, const char *format, va_list arg_list);
 ss_err ss_sprintf_cat(ss s, const char *format, ...);
 ss ss_sprintf(const char *format, ...);
+ss ss_sprintf_alloc(const ss_allocator *alloc, const char *format, ...);
 
 #endif
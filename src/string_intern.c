@@ -0,0 +1,172 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "string.h"
+#include "string_intern.h"
+#include "alloc.h"
+#include "intern.h"
+
+#define INTERN_INITIAL_CAP 64
+
+// Slot of the intern table, the hash is cached to
+// skip the comparison of strings with different hash.
+typedef struct intern_entry {
+    size_t hash;
+    ss str;
+} intern_entry;
+
+// The intern table is an open addressing hash table with linear
+// probing and a power of two capacity, kept at most 70% full. The
+// lookups take the lock in read mode, so they run concurrently.
+static pthread_rwlock_t table_lock = PTHREAD_RWLOCK_INITIALIZER;
+static intern_entry *table = NULL;
+static size_t table_cap = 0;
+static size_t table_n = 0;
+static size_t table_string_bytes = 0;
+
+static size_t hash_bytes(const char *str, size_t len);
+static ss lookup(const char *str, size_t len, size_t hash);
+static int grow_table(void);
+
+/*
+ * Return the canonical interned string with the content of the C string `str` of length `len`. The
+ * intern table keeps one string for each distinct content: the first call with a given content adds a
+ * copy of it to the table, the following calls return the same string. So two interned strings are
+ * equal if and only if they are the same pointer, and comparing them costs a pointer comparison. Useful
+ * to store only once the many duplicates of header names, enum-like values or tokens. Interned strings
+ * are owned by the table: they can't be modified (mutating functions fail with `err_immutable` or leave
+ * the string untouched) and `ss_free` is a no-op on them. The lookups are safe to be done concurrently
+ * from many threads. The table allocates its memory with the standard library allocator.
+ *
+ * Returns the interned string or NULL if the allocation fails.
+ */
+ss ss_intern_raw_len(const char *str, size_t len) {
+    size_t hash = hash_bytes(str, len);
+
+    pthread_rwlock_rdlock(&table_lock);
+    ss found = lookup(str, len, hash);
+    pthread_rwlock_unlock(&table_lock);
+    if (found != NULL) return found;
+
+    // Another thread could have added the same
+    // string in the meantime, so look up again.
+    pthread_rwlock_wrlock(&table_lock);
+    found = lookup(str, len, hash);
+    if (found == NULL && grow_table()) {
+        found = ss_new_from_raw_len_free_alloc(ss_default_allocator(), str, len, 0);
+        if (found != NULL) {
+            ss_set_interned(found, 1);
+            size_t i = hash & (table_cap - 1);
+            while (table[i].str != NULL) i = (i + 1) & (table_cap - 1);
+            table[i] = (intern_entry){.hash = hash, .str = found};
+            table_n++;
+            table_string_bytes += sizeof(struct ss) + (len + 1 > SS_INLINE_CAP ? len + 1 : 0);
+        }
+    }
+    pthread_rwlock_unlock(&table_lock);
+
+    return found;
+}
+
+/*
+ * Return the canonical interned string with the content of the null terminated C string `str`. It
+ * is a shorthand for `ss_intern_raw_len(str, strlen(str))`, see that function for more info.
+ *
+ * Returns the interned string or NULL if the allocation fails.
+ */
+ss ss_intern_raw(const char *str) {
+    return ss_intern_raw_len(str, strlen(str));
+}
+
+/*
+ * Return the canonical interned string with the content of the ss string `s`. The string `s` is not
+ * modified and it must still be freed after use, the returned string belongs to the intern table.
+ *
+ * Returns the interned string or NULL if the allocation fails.
+ */
+ss ss_intern_str(ss s) {
+    return ss_intern_raw_len(s->buf, s->len);
+}
+
+/*
+ * Fill `stats` with the memory accounting of the intern table: the number of interned strings, the
+ * bytes allocated for them (string structs and buffers) and the bytes allocated for the hash table.
+ */
+void ss_intern_get_stats(ss_intern_stats *stats) {
+    pthread_rwlock_rdlock(&table_lock);
+    stats->n_strings = table_n;
+    stats->string_bytes = table_string_bytes;
+    stats->table_bytes = table_cap * sizeof(intern_entry);
+    pthread_rwlock_unlock(&table_lock);
+}
+
+/*
+ * Free all the interned strings and the intern table. All the strings previously returned by the
+ * intern functions become invalid, so the function is meant to be called when they are not used
+ * anymore, for example at the end of the program or between independent workloads. It must not be
+ * called concurrently with other uses of the interned strings.
+ */
+void ss_intern_reset(void) {
+    pthread_rwlock_wrlock(&table_lock);
+    for (size_t i = 0; i < table_cap; i++) {
+        if (table[i].str == NULL) continue;
+        ss_set_interned(table[i].str, 0);
+        ss_free(table[i].str);
+    }
+    ss_dealloc(ss_default_allocator(), table);
+    table = NULL;
+    table_cap = 0;
+    table_n = 0;
+    table_string_bytes = 0;
+    pthread_rwlock_unlock(&table_lock);
+}
+
+// FNV-1a hash of the `len` bytes of `str`.
+static size_t hash_bytes(const char *str, size_t len) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 1099511628211ULL;
+    }
+    return (size_t)hash;
+}
+
+// Find the interned string with the given content, the
+// caller must hold the table lock.
+static ss lookup(const char *str, size_t len, size_t hash) {
+    if (table_cap == 0) return NULL;
+    size_t i = hash & (table_cap - 1);
+    while (table[i].str != NULL) {
+        ss cand = table[i].str;
+        if (table[i].hash == hash && cand->len == len && memcmp(cand->buf, str, len) == 0) {
+            return cand;
+        }
+        i = (i + 1) & (table_cap - 1);
+    }
+    return NULL;
+}
+
+// Make room for one more entry, doubling the table if it would
+// be more than 70% full. The caller must hold the write lock.
+// Returns zero if the allocation fails.
+static int grow_table(void) {
+    if ((table_n + 1) * 10 <= table_cap * 7) return 1;
+
+    size_t new_cap = table_cap == 0 ? INTERN_INITIAL_CAP : table_cap * 2;
+    intern_entry *new_table = ss_malloc(ss_default_allocator(), sizeof(intern_entry) * new_cap);
+    if (new_table == NULL) return 0;
+    memset(new_table, 0, sizeof(intern_entry) * new_cap);
+
+    for (size_t i = 0; i < table_cap; i++) {
+        if (table[i].str == NULL) continue;
+        size_t j = table[i].hash & (new_cap - 1);
+        while (new_table[j].str != NULL) j = (j + 1) & (new_cap - 1);
+        new_table[j] = table[i];
+    }
+
+    ss_dealloc(ss_default_allocator(), table);
+    table = new_table;
+    table_cap = new_cap;
+    return 1;
+}
@@ -0,0 +1,18 @@
+#ifndef SS_STRING_INTERN_H
+#define SS_STRING_INTERN_H
+
+#include "string.h"
+
+typedef struct ss_intern_stats {
+    size_t n_strings;
+    size_t string_bytes;
+    size_t table_bytes;
+} ss_intern_stats;
+
+ss ss_intern_raw_len(const char *str, size_t len);
+ss ss_intern_raw(const char *str);
+ss ss_intern_str(ss s);
+void ss_intern_get_stats(ss_intern_stats *stats);
+void ss_intern_reset(void);
+
+#endif
@@ -0,0 +1,144 @@
+#include <string.h>
+#include "string.h"
+#include "string_list.h"
+#include "alloc.h"
+
+/*
+ * Build a new empty string list. A list is a growable array of ss strings: `items` holds the strings
+ * and `len` their number, so the list can be read like the `ss *` arrays returned by `ss_split_raw`,
+ * while it also tracks its capacity. The array grows geometrically (its capacity doubles when it's
+ * full), so pushing n strings costs O(n) copies overall, and clearing a list keeps its capacity, so a
+ * list reused across the iterations of a loop stops reallocating after the first ones. The list owns
+ * its strings: they are freed with it by `ss_list_destroy`. The list allocates its array with the
+ * allocator set with `ss_set_allocator`.
+ *
+ * Returns the new list or NULL if the allocation fails.
+ */
+ss_list ss_list_new(void) {
+    return ss_list_new_alloc(NULL);
+}
+
+/*
+ * Build a new empty string list exactly like `ss_list_new`, but allocating its array and the strings
+ * built by the list functions (e.g. `ss_list_push_raw_len` and `ss_split_raw_list`) with the provided
+ * `alloc` allocator. If `alloc` is NULL the allocator currently set with `ss_set_allocator` is used.
+ *
+ * Returns the new list or NULL if the allocation fails.
+ */
+ss_list ss_list_new_alloc(const ss_allocator *alloc) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    ss_list list = ss_malloc(alloc, sizeof(struct ss_list));
+    if (list == NULL) {
+        return NULL;
+    }
+    list->len = 0;
+    list->items = NULL;
+    list->cap = 0;
+    list->alloc = alloc;
+    return list;
+}
+
+/*
+ * Make sure the string list `list` has room for at least `n` more strings, so that pushing them
+ * doesn't reallocate the array. If enough space is already present the function is a no-op.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the list is left untouched.
+ */
+ss_err ss_list_reserve(ss_list list, size_t n) {
+    if (list->len + n <= list->cap) return err_none;
+
+    size_t cap = list->cap * 2;
+    if (cap < list->len + n) cap = list->len + n;
+    if (cap < 8) cap = 8;
+
+    ss *items = ss_realloc(list->alloc, list->items, sizeof(ss) * cap);
+    if (items == NULL) {
+        return err_alloc;
+    }
+    list->items = items;
+    list->cap = cap;
+    return err_none;
+}
+
+/*
+ * Append the ss string `s` at the end of the string list `list`. The string is not copied: the list
+ * takes ownership of it, so it's freed with the list and it must not be freed by the caller.
+ *
+ * Returns `err_none` (zero) in case of success or an error if the reallocation fails. In case of
+ * failure the string is not added and it still belongs to the caller.
+ */
+ss_err ss_list_push(ss_list list, ss s) {
+    ss_err err = ss_list_reserve(list, 1);
+    if (err) {
+        return err;
+    }
+    list->items[list->len++] = s;
+    return err_none;
+}
+
+/*
+ * Append a new string, copy of the C string `s` of length `len`, at the end of the string list
+ * `list`. If the length of the C string is greater than `len`, exceeding bytes are discarded. The new
+ * string has no free space and it's allocated with the allocator of the list.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of failure
+ * the list is left untouched.
+ */
+ss_err ss_list_push_raw_len(ss_list list, const char *s, size_t len) {
+    ss_err err = ss_list_reserve(list, 1);
+    if (err) {
+        return err;
+    }
+
+    ss str = ss_new_from_raw_len_free_alloc(list->alloc, s, len, 0);
+    if (str == NULL) {
+        return err_alloc;
+    }
+    list->items[list->len++] = str;
+    return err_none;
+}
+
+/*
+ * Append a new string, copy of the null terminated C string `s`, at the end of the string list `list`.
+ * It is a shorthand for `ss_list_push_raw_len(list, s, strlen(s))`. If `s` is NULL the function is a
+ * no-op.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of failure
+ * the list is left untouched.
+ */
+ss_err ss_list_push_raw(ss_list list, const char *s) {
+    if (s == NULL) return err_none;
+    return ss_list_push_raw_len(list, s, strlen(s));
+}
+
+/*
+ * Remove the last string from the string list `list` and return it. The ownership of the string goes
+ * back to the caller, who must free it after use with `ss_free`. The capacity of the list is kept.
+ *
+ * Returns the removed string or NULL if the list is empty.
+ */
+ss ss_list_pop(ss_list list) {
+    if (list->len == 0) return NULL;
+    return list->items[--list->len];
+}
+
+/*
+ * Free all the strings of the string list `list` and set its length to zero. The array is kept, so
+ * refilling the list up to its previous length doesn't reallocate.
+ */
+void ss_list_clear(ss_list list) {
+    for (size_t i = 0; i < list->len; i++) ss_free(list->items[i]);
+    list->len = 0;
+}
+
+/*
+ * Deallocate the string list `list`, its array and all the strings it contains. The list can't be
+ * used after being destroyed. Passing NULL is a no-op.
+ */
+void ss_list_destroy(ss_list list) {
+    if (list == NULL) return;
+    ss_list_clear(list);
+    ss_dealloc(list->alloc, list->items);
+    ss_dealloc(list->alloc, list);
+}
@@ -0,0 +1,25 @@
+#ifndef SS_STRING_LIST_H
+#define SS_STRING_LIST_H
+
+#include "string.h"
+
+typedef struct ss_list {
+    size_t len;
+    ss *items;
+
+    // Private bookkeeping, not part of the public API.
+    size_t cap;
+    const ss_allocator *alloc;
+} *ss_list;
+
+ss_list ss_list_new(void);
+ss_list ss_list_new_alloc(const ss_allocator *alloc);
+ss_err ss_list_reserve(ss_list list, size_t n);
+ss_err ss_list_push(ss_list list, ss s);
+ss_err ss_list_push_raw_len(ss_list list, const char *s, size_t len);
+ss_err ss_list_push_raw(ss_list list, const char *s);
+ss ss_list_pop(ss_list list);
+void ss_list_clear(ss_list list);
+void ss_list_destroy(ss_list list);
+
+#endif
@@ -0,0 +1,416 @@
+#include <stdint.h>
+#include <string.h>
+#include "string.h"
+#include "string_matcher.h"
+#include "alloc.h"
+#include "charset.h"
+
+// Flag set on the transitions to the states where a pattern ends, so that
+// the scan loop reads the output of a state only when there is one.
+#define MATCH_FLAG 0x80000000u
+#define NONE UINT32_MAX
+
+// Longest run of bytes in the root state the scan waits for before calling
+// the prefilter again. The wait starts at one byte and doubles each time
+// the prefilter stops right away, so on text dense in first bytes the DFA
+// runs alone instead of paying a call per byte. A call that skips bytes
+// resets the wait.
+#define PREFILTER_RUN 32
+
+// Outputs of a state: the first pattern ending exactly at the state (the
+// others with the same content are chained through `next_same`), the
+// nearest state on the failure chain with its own patterns and the total
+// number of patterns ending at the state, failure chain included.
+typedef struct state_out {
+    uint32_t own;
+    uint32_t dict;
+    uint32_t total;
+} state_out;
+
+// The automaton is a dense DFA: the bytes used by the patterns are mapped
+// to classes (all the other bytes share class 0) and the transitions are a
+// single table of `n_states` rows of `n_classes` entries. Each entry holds
+// the offset of the row of the next state, so the scan loop is one load
+// per byte, reading rows that are usually few and hot in the cache.
+struct ss_matcher {
+    uint32_t *delta;
+    size_t n_states;
+    size_t n_classes;
+    uint8_t classes[256];
+    state_out *out;
+    uint32_t *next_same;
+    size_t *lens;
+    size_t n_patterns;
+    int prefilter;
+    ss_charset first;
+    const ss_allocator *alloc;
+};
+
+static ss_matcher build(const ss_allocator *alloc, const char **patterns, const size_t *lens, size_t n);
+static ss_err build_trie(ss_matcher matcher, const char **patterns, size_t *max_states);
+static ss_err build_links(ss_matcher matcher);
+static void build_prefilter(ss_matcher matcher, const char **patterns);
+static int next_match(ss_matcher matcher, const unsigned char *s, size_t len, size_t *pos, uint32_t *row);
+static uint32_t first_output(ss_matcher matcher, uint32_t state);
+
+/*
+ * Build a matcher (an Aho-Corasick automaton) searching all the `n` null terminated C strings of the
+ * array `patterns` at once. Searching many patterns one at a time takes one scan of the string for
+ * each pattern, while the matcher finds all their occurrences in a single scan, in time proportional
+ * to the string length plus the number of matches, no matter how many patterns there are. The matcher
+ * is built once and it can be used to search any number of strings, also from many threads at the same
+ * time. Each pattern is identified by its index in the array. Empty (or NULL) patterns never match,
+ * while patterns repeated in the array match together. The patterns are copied, so the array can be
+ * freed afterwards. The matcher is allocated with the allocator set with `ss_set_allocator` and it must
+ * be freed after use with `ss_matcher_free`.
+ *
+ * Returns the new matcher or NULL if the allocation fails.
+ */
+ss_matcher ss_matcher_new(const char **patterns, int n) {
+    return ss_matcher_new_alloc(NULL, patterns, n);
+}
+
+/*
+ * Build a matcher exactly like `ss_matcher_new`, but allocating all its memory with the provided
+ * `alloc` allocator. If `alloc` is NULL the allocator currently set with `ss_set_allocator` is used.
+ *
+ * Returns the new matcher or NULL if the allocation fails.
+ */
+ss_matcher ss_matcher_new_alloc(const ss_allocator *alloc, const char **patterns, int n) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    if (n < 0) n = 0;
+
+    size_t *lens = ss_malloc(alloc, sizeof(size_t) * (n > 0 ? n : 1));
+    if (lens == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) lens[i] = patterns[i] != NULL ? strlen(patterns[i]) : 0;
+
+    ss_matcher matcher = build(alloc, patterns, lens, n);
+    if (matcher == NULL) ss_dealloc(alloc, lens);
+    return matcher;
+}
+
+/*
+ * Build a matcher exactly like `ss_matcher_new`, searching the strings of the string list `list` (see
+ * `ss_list_new`). Each pattern is identified by its index in the list and it can contain null bytes.
+ * The matcher is allocated with the allocator of the list, while the list is not modified.
+ *
+ * Returns the new matcher or NULL if the allocation fails.
+ */
+ss_matcher ss_matcher_new_list(ss_list list) {
+    const ss_allocator *alloc = list->alloc;
+    size_t n = list->len;
+
+    size_t *lens = ss_malloc(alloc, sizeof(size_t) * (n > 0 ? n : 1));
+    const char **patterns = ss_malloc(alloc, sizeof(char *) * (n > 0 ? n : 1));
+    if (lens == NULL || patterns == NULL) {
+        ss_dealloc(alloc, lens);
+        ss_dealloc(alloc, patterns);
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) {
+        patterns[i] = list->items[i]->buf;
+        lens[i] = list->items[i]->len;
+    }
+
+    ss_matcher matcher = build(alloc, patterns, lens, n);
+    if (matcher == NULL) ss_dealloc(alloc, lens);
+    ss_dealloc(alloc, patterns);
+    return matcher;
+}
+
+/*
+ * Returns the number of patterns of the matcher `matcher`, empty patterns included.
+ */
+size_t ss_matcher_len(ss_matcher matcher) {
+    return matcher->n_patterns;
+}
+
+/*
+ * Search the ss string `s` with the matcher `matcher` and set `match` to the first match: the one that
+ * ends first in the string and, among the patterns ending at the same position, the longest one. The
+ * `pattern` field of the match is the index of the pattern, while `pos` and `len` are the position and
+ * the length of the match in `s`. The whole string is searched, null bytes included. The string `s` is
+ * not modified.
+ *
+ * Returns 1 if a match was found, 0 otherwise (and `match` is not modified).
+ */
+int ss_matcher_find(ss_matcher matcher, ss s, ss_match *match) {
+    size_t pos = 0;
+    uint32_t row = 0;
+    if (!next_match(matcher, (const unsigned char *)s->buf, s->len, &pos, &row)) return 0;
+
+    uint32_t id = first_output(matcher, row / matcher->n_classes);
+    match->pattern = id;
+    match->len = matcher->lens[id];
+    match->pos = pos - match->len;
+    return 1;
+}
+
+/*
+ * Search the ss string `s` with the matcher `matcher` and call the function `fn` on each match, passing
+ * the match and the `ctx` pointer. All the matches are reported, overlapping ones included, in order of
+ * their end position and, for the same end position, from the longest pattern to the shortest one. The
+ * string is scanned once, whatever the number of patterns. If `fn` returns a value different from zero
+ * the search stops. The string `s` is not modified.
+ *
+ * Returns the value returned by the last call to `fn`, or zero if there are no matches.
+ */
+int ss_matcher_each(ss_matcher matcher, ss s, ss_match_fn fn, void *ctx) {
+    size_t pos = 0;
+    uint32_t row = 0;
+    while (next_match(matcher, (const unsigned char *)s->buf, s->len, &pos, &row)) {
+        uint32_t state = row / matcher->n_classes;
+        uint32_t st = matcher->out[state].own != NONE ? state : matcher->out[state].dict;
+        for (; st != NONE; st = matcher->out[st].dict) {
+            for (uint32_t id = matcher->out[st].own; id != NONE; id = matcher->next_same[id]) {
+                ss_match match = {.pattern = id, .pos = pos - matcher->lens[id], .len = matcher->lens[id]};
+                int ret = fn(match, ctx);
+                if (ret != 0) return ret;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Returns the number of matches of the matcher `matcher` in the ss string `s`, overlapping ones
+ * included, as reported by `ss_matcher_each`. The matches are only counted, so the string is scanned
+ * once without visiting the matched patterns. The string `s` is not modified.
+ */
+size_t ss_matcher_count(ss_matcher matcher, ss s) {
+    size_t count = 0;
+    size_t pos = 0;
+    uint32_t row = 0;
+    while (next_match(matcher, (const unsigned char *)s->buf, s->len, &pos, &row)) {
+        count += matcher->out[row / matcher->n_classes].total;
+    }
+    return count;
+}
+
+/*
+ * Deallocate the matcher `matcher`. The matcher can't be used after being freed. Passing NULL is a
+ * no-op.
+ */
+void ss_matcher_free(ss_matcher matcher) {
+    if (matcher == NULL) return;
+    const ss_allocator *alloc = matcher->alloc;
+    ss_dealloc(alloc, matcher->delta);
+    ss_dealloc(alloc, matcher->out);
+    ss_dealloc(alloc, matcher->next_same);
+    ss_dealloc(alloc, matcher->lens);
+    ss_dealloc(alloc, matcher);
+}
+
+// Build the matcher of the `n` patterns of lengths `lens`, which becomes
+// owned by the matcher. Returns NULL (without freeing `lens`) in case of
+// allocation failures or if the automaton is too big for its offsets.
+static ss_matcher build(const ss_allocator *alloc, const char **patterns, const size_t *lens, size_t n) {
+    ss_matcher matcher = ss_malloc(alloc, sizeof(struct ss_matcher));
+    if (matcher == NULL) {
+        return NULL;
+    }
+    memset(matcher, 0, sizeof(struct ss_matcher));
+    matcher->alloc = alloc;
+    matcher->lens = (size_t *)lens;
+    matcher->n_patterns = n;
+
+    // Map each byte used by the patterns to its own class.
+    int used[256] = {0};
+    size_t max_states = 1;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < lens[i]; j++) used[(unsigned char)patterns[i][j]] = 1;
+        max_states += lens[i];
+    }
+    int n_used = 0;
+    for (int c = 0; c < 256; c++) n_used += used[c];
+    matcher->n_classes = n_used < 256 ? n_used + 1 : 256;
+    for (int c = 0, next = n_used < 256 ? 1 : 0; c < 256; c++) {
+        matcher->classes[c] = used[c] ? (uint8_t)next++ : 0;
+    }
+
+    if (max_states > (MATCH_FLAG - 1) / matcher->n_classes) {
+        matcher->lens = NULL;
+        ss_matcher_free(matcher);
+        return NULL;
+    }
+
+    if (build_trie(matcher, patterns, &max_states) || build_links(matcher)) {
+        matcher->lens = NULL;
+        ss_matcher_free(matcher);
+        return NULL;
+    }
+    build_prefilter(matcher, patterns);
+    return matcher;
+}
+
+// Build the trie of the patterns in the transition table, where a zero
+// entry means no child (the root is never a child). The table is sized
+// for the worst case of `max_states` states and then shrunk.
+static ss_err build_trie(ss_matcher matcher, const char **patterns, size_t *max_states) {
+    const ss_allocator *alloc = matcher->alloc;
+    size_t n_classes = matcher->n_classes;
+
+    matcher->delta = ss_malloc(alloc, sizeof(uint32_t) * *max_states * n_classes);
+    matcher->out = ss_malloc(alloc, sizeof(state_out) * *max_states);
+    matcher->next_same = ss_malloc(alloc, sizeof(uint32_t) * (matcher->n_patterns > 0 ? matcher->n_patterns : 1));
+    if (matcher->delta == NULL || matcher->out == NULL || matcher->next_same == NULL) {
+        return err_alloc;
+    }
+    memset(matcher->delta, 0, sizeof(uint32_t) * n_classes);
+    matcher->out[0] = (state_out){.own = NONE, .dict = NONE, .total = 0};
+    matcher->n_states = 1;
+
+    for (size_t i = 0; i < matcher->n_patterns; i++) {
+        if (matcher->lens[i] == 0) continue;
+
+        uint32_t state = 0;
+        for (size_t j = 0; j < matcher->lens[i]; j++) {
+            uint32_t *entry = &matcher->delta[state * n_classes + matcher->classes[(unsigned char)patterns[i][j]]];
+            if (*entry == 0) {
+                uint32_t child = (uint32_t)matcher->n_states++;
+                memset(&matcher->delta[child * n_classes], 0, sizeof(uint32_t) * n_classes);
+                matcher->out[child] = (state_out){.own = NONE, .dict = NONE, .total = 0};
+                *entry = child;
+            }
+            state = *entry;
+        }
+
+        // Chain the patterns ending at the same state, in index order.
+        matcher->next_same[i] = NONE;
+        uint32_t *last = &matcher->out[state].own;
+        while (*last != NONE) last = &matcher->next_same[*last];
+        *last = (uint32_t)i;
+        matcher->out[state].total++;
+    }
+
+    uint32_t *delta = ss_realloc(alloc, matcher->delta, sizeof(uint32_t) * matcher->n_states * n_classes);
+    state_out *out = ss_realloc(alloc, matcher->out, sizeof(state_out) * matcher->n_states);
+    if (delta != NULL) matcher->delta = delta;
+    if (out != NULL) matcher->out = out;
+    *max_states = matcher->n_states;
+    return err_none;
+}
+
+// Visit the trie breadth first, computing the failure link of each state
+// (the longest proper suffix of its path that is also a path of the trie)
+// and filling the missing transitions with the ones of the failure state,
+// which turns the trie in a DFA. Then the entries become row offsets,
+// flagged if they lead to a state with outputs.
+static ss_err build_links(ss_matcher matcher) {
+    const ss_allocator *alloc = matcher->alloc;
+    size_t n_classes = matcher->n_classes;
+    uint32_t *delta = matcher->delta;
+
+    uint32_t *fail = ss_malloc(alloc, sizeof(uint32_t) * matcher->n_states);
+    uint32_t *queue = ss_malloc(alloc, sizeof(uint32_t) * matcher->n_states);
+    if (fail == NULL || queue == NULL) {
+        ss_dealloc(alloc, fail);
+        ss_dealloc(alloc, queue);
+        return err_alloc;
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    for (size_t c = 0; c < n_classes; c++) {
+        uint32_t child = delta[c];
+        if (child == 0) continue;
+        fail[child] = 0;
+        queue[tail++] = child;
+    }
+
+    while (head < tail) {
+        uint32_t state = queue[head++];
+        uint32_t f = fail[state];
+        state_out *out = &matcher->out[state];
+        out->dict = matcher->out[f].own != NONE ? f : matcher->out[f].dict;
+        out->total += matcher->out[f].total;
+
+        for (size_t c = 0; c < n_classes; c++) {
+            uint32_t *entry = &delta[state * n_classes + c];
+            if (*entry == 0) {
+                *entry = delta[f * n_classes + c];
+                continue;
+            }
+            fail[*entry] = delta[f * n_classes + c];
+            queue[tail++] = *entry;
+        }
+    }
+
+    for (size_t i = 0; i < matcher->n_states * n_classes; i++) {
+        uint32_t next = delta[i];
+        delta[i] = (uint32_t)(next * n_classes) | (matcher->out[next].total > 0 ? MATCH_FLAG : 0);
+    }
+
+    ss_dealloc(alloc, fail);
+    ss_dealloc(alloc, queue);
+    return err_none;
+}
+
+// Enable the prefilter if the patterns start with few distinct bytes:
+// while the automaton is in the root state, the scan jumps to the next
+// byte starting a pattern with the SIMD scanner of the byte sets.
+static void build_prefilter(ss_matcher matcher, const char **patterns) {
+    char first[SS_CHARSET_MAX_SIMD + 1];
+    int n_first = 0;
+    int used[256] = {0};
+
+    for (size_t i = 0; i < matcher->n_patterns; i++) {
+        if (matcher->lens[i] == 0) continue;
+        unsigned char c = (unsigned char)patterns[i][0];
+        if (used[c]) continue;
+        // Null bytes can't be in a byte set, which is a C string.
+        if (c == '\0' || n_first == SS_CHARSET_MAX_SIMD) return;
+        used[c] = 1;
+        first[n_first++] = (char)c;
+    }
+    if (n_first == 0) return;
+
+    first[n_first] = '\0';
+    ss_charset_init(&matcher->first, first);
+    matcher->prefilter = 1;
+}
+
+// Run the automaton on the `len` bytes of `s` from the position `pos`
+// and the state row `row`, up to the end of the next match. Returns 1
+// setting `pos` after the last byte of the match and `row` to the row of
+// the state reached, or 0 at the end of the buffer.
+static int next_match(ss_matcher matcher, const unsigned char *s, size_t len, size_t *pos, uint32_t *row) {
+    const uint32_t *delta = matcher->delta;
+    const uint8_t *classes = matcher->classes;
+    int prefilter = matcher->prefilter;
+    uint32_t r = *row;
+    // Bytes since the scan entered the root state, zero elsewhere. The
+    // check on this run is predictable, unlike the one on the state.
+    size_t idle = r == 0 ? 1 : 0;
+    size_t wait = 1;
+
+    for (size_t i = *pos; i < len; i++) {
+        if (prefilter && idle >= wait) {
+            size_t skip = ss_charset_find(&matcher->first, (const char *)s + i, len - i);
+            i += skip;
+            if (i == len) break;
+            if (skip != 0) wait = 1;
+            else if (wait < PREFILTER_RUN) wait *= 2;
+            idle = 0;
+        }
+        r = delta[r + classes[s[i]]];
+        idle = (idle + 1) & -(size_t)(r == 0);
+        if (r & MATCH_FLAG) {
+            *pos = i + 1;
+            *row = r & ~MATCH_FLAG;
+            return 1;
+        }
+    }
+    *pos = len;
+    *row = r;
+    return 0;
+}
+
+// Returns the longest pattern ending at the state `state`, which has at
+// least one output.
+static uint32_t first_output(ss_matcher matcher, uint32_t state) {
+    if (matcher->out[state].own != NONE) return matcher->out[state].own;
+    return matcher->out[matcher->out[state].dict].own;
+}
@@ -0,0 +1,26 @@
+#ifndef SS_STRING_MATCHER_H
+#define SS_STRING_MATCHER_H
+
+#include "string.h"
+#include "string_list.h"
+
+typedef struct ss_matcher *ss_matcher;
+
+typedef struct ss_match {
+    size_t pattern;
+    size_t pos;
+    size_t len;
+} ss_match;
+
+typedef int (*ss_match_fn)(ss_match match, void *ctx);
+
+ss_matcher ss_matcher_new(const char **patterns, int n);
+ss_matcher ss_matcher_new_alloc(const ss_allocator *alloc, const char **patterns, int n);
+ss_matcher ss_matcher_new_list(ss_list list);
+size_t ss_matcher_len(ss_matcher matcher);
+int ss_matcher_find(ss_matcher matcher, ss s, ss_match *match);
+int ss_matcher_each(ss_matcher matcher, ss s, ss_match_fn fn, void *ctx);
+size_t ss_matcher_count(ss_matcher matcher, ss s);
+void ss_matcher_free(ss_matcher matcher);
+
+#endif
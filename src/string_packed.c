@@ -0,0 +1,289 @@
+#include <stdlib.h>
+#include <string.h>
+#include "string.h"
+#include "string_packed.h"
+#include "alloc.h"
+
+// The pieces are stored back to back in `data`, each one followed by
+// a null terminator, so they can also be used as C strings. The start
+// of the piece i is offsets[i], while offsets[n] is the end of the
+// used data, so the length of a piece is the difference between two
+// consecutive offsets, minus the terminator.
+struct ss_packed {
+    char *data;
+    size_t data_used;
+    size_t data_cap;
+    size_t *offsets;
+    size_t n;
+    size_t n_cap;
+    const ss_allocator *alloc;
+};
+
+static ss_err grow(ss_packed list, size_t n, size_t data_size);
+static int compare_views(const void *a, const void *b);
+
+/*
+ * Build a new empty packed list. A packed list stores a sequence of strings (pieces) back to back in a
+ * single buffer, plus an array with the offset of each piece, instead of a separate string struct and
+ * buffer for each element as in the `ss *` lists. Iterating over the pieces reads memory sequentially
+ * and a list of millions of pieces costs two allocations, which suits batch jobs over many small fields.
+ * Pieces can only be appended, sorted or dropped all together, they are not mutable one by one. The
+ * pieces are accessed as views (see `ss_view`), which are invalidated by the operations that may move
+ * the buffer (push, reserve and sort). The list allocates its memory with the allocator set with
+ * `ss_set_allocator` and it must be freed after use with `ss_packed_free`.
+ *
+ * Returns the new list or NULL if the allocation fails.
+ */
+ss_packed ss_packed_new(void) {
+    return ss_packed_new_alloc(NULL);
+}
+
+/*
+ * Build a new empty packed list exactly like `ss_packed_new`, but allocating all its memory with the
+ * provided `alloc` allocator. If `alloc` is NULL the allocator currently set with `ss_set_allocator` is
+ * used.
+ *
+ * Returns the new list or NULL if the allocation fails.
+ */
+ss_packed ss_packed_new_alloc(const ss_allocator *alloc) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    ss_packed list = ss_malloc(alloc, sizeof(struct ss_packed));
+    if (list == NULL) {
+        return NULL;
+    }
+    list->data = NULL;
+    list->data_used = 0;
+    list->data_cap = 0;
+    list->offsets = NULL;
+    list->n = 0;
+    list->n_cap = 0;
+    list->alloc = alloc;
+    return list;
+}
+
+/*
+ * Reserve space in the packed list `list` for `n` more pieces holding `bytes` bytes in total (null
+ * terminators excluded), so that pushing them doesn't reallocate. Without a reservation the list grows
+ * geometrically, doubling its buffers when they are full.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
+ * failure the list is still valid and must be freed after use.
+ */
+ss_err ss_packed_reserve(ss_packed list, size_t n, size_t bytes) {
+    return grow(list, n, bytes + n);
+}
+
+/*
+ * Append the C string `s` of length `len` as a new piece at the end of the packed list `list`. If the
+ * length of the C string is greater than `len`, exceeding bytes are discarded. The piece is copied in
+ * the list buffer, so `s` can be modified or freed afterwards.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
+ * failure the list is still valid and must be freed after use.
+ */
+ss_err ss_packed_push_raw_len(ss_packed list, const char *s, size_t len) {
+    ss_err err = grow(list, 1, len + 1);
+    if (err) {
+        return err;
+    }
+
+    memcpy(list->data + list->data_used, s, len);
+    list->data[list->data_used + len] = END_STRING;
+    list->data_used += len + 1;
+    list->n++;
+    list->offsets[list->n] = list->data_used;
+    return err_none;
+}
+
+/*
+ * Append the null terminated C string `s` as a new piece at the end of the packed list `list`. It is
+ * a shorthand for `ss_packed_push_raw_len(list, s, strlen(s))`. If `s` is NULL the function is a no-op.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
+ * failure the list is still valid and must be freed after use.
+ */
+ss_err ss_packed_push_raw(ss_packed list, const char *s) {
+    if (s == NULL) return err_none;
+    return ss_packed_push_raw_len(list, s, strlen(s));
+}
+
+/*
+ * Append a copy of the ss string `s` as a new piece at the end of the packed list `list`. It is a
+ * shorthand for `ss_packed_push_raw_len(list, s->buf, s->len)`. The string `s` is not modified.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of
+ * failure the list is still valid and must be freed after use.
+ */
+ss_err ss_packed_push_str(ss_packed list, ss s) {
+    return ss_packed_push_raw_len(list, s->buf, s->len);
+}
+
+/*
+ * Returns the number of pieces stored in the packed list `list`.
+ */
+size_t ss_packed_len(ss_packed list) {
+    return list->n;
+}
+
+/*
+ * Returns the total length of the pieces stored in the packed list `list`, null terminators excluded.
+ */
+size_t ss_packed_bytes(ss_packed list) {
+    return list->data_used - list->n;
+}
+
+/*
+ * Return the view of the piece at position `i` (0-indexed) of the packed list `list`, without copying
+ * it. The viewed bytes are followed by a null terminator, so `ptr` can also be used as a C string. The
+ * view is invalidated by the operations that may move the list buffer (push, reserve and sort). If `i`
+ * is out of range an empty view is returned.
+ *
+ * Returns the view of the piece.
+ */
+ss_view ss_packed_get(ss_packed list, size_t i) {
+    if (i >= list->n) return ss_view_from_raw_len(NULL, 0);
+    size_t start = list->offsets[i];
+    return ss_view_from_raw_len(list->data + start, list->offsets[i + 1] - start - 1);
+}
+
+/*
+ * Call the function `fn` on each piece of the packed list `list`, in order, passing the piece, its
+ * length and the `ctx` pointer. The pieces are null terminated. If `fn` returns a value different from
+ * zero the iteration stops.
+ *
+ * Returns the value returned by the last call to `fn`, or zero if the list is empty.
+ */
+int ss_packed_each(ss_packed list, ss_packed_fn fn, void *ctx) {
+    int ret = 0;
+    for (size_t i = 0; i < list->n && ret == 0; i++) {
+        size_t start = list->offsets[i];
+        ret = fn(list->data + start, list->offsets[i + 1] - start - 1, ctx);
+    }
+    return ret;
+}
+
+/*
+ * Sort the pieces of the packed list `list` in ascending order, comparing their bytes as with
+ * `ss_view_compare`. The pieces are rewritten in sorted order in a new buffer, so that iterating over
+ * the sorted list still reads memory sequentially.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of failure
+ * the list is left untouched.
+ */
+ss_err ss_packed_sort(ss_packed list) {
+    if (list->n < 2) return err_none;
+
+    ss_view *views = ss_malloc(list->alloc, sizeof(ss_view) * list->n);
+    if (views == NULL) {
+        return err_alloc;
+    }
+    char *data = ss_malloc(list->alloc, sizeof(char) * list->data_cap);
+    if (data == NULL) {
+        ss_dealloc(list->alloc, views);
+        return err_alloc;
+    }
+
+    for (size_t i = 0; i < list->n; i++) views[i] = ss_packed_get(list, i);
+    qsort(views, list->n, sizeof(ss_view), compare_views);
+
+    size_t used = 0;
+    for (size_t i = 0; i < list->n; i++) {
+        memcpy(data + used, views[i].ptr, views[i].len);
+        used += views[i].len;
+        data[used++] = END_STRING;
+        list->offsets[i + 1] = used;
+    }
+
+    ss_dealloc(list->alloc, views);
+    ss_dealloc(list->alloc, list->data);
+    list->data = data;
+    return err_none;
+}
+
+/*
+ * Return an array with the views of all the pieces of the packed list `list`, in order, as returned
+ * by `ss_split_raw_views`. The pieces are not copied and the views are invalidated by the operations
+ * that may move the list buffer. The array is allocated with the allocator of the list and it must be
+ * freed after use with `ss_packed_free_views`. If the list is empty the function returns NULL and `n`
+ * is set to zero.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_packed_to_views(ss_packed list, int *n) {
+    *n = 0;
+    if (list->n == 0) return NULL;
+
+    ss_view *views = ss_malloc(list->alloc, sizeof(ss_view) * list->n);
+    if (views == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < list->n; i++) views[i] = ss_packed_get(list, i);
+    *n = (int)list->n;
+    return views;
+}
+
+/*
+ * Deallocate the array of views `views` returned by `ss_packed_to_views` on the packed list `list`,
+ * with the allocator of the list. The list and its pieces are not touched. Passing a NULL `views` is
+ * a no-op.
+ */
+void ss_packed_free_views(ss_packed list, ss_view *views) {
+    ss_dealloc(list->alloc, views);
+}
+
+/*
+ * Remove all the pieces from the packed list `list`. The allocated space is kept, so refilling the
+ * list with pieces of similar size doesn't reallocate.
+ */
+void ss_packed_clear(ss_packed list) {
+    list->n = 0;
+    list->data_used = 0;
+}
+
+/*
+ * Deallocate the packed list `list` and all its pieces. The list and the views of its pieces can't be
+ * used after being freed. Passing NULL is a no-op.
+ */
+void ss_packed_free(ss_packed list) {
+    if (list == NULL) return;
+    ss_dealloc(list->alloc, list->data);
+    ss_dealloc(list->alloc, list->offsets);
+    ss_dealloc(list->alloc, list);
+}
+
+// Make room in the list `list` for `n` more pieces using `data_size` more
+// bytes of data, terminators included. The buffers grow geometrically,
+// at least doubling their capacity.
+static ss_err grow(ss_packed list, size_t n, size_t data_size) {
+    if (list->n + n > list->n_cap || list->offsets == NULL) {
+        size_t cap = list->n_cap * 2;
+        if (cap < list->n + n) cap = list->n + n;
+        if (cap < 8) cap = 8;
+
+        size_t *offsets = ss_realloc(list->alloc, list->offsets, sizeof(size_t) * (cap + 1));
+        if (offsets == NULL) {
+            return err_alloc;
+        }
+        offsets[0] = 0;
+        list->offsets = offsets;
+        list->n_cap = cap;
+    }
+
+    if (list->data_used + data_size > list->data_cap) {
+        size_t cap = list->data_cap * 2;
+        if (cap < list->data_used + data_size) cap = list->data_used + data_size;
+        if (cap < 64) cap = 64;
+
+        char *data = ss_realloc(list->alloc, list->data, sizeof(char) * cap);
+        if (data == NULL) {
+            return err_alloc;
+        }
+        list->data = data;
+        list->data_cap = cap;
+    }
+    return err_none;
+}
+
+static int compare_views(const void *a, const void *b) {
+    return ss_view_compare(*(const ss_view *)a, *(const ss_view *)b);
+}
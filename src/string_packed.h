@@ -0,0 +1,26 @@
+#ifndef SS_STRING_PACKED_H
+#define SS_STRING_PACKED_H
+
+#include "string.h"
+#include "string_view.h"
+
+typedef struct ss_packed *ss_packed;
+typedef int (*ss_packed_fn)(const char *piece, size_t len, void *ctx);
+
+ss_packed ss_packed_new(void);
+ss_packed ss_packed_new_alloc(const ss_allocator *alloc);
+ss_err ss_packed_reserve(ss_packed list, size_t n, size_t bytes);
+ss_err ss_packed_push_raw_len(ss_packed list, const char *s, size_t len);
+ss_err ss_packed_push_raw(ss_packed list, const char *s);
+ss_err ss_packed_push_str(ss_packed list, ss s);
+size_t ss_packed_len(ss_packed list);
+size_t ss_packed_bytes(ss_packed list);
+ss_view ss_packed_get(ss_packed list, size_t i);
+int ss_packed_each(ss_packed list, ss_packed_fn fn, void *ctx);
+ss_err ss_packed_sort(ss_packed list);
+ss_view *ss_packed_to_views(ss_packed list, int *n);
+void ss_packed_free_views(ss_packed list, ss_view *views);
+void ss_packed_clear(ss_packed list);
+void ss_packed_free(ss_packed list);
+
+#endif
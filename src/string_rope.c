@@ -0,0 +1,453 @@
+#include <stdlib.h>
+#include <string.h>
+#include "string.h"
+#include "string_rope.h"
+#include "alloc.h"
+
+// Small pieces are appended to (or prepended to) the first and last
+// leaves up to this size, to avoid a node for each tiny piece.
+#define ROPE_LEAF_MAX 512
+
+// A rope is an implicit treap: nodes are ordered by position and
+// heap ordered by a random priority, which keeps the expected depth
+// logarithmic. Each node holds a chunk of the text in its leaf string
+// and the total size of its subtree.
+typedef struct rope_node {
+    ss leaf;
+    size_t size;
+    unsigned int prio;
+    struct rope_node *left;
+    struct rope_node *right;
+} rope_node;
+
+struct ss_rope {
+    rope_node *root;
+    const ss_allocator *alloc;
+    unsigned int seed;
+};
+
+static rope_node *new_node(ss_rope rope, const char *s, size_t len);
+static void free_nodes(ss_rope rope, rope_node *node);
+static size_t node_size(rope_node *node);
+static void update(rope_node *node);
+static rope_node *merge(rope_node *a, rope_node *b);
+static ss_err split(ss_rope rope, rope_node *node, size_t pos, rope_node **left, rope_node **right);
+static int each_chunk(rope_node *node, ss_rope_chunk_fn fn, void *ctx);
+static void copy_chunks(rope_node *node, char *dst);
+
+/*
+ * Build a new empty rope. A rope stores a big text as a balanced tree of chunks (ss strings), so
+ * that concatenating, prepending, inserting and deleting text cost O(log n) instead of moving or
+ * copying the whole content, as it happens with a single buffer. Ropes are useful to build big
+ * documents by repeated prepends and inserts. The content is joined in a regular ss string only
+ * when it's needed (see `ss_rope_flatten`), while `ss_rope_each_chunk` allows to output the content
+ * without joining it. The rope allocates its memory with the allocator set with `ss_set_allocator`
+ * and it must be freed after use with `ss_rope_free`.
+ *
+ * Returns the new rope or NULL if the allocation fails.
+ */
+ss_rope ss_rope_new(void) {
+    return ss_rope_new_alloc(NULL);
+}
+
+/*
+ * Build a new empty rope exactly like `ss_rope_new`, but allocating all its memory (nodes and chunks)
+ * with the provided `alloc` allocator. If `alloc` is NULL the allocator currently set with
+ * `ss_set_allocator` is used.
+ *
+ * Returns the new rope or NULL if the allocation fails.
+ */
+ss_rope ss_rope_new_alloc(const ss_allocator *alloc) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    ss_rope rope = ss_malloc(alloc, sizeof(struct ss_rope));
+    if (rope == NULL) {
+        return NULL;
+    }
+    rope->root = NULL;
+    rope->alloc = alloc;
+    rope->seed = 2463534242u;
+    return rope;
+}
+
+/*
+ * Returns the length of the text stored in the rope `rope`.
+ */
+size_t ss_rope_len(ss_rope rope) {
+    return node_size(rope->root);
+}
+
+/*
+ * Concatenate the C string `s` of length `len` at the end of the rope `rope`. Short strings are
+ * appended to the last chunk while it's small, otherwise a new chunk is added in O(log n).
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of
+ * failure the rope is left untouched.
+ */
+ss_err ss_rope_concat_raw_len(ss_rope rope, const char *s, size_t len) {
+    if (len == 0) return err_none;
+
+    rope_node *last = rope->root;
+    while (last != NULL && last->right != NULL) last = last->right;
+    if (last != NULL && last->leaf->len + len <= ROPE_LEAF_MAX) {
+        ss_err err = ss_concat_raw_len(last->leaf, s, len);
+        if (err) {
+            return err;
+        }
+        for (rope_node *node = rope->root; node != NULL; node = node->right) node->size += len;
+        return err_none;
+    }
+
+    rope_node *node = new_node(rope, s, len);
+    if (node == NULL) {
+        return err_alloc;
+    }
+    rope->root = merge(rope->root, node);
+    return err_none;
+}
+
+/*
+ * Concatenate the null terminated C string `s` at the end of the rope `rope`. It is a shorthand for
+ * `ss_rope_concat_raw_len(rope, s, strlen(s))`. If `s` is NULL the function is a no-op.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of
+ * failure the rope is left untouched.
+ */
+ss_err ss_rope_concat_raw(ss_rope rope, const char *s) {
+    if (s == NULL) return err_none;
+    return ss_rope_concat_raw_len(rope, s, strlen(s));
+}
+
+/*
+ * Prepend the C string `s` of length `len` at the beginning of the rope `rope`. Short strings are
+ * prepended to the first chunk while it's small, otherwise a new chunk is added in O(log n), without
+ * moving the rest of the text.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of
+ * failure the rope is left untouched.
+ */
+ss_err ss_rope_prepend_raw_len(const char *s, ss_rope rope, size_t len) {
+    if (len == 0) return err_none;
+
+    rope_node *first = rope->root;
+    while (first != NULL && first->left != NULL) first = first->left;
+    if (first != NULL && first->leaf->len + len <= ROPE_LEAF_MAX) {
+        ss_err err = ss_prepend_raw_len(s, first->leaf, len);
+        if (err) {
+            return err;
+        }
+        for (rope_node *node = rope->root; node != NULL; node = node->left) node->size += len;
+        return err_none;
+    }
+
+    rope_node *node = new_node(rope, s, len);
+    if (node == NULL) {
+        return err_alloc;
+    }
+    rope->root = merge(node, rope->root);
+    return err_none;
+}
+
+/*
+ * Prepend the null terminated C string `s` at the beginning of the rope `rope`. It is a shorthand for
+ * `ss_rope_prepend_raw_len(s, rope, strlen(s))`. If `s` is NULL the function is a no-op.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of
+ * failure the rope is left untouched.
+ */
+ss_err ss_rope_prepend_raw(const char *s, ss_rope rope) {
+    if (s == NULL) return err_none;
+    return ss_rope_prepend_raw_len(s, rope, strlen(s));
+}
+
+/*
+ * Insert the C string `s` of length `len` in the rope `rope`, starting at the position `index`
+ * (0-indexed). If `index` is greater than the rope length the string is appended at the end. The
+ * operation costs O(log n), whatever the position.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of
+ * failure the rope is left untouched.
+ */
+ss_err ss_rope_insert_raw_len(ss_rope rope, size_t index, const char *s, size_t len) {
+    if (len == 0) return err_none;
+    if (index >= ss_rope_len(rope)) return ss_rope_concat_raw_len(rope, s, len);
+    if (index == 0) return ss_rope_prepend_raw_len(s, rope, len);
+
+    rope_node *node = new_node(rope, s, len);
+    if (node == NULL) {
+        return err_alloc;
+    }
+
+    rope_node *left, *right;
+    ss_err err = split(rope, rope->root, index, &left, &right);
+    if (err) {
+        free_nodes(rope, node);
+        return err;
+    }
+    rope->root = merge(merge(left, node), right);
+    return err_none;
+}
+
+/*
+ * Delete `len` bytes from the rope `rope`, starting at the position `index` (0-indexed). If the
+ * range goes beyond the end of the rope, the bytes up to the end are deleted. The operation costs
+ * O(log n) plus the release of the deleted chunks.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails (a chunk may be
+ * split in two). In case of failure the rope is left untouched.
+ */
+ss_err ss_rope_delete(ss_rope rope, size_t index, size_t len) {
+    size_t rope_len = ss_rope_len(rope);
+    if (index >= rope_len || len == 0) return err_none;
+    if (len > rope_len - index) len = rope_len - index;
+
+    rope_node *left, *rest, *mid, *right;
+    ss_err err = split(rope, rope->root, index, &left, &rest);
+    if (err) {
+        return err;
+    }
+    err = split(rope, rest, len, &mid, &right);
+    if (err) {
+        rope->root = merge(left, rest);
+        return err;
+    }
+
+    free_nodes(rope, mid);
+    rope->root = merge(left, right);
+    return err_none;
+}
+
+/*
+ * Keep only the text of the rope `rope` between `str_index` (inclusive) and `end_index` (not
+ * inclusive), with the same rules of `ss_slice`: if `str_index` is >= of the rope length or
+ * `end_index` is < of `str_index` no changes are made, while `end_index` is reduced to the rope
+ * length if greater. The operation costs O(log n) plus the release of the deleted chunks.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails. In case of
+ * failure the rope is left untouched.
+ */
+ss_err ss_rope_slice(ss_rope rope, size_t str_index, size_t end_index) {
+    size_t rope_len = ss_rope_len(rope);
+    if (str_index >= rope_len) return err_none;
+    if (end_index < str_index) return err_none;
+    if (end_index > rope_len) end_index = rope_len;
+
+    rope_node *left, *rest, *mid, *right;
+    ss_err err = split(rope, rope->root, str_index, &left, &rest);
+    if (err) {
+        return err;
+    }
+    err = split(rope, rest, end_index - str_index, &mid, &right);
+    if (err) {
+        rope->root = merge(left, rest);
+        return err;
+    }
+
+    free_nodes(rope, left);
+    free_nodes(rope, right);
+    rope->root = mid;
+    return err_none;
+}
+
+/*
+ * Call the function `fn` on each chunk of the rope `rope`, in order, passing the chunk, its length
+ * and the `ctx` pointer. It allows to output the content of the rope (e.g. with `fwrite`) without
+ * joining it in a single buffer. The chunks are not null terminated. If `fn` returns a value different
+ * from zero the iteration stops.
+ *
+ * Returns the value returned by the last call to `fn`, or zero if the rope is empty.
+ */
+int ss_rope_each_chunk(ss_rope rope, ss_rope_chunk_fn fn, void *ctx) {
+    return each_chunk(rope->root, fn, ctx);
+}
+
+/*
+ * Join the content of the rope `rope` in a single chunk and return it as a regular ss string, to use
+ * the content where a contiguous buffer is needed. The rope keeps the joined string as its only chunk,
+ * so the following calls don't copy the content again until the rope is modified. The returned string
+ * belongs to the rope: it must not be modified or freed and it's valid until the next modification of
+ * the rope. Use `ss_rope_to_ss` to get an independent copy.
+ *
+ * Returns the joined string or NULL if the allocation fails.
+ */
+ss ss_rope_flatten(ss_rope rope) {
+    rope_node *root = rope->root;
+    if (root != NULL && root->left == NULL && root->right == NULL) return root->leaf;
+
+    ss flat = ss_new_from_raw_len_free_alloc(rope->alloc, "", 0, node_size(root));
+    if (flat == NULL) {
+        return NULL;
+    }
+    rope_node *node = ss_malloc(rope->alloc, sizeof(rope_node));
+    if (node == NULL) {
+        ss_free(flat);
+        return NULL;
+    }
+
+    copy_chunks(root, flat->buf);
+    flat->len = node_size(root);
+    flat->free = 0;
+    flat->buf[flat->len] = END_STRING;
+    free_nodes(rope, root);
+
+    node->leaf = flat;
+    node->size = flat->len;
+    node->prio = 0;
+    node->left = NULL;
+    node->right = NULL;
+    rope->root = node;
+    return flat;
+}
+
+/*
+ * Build a new ss string with a copy of the content of the rope `rope`. The rope is not modified and
+ * the string must be freed after use with `ss_free`.
+ *
+ * Returns the new string or NULL if the allocation fails.
+ */
+ss ss_rope_to_ss(ss_rope rope) {
+    size_t len = node_size(rope->root);
+    ss s = ss_new_from_raw_len_free_alloc(rope->alloc, "", 0, len);
+    if (s == NULL) {
+        return NULL;
+    }
+    copy_chunks(rope->root, s->buf);
+    s->len = len;
+    s->free = 0;
+    s->buf[len] = END_STRING;
+    return s;
+}
+
+/*
+ * Free the rope `rope` and all its chunks. If `rope` is NULL the function is a no-op.
+ */
+void ss_rope_free(ss_rope rope) {
+    if (rope == NULL) return;
+    free_nodes(rope, rope->root);
+    ss_dealloc(rope->alloc, rope);
+}
+
+static rope_node *new_node(ss_rope rope, const char *s, size_t len) {
+    rope_node *node = ss_malloc(rope->alloc, sizeof(rope_node));
+    if (node == NULL) {
+        return NULL;
+    }
+    node->leaf = ss_new_from_raw_len_free_alloc(rope->alloc, s, len, 0);
+    if (node->leaf == NULL) {
+        ss_dealloc(rope->alloc, node);
+        return NULL;
+    }
+
+    // Xorshift, the priorities only need to be well spread.
+    rope->seed ^= rope->seed << 13;
+    rope->seed ^= rope->seed >> 17;
+    rope->seed ^= rope->seed << 5;
+    node->prio = rope->seed;
+    node->size = len;
+    node->left = NULL;
+    node->right = NULL;
+    return node;
+}
+
+static void free_nodes(ss_rope rope, rope_node *node) {
+    if (node == NULL) return;
+    free_nodes(rope, node->left);
+    free_nodes(rope, node->right);
+    ss_free(node->leaf);
+    ss_dealloc(rope->alloc, node);
+}
+
+static size_t node_size(rope_node *node) {
+    return node == NULL ? 0 : node->size;
+}
+
+static void update(rope_node *node) {
+    node->size = node_size(node->left) + node->leaf->len + node_size(node->right);
+}
+
+// Join two treaps, all the text of `a` comes before the text of `b`.
+static rope_node *merge(rope_node *a, rope_node *b) {
+    if (a == NULL) return b;
+    if (b == NULL) return a;
+    if (a->prio > b->prio) {
+        a->right = merge(a->right, b);
+        update(a);
+        return a;
+    }
+    b->left = merge(a, b->left);
+    update(b);
+    return b;
+}
+
+// Split the treap `node` in `left`, with the first `pos` bytes, and
+// `right`, with the rest. A chunk straddling `pos` is split in two.
+// The only allocation happens before any change, so in case of
+// failure the treap is left untouched.
+static ss_err split(ss_rope rope, rope_node *node, size_t pos, rope_node **left, rope_node **right) {
+    if (node == NULL) {
+        *left = NULL;
+        *right = NULL;
+        return err_none;
+    }
+
+    size_t left_size = node_size(node->left);
+    size_t leaf_len = node->leaf->len;
+    rope_node *l, *r;
+
+    if (pos <= left_size) {
+        ss_err err = split(rope, node->left, pos, &l, &r);
+        if (err) {
+            return err;
+        }
+        node->left = r;
+        update(node);
+        *left = l;
+        *right = node;
+        return err_none;
+    }
+
+    if (pos >= left_size + leaf_len) {
+        ss_err err = split(rope, node->right, pos - left_size - leaf_len, &l, &r);
+        if (err) {
+            return err;
+        }
+        node->right = l;
+        update(node);
+        *left = node;
+        *right = r;
+        return err_none;
+    }
+
+    // The tail of the chunk moves to a new node, which takes the
+    // right subtree and the same priority to keep the heap order.
+    size_t offset = pos - left_size;
+    rope_node *tail = new_node(rope, node->leaf->buf + offset, leaf_len - offset);
+    if (tail == NULL) {
+        return err_alloc;
+    }
+    ss_shrink(node->leaf, offset);
+    tail->prio = node->prio;
+    tail->right = node->right;
+    node->right = NULL;
+    update(node);
+    update(tail);
+    *left = node;
+    *right = tail;
+    return err_none;
+}
+
+static int each_chunk(rope_node *node, ss_rope_chunk_fn fn, void *ctx) {
+    if (node == NULL) return 0;
+    int ret = each_chunk(node->left, fn, ctx);
+    if (ret) return ret;
+    ret = fn(node->leaf->buf, node->leaf->len, ctx);
+    if (ret) return ret;
+    return each_chunk(node->right, fn, ctx);
+}
+
+static void copy_chunks(rope_node *node, char *dst) {
+    if (node == NULL) return;
+    copy_chunks(node->left, dst);
+    dst += node_size(node->left);
+    memcpy(dst, node->leaf->buf, node->leaf->len);
+    copy_chunks(node->right, dst + node->leaf->len);
+}
@@ -0,0 +1,24 @@
+#ifndef SS_STRING_ROPE_H
+#define SS_STRING_ROPE_H
+
+#include "string.h"
+
+typedef struct ss_rope *ss_rope;
+typedef int (*ss_rope_chunk_fn)(const char *chunk, size_t len, void *ctx);
+
+ss_rope ss_rope_new(void);
+ss_rope ss_rope_new_alloc(const ss_allocator *alloc);
+size_t ss_rope_len(ss_rope rope);
+ss_err ss_rope_concat_raw_len(ss_rope rope, const char *s, size_t len);
+ss_err ss_rope_concat_raw(ss_rope rope, const char *s);
+ss_err ss_rope_prepend_raw_len(const char *s, ss_rope rope, size_t len);
+ss_err ss_rope_prepend_raw(const char *s, ss_rope rope);
+ss_err ss_rope_insert_raw_len(ss_rope rope, size_t index, const char *s, size_t len);
+ss_err ss_rope_delete(ss_rope rope, size_t index, size_t len);
+ss_err ss_rope_slice(ss_rope rope, size_t str_index, size_t end_index);
+int ss_rope_each_chunk(ss_rope rope, ss_rope_chunk_fn fn, void *ctx);
+ss ss_rope_flatten(ss_rope rope);
+ss ss_rope_to_ss(ss_rope rope);
+void ss_rope_free(ss_rope rope);
+
+#endif
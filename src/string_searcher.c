@@ -0,0 +1,153 @@
+#include <string.h>
+#include "string.h"
+#include "string_searcher.h"
+#include "alloc.h"
+#include "search.h"
+
+// The needle is copied right after the struct, in the same allocation,
+// and the prepared tables point to the copy.
+struct ss_searcher {
+    ss_needle needle;
+    const ss_allocator *alloc;
+};
+
+/*
+ * Build a searcher of the `len` bytes starting at `needle`, which may contain null bytes. `ss_index`
+ * prepares its needle at each call, while a searcher prepares it once: it computes the Boyer-Moore-
+ * Horspool shift table, picks the two rarest bytes of the needle for the SIMD filter and fills their
+ * vectors, then it can search the same needle in any number of strings and buffers. Searching many
+ * short strings for the same needle, like the lines of a file, saves the preparation at each search.
+ * The needle is copied, so it can be modified or freed afterwards. An empty needle never matches. The
+ * searcher is never modified by the searches, so it can be shared by many threads. It is allocated with
+ * the allocator set with `ss_set_allocator` and it must be freed after use with `ss_searcher_free`.
+ *
+ * Returns the new searcher or NULL if the allocation fails.
+ */
+ss_searcher ss_searcher_new_raw_len(const char *needle, size_t len) {
+    return ss_searcher_new_alloc(NULL, needle, len);
+}
+
+/*
+ * Build a searcher of the null terminated C string `needle` exactly like `ss_searcher_new_raw_len`. It
+ * is a shorthand for `ss_searcher_new_raw_len(needle, strlen(needle))`. A NULL `needle` is an empty
+ * needle, which never matches.
+ *
+ * Returns the new searcher or NULL if the allocation fails.
+ */
+ss_searcher ss_searcher_new_raw(const char *needle) {
+    return ss_searcher_new_alloc(NULL, needle, needle != NULL ? strlen(needle) : 0);
+}
+
+/*
+ * Build a searcher of the content of the ss string `needle` exactly like `ss_searcher_new_raw_len`,
+ * null bytes included. The string `needle` is not modified.
+ *
+ * Returns the new searcher or NULL if the allocation fails.
+ */
+ss_searcher ss_searcher_new_str(ss needle) {
+    return ss_searcher_new_alloc(NULL, needle->buf, needle->len);
+}
+
+/*
+ * Build a searcher of the `len` bytes starting at `needle` exactly like `ss_searcher_new_raw_len`, but
+ * allocating it with the provided `alloc` allocator. If `alloc` is NULL the allocator currently set with
+ * `ss_set_allocator` is used.
+ *
+ * Returns the new searcher or NULL if the allocation fails.
+ */
+ss_searcher ss_searcher_new_alloc(const ss_allocator *alloc, const char *needle, size_t len) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    if (needle == NULL) len = 0;
+
+    ss_searcher searcher = ss_malloc(alloc, sizeof(struct ss_searcher) + len + 1);
+    if (searcher == NULL) {
+        return NULL;
+    }
+    char *copy = (char *)(searcher + 1);
+    if (len != 0) memcpy(copy, needle, len);
+    copy[len] = END_STRING;
+
+    ss_needle_init(&searcher->needle, copy, len);
+    searcher->alloc = alloc;
+    return searcher;
+}
+
+/*
+ * Returns the length of the needle of the searcher `searcher`.
+ */
+size_t ss_searcher_len(ss_searcher searcher) {
+    return searcher->needle.len;
+}
+
+/*
+ * Returns the position (0-indexed) of the first occurrence of the needle of the searcher `searcher` in
+ * the ss string `s`, or -1 if no occurrence is found. The whole string is searched, null bytes included,
+ * as with `ss_index`. The string `s` is not modified.
+ */
+size_t ss_searcher_find(ss_searcher searcher, ss s) {
+    return ss_searcher_find_raw_len(searcher, s->buf, s->len);
+}
+
+/*
+ * Returns the position (0-indexed) of the first occurrence of the needle of the searcher `searcher` in
+ * the ss string `s` starting at or after the position `from`, as with `ss_index_from`. Returns -1 if no
+ * occurrence is found or if `from` is greater than the string length. Passing the position of a match
+ * plus one yields the following, possibly overlapping, match, while passing the position plus the
+ * needle length skips the overlapping ones. The string `s` is not modified.
+ */
+size_t ss_searcher_find_next(ss_searcher searcher, ss s, size_t from) {
+    return ss_searcher_find_next_raw_len(searcher, s->buf, s->len, from);
+}
+
+/*
+ * Returns the number of non-overlapping occurrences of the needle of the searcher `searcher` in the ss
+ * string `s`, counted from its start. For example "aa" occurs twice in "aaaaa". The string `s` is not
+ * modified.
+ */
+size_t ss_searcher_count(ss_searcher searcher, ss s) {
+    return ss_searcher_count_raw_len(searcher, s->buf, s->len);
+}
+
+/*
+ * Returns the position (0-indexed) of the first occurrence of the needle of the searcher `searcher` in
+ * the `len` bytes starting at `s`, or -1 if no occurrence is found. The buffer doesn't need to be null
+ * terminated and it may contain null bytes.
+ */
+size_t ss_searcher_find_raw_len(ss_searcher searcher, const char *s, size_t len) {
+    if (searcher->needle.len == 0 || s == NULL) return -1;
+    return ss_needle_search(&searcher->needle, s, len);
+}
+
+/*
+ * Returns the position (0-indexed) of the first occurrence of the needle of the searcher `searcher` in
+ * the `len` bytes starting at `s`, starting at or after the position `from`, like
+ * `ss_searcher_find_next`. Returns -1 if no occurrence is found or if `from` is greater than `len`.
+ */
+size_t ss_searcher_find_next_raw_len(ss_searcher searcher, const char *s, size_t len, size_t from) {
+    if (from > len) return -1;
+    size_t pos = ss_searcher_find_raw_len(searcher, s != NULL ? s + from : NULL, len - from);
+    return pos != (size_t)-1 ? from + pos : pos;
+}
+
+/*
+ * Returns the number of non-overlapping occurrences of the needle of the searcher `searcher` in the
+ * `len` bytes starting at `s`, like `ss_searcher_count`.
+ */
+size_t ss_searcher_count_raw_len(ss_searcher searcher, const char *s, size_t len) {
+    size_t count = 0;
+    size_t pos = ss_searcher_find_raw_len(searcher, s, len);
+    while (pos != (size_t)-1) {
+        count++;
+        pos = ss_searcher_find_next_raw_len(searcher, s, len, pos + searcher->needle.len);
+    }
+    return count;
+}
+
+/*
+ * Deallocate the searcher `searcher`. The searcher can't be used after being freed. Passing NULL is a
+ * no-op.
+ */
+void ss_searcher_free(ss_searcher searcher) {
+    if (searcher == NULL) return;
+    ss_dealloc(searcher->alloc, searcher);
+}
@@ -0,0 +1,21 @@
+#ifndef SS_STRING_SEARCHER_H
+#define SS_STRING_SEARCHER_H
+
+#include "string.h"
+
+typedef struct ss_searcher *ss_searcher;
+
+ss_searcher ss_searcher_new_raw_len(const char *needle, size_t len);
+ss_searcher ss_searcher_new_raw(const char *needle);
+ss_searcher ss_searcher_new_str(ss needle);
+ss_searcher ss_searcher_new_alloc(const ss_allocator *alloc, const char *needle, size_t len);
+size_t ss_searcher_len(ss_searcher searcher);
+size_t ss_searcher_find(ss_searcher searcher, ss s);
+size_t ss_searcher_find_next(ss_searcher searcher, ss s, size_t from);
+size_t ss_searcher_count(ss_searcher searcher, ss s);
+size_t ss_searcher_find_raw_len(ss_searcher searcher, const char *s, size_t len);
+size_t ss_searcher_find_next_raw_len(ss_searcher searcher, const char *s, size_t len, size_t from);
+size_t ss_searcher_count_raw_len(ss_searcher searcher, const char *s, size_t len);
+void ss_searcher_free(ss_searcher searcher);
+
+#endif
@@ -1,10 +1,75 @@
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
+#include <pthread.h>
 #include "string.h"
 #include "string_split.h"
+#include "string_intern.h"
 #include "alloc.h"
+#include "charset.h"
 
-static ss *concat_to_ss_list(ss *ss_list, int *ss_list_n, ss str);
+// Upper bound of the threads copying a sized join.
+#define JOIN_MAX_THREADS 16
+
+// Kinds of the arrays of pieces joined by the sized join functions.
+typedef enum join_kind {
+    join_raw,
+    join_str,
+    join_packed
+} join_kind;
+
+// The pieces to join: `n` C strings, ss strings or packed pieces.
+typedef struct join_src {
+    join_kind kind;
+    const char **raw;
+    ss *str;
+    ss_packed packed;
+    size_t n;
+} join_src;
+
+// A part of a sized join, the pieces from `from` (inclusive) to `to`
+// (exclusive), copied at position `offset` of the buffer `dst`.
+typedef struct join_part {
+    const join_src *src;
+    const char *sep;
+    size_t sep_len;
+    size_t from;
+    size_t to;
+    size_t offset;
+    char *dst;
+} join_part;
+
+// Iterator on the pieces of a charset split.
+typedef struct any_iter {
+    const ss_charset *set;
+    const char *str;
+    size_t len;
+    size_t pos;
+    ss_split_mode mode;
+} any_iter;
+
+static size_t join_threshold = 4 << 20;
+static int join_threads = 4;
+
+static ss *split_raw(const ss_allocator *alloc, int intern, const char *s, const char *del, int *n);
+static ss *split_pieces(const ss_allocator *alloc, int intern, ss_split_iter *it, int *n);
+static ss new_piece(const ss_allocator *alloc, int intern, const char *str, size_t len);
+static ss *concat_to_ss_list(const ss_allocator *alloc, ss *str_list, int *str_list_n, ss str);
+static ss_view *split_views(const ss_allocator *alloc, ss_view v, const char *del, int *n);
+static ss_err split_list(ss_list list, ss_view v, const char *del);
+static ss_err push_pieces(ss_list list, ss_split_iter *it);
+static ss_packed split_packed(ss_view v, const char *del);
+static void any_iter_init(any_iter *it, const ss_charset *set, ss_view v, ss_split_mode mode);
+static int any_iter_next(any_iter *it, ss_view *piece);
+static int any_into(const ss_charset *set, ss_view v, ss_split_mode mode, ss_view *out, int cap);
+static ss *split_any(const ss_allocator *alloc, ss_view v, const char *chars, ss_split_mode mode, int *n);
+static ss_view *split_any_views(const ss_allocator *alloc, ss_view v, const char *chars, ss_split_mode mode, int *n);
+static ss_view piece_at(const join_src *src, size_t i);
+static size_t plan_join(const join_src *src, const char *sep, join_part *parts, int *n_parts);
+static void *copy_part(void *arg);
+static void copy_parts(char *dst, join_part *parts, int n_parts);
+static ss_err join_sized_cat(ss s, const join_src *src, const char *sep);
+static ss join_sized(const ss_allocator *alloc, const join_src *src, const char *sep);
 
 /*
  * Return all the ss substrings generated from splitting the C string `s` with the delimiter string `del`.
@@ -19,75 +84,96 @@ static ss *concat_to_ss_list(ss *ss_list, int *ss_list_n, ss str);
  * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
  */
 ss *ss_split_raw(const char *s, const char *del, int *n) {
-    const int empty_del = strcmp(del, "") == 0;
-    const char *curr_ptr = s;
-    ss *ss_list = NULL;
-    *n = 0;
+    return ss_split_raw_alloc(NULL, s, del, n);
+}
 
-    while (1) {
-        char *match_start = strstr(curr_ptr, del);
-        if (match_start == NULL || empty_del) {
-            // No more matches or empty delimiter.
-
-            // If the curr_ptr points to the end of the string len
-            // is equal to 0. No strings returned and we are done.
-            size_t len = strlen(curr_ptr);
-            if (len == 0) {
-                return ss_list;
-            }
-
-            ss str = ss_new_from_raw_len_free(curr_ptr, len, len);
-            if (str == NULL) {
-                ss_list_free(ss_list, *n);
-                *n = 0;
-                return NULL;
-            }
-            ss_list = concat_to_ss_list(ss_list, n, str);
-            return ss_list;
-        }
+/*
+ * Split the C string `s` with the delimiter string `del` exactly like `ss_split_raw`, but allocating
+ * the returned array and all the substrings with the provided `alloc` allocator. If `alloc` is NULL
+ * the allocator currently set with `ss_set_allocator` is used. The array must be freed after use with
+ * `ss_list_free_alloc`, passing the same `alloc`.
+ *
+ * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss *ss_split_raw_alloc(const ss_allocator *alloc, const char *s, const char *del, int *n) {
+    if (alloc == NULL) alloc = ss_get_allocator();
+    return split_raw(alloc, 0, s, del, n);
+}
 
-        size_t len = match_start - curr_ptr;
-        if (len == 0) {
-            // Consecutive delimiters, avoid returning empty
-            // strings, update the pointer and loop again.
-            curr_ptr = match_start + strlen(del);
-            continue;
-        }
+/*
+ * Split the C string `s` with the delimiter string `del` exactly like `ss_split_raw`, but returning
+ * interned strings (see `ss_intern_raw_len`): each piece is the canonical string of its content, so
+ * repeated tokens share the same memory and they can be compared by pointer. The array must be freed
+ * after use with `ss_list_free`, which frees the array and leaves the interned strings in the table.
+ *
+ * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss *ss_split_raw_intern(const char *s, const char *del, int *n) {
+    return split_raw(ss_get_allocator(), 1, s, del, n);
+}
 
-        ss str = ss_new_from_raw_len_free(curr_ptr, len, len);
+// Split the C string `s` with the delimiter `del`, allocating the array
+// with `alloc`. Pieces are interned if `intern` is not zero, otherwise
+// they are new strings allocated with `alloc`.
+static ss *split_raw(const ss_allocator *alloc, int intern, const char *s, const char *del, int *n) {
+    ss_split_iter it;
+    ss_split_iter_init_raw(&it, s, del);
+    return split_pieces(alloc, intern, &it, n);
+}
+
+// Collect the pieces of the iterator `it` into an array allocated with
+// `alloc`, as new or interned strings like split_raw.
+static ss *split_pieces(const ss_allocator *alloc, int intern, ss_split_iter *it, int *n) {
+    ss_view piece;
+    ss *str_list = NULL;
+    *n = 0;
+
+    while (ss_split_iter_next(it, &piece)) {
+        ss str = new_piece(alloc, intern, piece.ptr, piece.len);
         if (str == NULL) {
-            ss_list_free(ss_list, *n);
+            ss_list_free_alloc(alloc, str_list, *n);
             *n = 0;
             return NULL;
         }
-        ss_list = concat_to_ss_list(ss_list, n, str);
-        if (ss_list == NULL) {
+        str_list = concat_to_ss_list(alloc, str_list, n, str);
+        if (str_list == NULL) {
             return NULL;
         }
-
-        // Update the pointer to point to the first
-        // char after the matched delimiter.
-        curr_ptr = match_start + strlen(del);
     }
+    return str_list;
+}
+
+// Build the piece `str` of length `len`, reserving `len` bytes of free
+// space. As in ss_new_from_raw_len, a piece that fits the inline array
+// takes the space left there instead of moving to the heap.
+static ss new_piece(const ss_allocator *alloc, int intern, const char *str, size_t len) {
+    if (intern) return ss_intern_raw_len(str, len);
+    size_t avail = len;
+    if (len + 1 <= SS_INLINE_CAP && len + avail + 1 > SS_INLINE_CAP) avail = SS_INLINE_CAP - len - 1;
+    return ss_new_from_raw_len_free_alloc(alloc, str, len, avail);
 }
 
 // Concatenate a string to a string array and updates the length (passed as a pointer).
-// Automatically handles memory allocation, specifically enlarges the array with steps
-// of 10. If an error happens the memory is automatically freed.
-static ss *concat_to_ss_list(ss *ss_list, int *ss_list_n, ss str) {
-    if (*ss_list_n % 10 == 0) {
-        ss *new_str_list = ss_realloc(ss_list, sizeof(ss) * (*ss_list_n + 10));
+// Automatically handles memory allocation with the `alloc` allocator, specifically enlarges
+// the array geometrically: its capacity, not stored, is the smallest power of two (at least
+// 8) not below the length, so the array doubles when the length reaches one of them. If an
+// error happens the memory is automatically freed.
+static ss *concat_to_ss_list(const ss_allocator *alloc, ss *str_list, int *str_list_n, ss str) {
+    int n = *str_list_n;
+    if (n == 0 || (n >= 8 && (n & (n - 1)) == 0)) {
+        ss *new_str_list = ss_realloc(alloc, str_list, sizeof(ss) * (n == 0 ? 8 : n * 2));
         if (new_str_list == NULL) {
-            ss_list_free(ss_list, *ss_list_n);
-            *ss_list_n = 0;
+            ss_free(str);
+            ss_list_free_alloc(alloc, str_list, n);
+            *str_list_n = 0;
             return NULL;
         }
-        ss_list = new_str_list;
+        str_list = new_str_list;
     }
 
-    ss_list[*ss_list_n] = str;
-    (*ss_list_n)++;
-    return ss_list;
+    str_list[n] = str;
+    (*str_list_n)++;
+    return str_list;
 }
 
 /*
@@ -103,7 +189,534 @@ static ss *concat_to_ss_list(ss *ss_list, int *ss_list_n, ss str) {
  * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
  */
 ss *ss_split_str(ss s, const char *del, int *n) {
-    return ss_split_raw(s->buf, del, n);
+    return ss_split_raw_alloc(NULL, s->buf, del, n);
+}
+
+/*
+ * Split the ss string `s` with the delimiter string `del` exactly like `ss_split_str`, but allocating
+ * the returned array and all the substrings with the provided `alloc` allocator. If `alloc` is NULL
+ * the allocator currently set with `ss_set_allocator` is used. The array must be freed after use with
+ * `ss_list_free_alloc`, passing the same `alloc`. The `s` string is not modified.
+ *
+ * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss *ss_split_str_alloc(const ss_allocator *alloc, ss s, const char *del, int *n) {
+    return ss_split_raw_alloc(alloc, s->buf, del, n);
+}
+
+/*
+ * Split the C string `s` with the delimiter string `del` like `ss_split_raw`, but without copying the
+ * pieces: each piece is returned as a view (see `ss_view`) pointing into `s`, so the only allocation
+ * is the returned array, which is sized exactly after counting the pieces. The offset of a piece in
+ * the original string is `piece.ptr - s`. The views are valid as long as `s` is valid and unmodified.
+ * Empty pieces are skipped and an empty delimiter returns the whole string, as in `ss_split_raw`. The
+ * array is allocated with the allocator set with `ss_set_allocator` and it must be freed after use
+ * with `ss_view_list_free`, before a different allocator is set. If no piece is found the function
+ * returns NULL and `n` is set to zero.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_split_raw_views(const char *s, const char *del, int *n) {
+    return split_views(NULL, ss_view_from_raw(s), del, n);
+}
+
+/*
+ * Split the C string `s` with the delimiter string `del` exactly like `ss_split_raw_views`, but
+ * allocating the array of views with the provided `alloc` allocator. Arrays of views don't remember
+ * their allocator, so the array must be freed after use with `ss_view_list_free_alloc`, passing the
+ * same `alloc`. If `alloc` is NULL the allocator currently set with `ss_set_allocator` is used.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_split_raw_views_alloc(const ss_allocator *alloc, const char *s, const char *del, int *n) {
+    return split_views(alloc, ss_view_from_raw(s), del, n);
+}
+
+/*
+ * Split the ss string `s` with the delimiter string `del` exactly like `ss_split_raw_views`, returning
+ * views pointing into the buffer of `s`. The whole string is split, null bytes included, and the views
+ * are invalidated by any operation that may move or modify the buffer of `s`. The array must be freed
+ * after use with `ss_view_list_free`. The string `s` is not modified.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_split_str_views(ss s, const char *del, int *n) {
+    return split_views(NULL, ss_view_from_str(s), del, n);
+}
+
+/*
+ * Split the ss string `s` with the delimiter string `del` exactly like `ss_split_str_views`, but
+ * allocating the array of views with the provided `alloc` allocator. The array must be freed after use
+ * with `ss_view_list_free_alloc`, passing the same `alloc`. If `alloc` is NULL the allocator currently
+ * set with `ss_set_allocator` is used.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_split_str_views_alloc(const ss_allocator *alloc, ss s, const char *del, int *n) {
+    return split_views(alloc, ss_view_from_str(s), del, n);
+}
+
+/*
+ * Split the view `v` with the delimiter string `del` like `ss_split_raw_views`, writing the pieces to
+ * the caller provided array `out` of `cap` elements instead of allocating one. Only the first `cap`
+ * pieces are written, while the returned count includes all the pieces, so a return value greater than
+ * `cap` means that the array was too small (as with `snprintf`). Passing a NULL `out` and a zero `cap`
+ * just counts the pieces. The function never allocates, which makes it suitable for splitting into a
+ * stack array on hot paths.
+ *
+ * Returns the number of pieces of the view.
+ */
+int ss_split_views_into(ss_view v, const char *del, ss_view *out, int cap) {
+    ss_split_iter it;
+    ss_view piece;
+    int n = 0;
+
+    ss_split_iter_init_raw_len(&it, v.ptr, v.len, del);
+    while (ss_split_iter_next(&it, &piece)) {
+        if (n < cap) out[n] = piece;
+        n++;
+    }
+    return n;
+}
+
+/*
+ * Split the C string `s` with the delimiter string `del` like `ss_split_raw`, but storing the pieces in
+ * a packed list (see `ss_packed_new`): all the pieces are copied back to back in a single buffer, sized
+ * once from the length of `s`, plus an array of offsets. The list must be freed after use with
+ * `ss_packed_free`.
+ *
+ * Returns the list of the pieces in case of success or NULL in case of allocation failures.
+ */
+ss_packed ss_split_raw_packed(const char *s, const char *del) {
+    return split_packed(ss_view_from_raw(s), del);
+}
+
+/*
+ * Split the ss string `s` with the delimiter string `del` exactly like `ss_split_raw_packed`, storing
+ * the pieces in a packed list. The whole string is split, null bytes included. The list must be freed
+ * after use with `ss_packed_free`. The string `s` is not modified.
+ *
+ * Returns the list of the pieces in case of success or NULL in case of allocation failures.
+ */
+ss_packed ss_split_str_packed(ss s, const char *del) {
+    return split_packed(ss_view_from_str(s), del);
+}
+
+/*
+ * Split the C string `s` with the delimiter string `del` like `ss_split_raw`, appending the pieces to the
+ * string list `list` (see `ss_list_new`) instead of returning a new array. The pieces are new strings
+ * without free space, allocated with the allocator of the list. Clearing and refilling the same list,
+ * e.g. to split one line at a time, reuses its array without reallocating it. In case of failure the
+ * list is restored to its previous length.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails.
+ */
+ss_err ss_split_raw_list(ss_list list, const char *s, const char *del) {
+    return split_list(list, ss_view_from_raw(s), del);
+}
+
+/*
+ * Split the ss string `s` with the delimiter string `del` exactly like `ss_split_raw_list`, appending
+ * the pieces to the string list `list`. The whole string is split, null bytes included. The string `s`
+ * is not modified.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails.
+ */
+ss_err ss_split_str_list(ss_list list, ss s, const char *del) {
+    return split_list(list, ss_view_from_str(s), del);
+}
+
+/*
+ * Split the C string `s` like `ss_split_raw`, using as delimiter the needle of the searcher `del` (see
+ * `ss_searcher_new_raw_len`). The searcher prepares the delimiter once, so splitting many strings on the
+ * same delimiter, like the lines of a file, doesn't prepare it again for each string. The pieces are the
+ * same of `ss_split_raw`, and a searcher of an empty needle returns only the original string. The array
+ * of strings must be freed after use with the dedicated `ss_list_free` function.
+ *
+ * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss *ss_split_raw_searcher(const char *s, ss_searcher del, int *n) {
+    ss_split_iter it;
+    ss_split_iter_init_searcher(&it, s, s != NULL ? strlen(s) : 0, del);
+    return split_pieces(ss_get_allocator(), 0, &it, n);
+}
+
+/*
+ * Split the ss string `s` using as delimiter the needle of the searcher `del`, exactly like
+ * `ss_split_raw_searcher`. The whole string is split, null bytes included. The array of strings must be
+ * freed after use with the dedicated `ss_list_free` function. The `s` string is not modified.
+ *
+ * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss *ss_split_str_searcher(ss s, ss_searcher del, int *n) {
+    ss_split_iter it;
+    ss_split_iter_init_searcher(&it, s->buf, s->len, del);
+    return split_pieces(ss_get_allocator(), 0, &it, n);
+}
+
+/*
+ * Split the ss string `s` using as delimiter the needle of the searcher `del` like
+ * `ss_split_str_searcher`, appending the pieces to the string list `list` as in `ss_split_str_list`.
+ * Reusing both the list and the searcher, a loop splitting one line at a time stops allocating after
+ * the first lines, besides the pieces. In case of failure the list is restored to its previous length.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails.
+ */
+ss_err ss_split_str_searcher_list(ss_list list, ss s, ss_searcher del) {
+    ss_split_iter it;
+    ss_split_iter_init_searcher(&it, s->buf, s->len, del);
+    return push_pieces(list, &it);
+}
+
+/*
+ * Initialize the split iterator `it` to split the `len` bytes starting at `s` with the delimiter string
+ * `del`. Unlike the split functions, which build the whole list of pieces up front, the iterator finds
+ * the pieces lazily, one for each call to `ss_split_iter_next`, so the caller can stop after the first
+ * fields without scanning the rest of the buffer, and it doesn't allocate any memory. The pieces are
+ * the same of `ss_split_raw`: consecutive delimiters and delimiters at the ends of the buffer don't
+ * produce empty pieces, while an empty (or NULL) delimiter produces the whole buffer as a single piece.
+ * The iterator keeps pointers to `s` and `del`, which must stay valid and unmodified while it's used.
+ */
+void ss_split_iter_init_raw_len(ss_split_iter *it, const char *s, size_t len, const char *del) {
+    it->str = s != NULL ? s : "";
+    it->len = s != NULL ? len : 0;
+    it->del = del != NULL ? del : "";
+    it->searcher = NULL;
+    it->pos = 0;
+}
+
+/*
+ * Initialize the split iterator `it` to split the null terminated C string `s` with the delimiter
+ * string `del`. It is a shorthand for `ss_split_iter_init_raw_len(it, s, strlen(s), del)`.
+ */
+void ss_split_iter_init_raw(ss_split_iter *it, const char *s, const char *del) {
+    ss_split_iter_init_raw_len(it, s, s != NULL ? strlen(s) : 0, del);
+}
+
+/*
+ * Initialize the split iterator `it` to split the ss string `s` with the delimiter string `del`. The
+ * whole string is split, null bytes included. The string must not be modified while the iterator is
+ * used.
+ */
+void ss_split_iter_init_str(ss_split_iter *it, ss s, const char *del) {
+    ss_split_iter_init_raw_len(it, s->buf, s->len, del);
+}
+
+/*
+ * Initialize the split iterator `it` to split the `len` bytes starting at `s` using as delimiter the
+ * needle of the searcher `del` (see `ss_searcher_new_raw_len`), which is prepared only once for all the
+ * pieces. The pieces are the same of `ss_split_iter_init_raw_len`. The iterator keeps pointers to `s`
+ * and `del`, which must stay valid and unmodified while it's used.
+ */
+void ss_split_iter_init_searcher(ss_split_iter *it, const char *s, size_t len, ss_searcher del) {
+    ss_split_iter_init_raw_len(it, s, len, NULL);
+    it->searcher = del;
+}
+
+/*
+ * Advance the split iterator `it` to the next piece and set `piece` to the view of it (see `ss_view`),
+ * pointing into the split buffer. Empty pieces are skipped. When the buffer is exhausted `piece` is set
+ * to an empty view and the function keeps returning zero until the iterator is reset.
+ *
+ * Returns 1 if a piece was found, 0 at the end of the buffer.
+ */
+int ss_split_iter_next(ss_split_iter *it, ss_view *piece) {
+    while (it->pos < it->len) {
+        if (it->searcher != NULL) {
+            size_t end = ss_searcher_find_next_raw_len(it->searcher, it->str, it->len, it->pos);
+            if (end == (size_t)-1) end = it->len;
+            *piece = ss_view_from_raw_len(it->str + it->pos, end - it->pos);
+            it->pos = end < it->len ? end + ss_searcher_len(it->searcher) : it->len;
+            if (piece->len != 0) return 1;
+            continue;
+        }
+
+        ss_view rest = ss_view_from_raw_len(it->str + it->pos, it->len - it->pos);
+        ss_view_cut(rest, it->del, piece, &rest);
+        it->pos = rest.ptr - it->str;
+        if (piece->len != 0) return 1;
+    }
+
+    *piece = ss_view_from_raw_len(it->str + it->len, 0);
+    return 0;
+}
+
+/*
+ * Rewind the split iterator `it` to the beginning of its buffer, so that the following calls to
+ * `ss_split_iter_next` yield again all the pieces.
+ */
+void ss_split_iter_reset(ss_split_iter *it) {
+    it->pos = 0;
+}
+
+// Split the view `v` with the delimiter `del`, appending the pieces
+// to the list `list`. In case of failure the pushed pieces are freed.
+static ss_err split_list(ss_list list, ss_view v, const char *del) {
+    ss_split_iter it;
+    ss_split_iter_init_raw_len(&it, v.ptr, v.len, del);
+    return push_pieces(list, &it);
+}
+
+// Append the pieces of the iterator `it` to the list `list`. In case of
+// failure the pushed pieces are freed.
+static ss_err push_pieces(ss_list list, ss_split_iter *it) {
+    size_t len = list->len;
+    ss_view piece;
+
+    while (ss_split_iter_next(it, &piece)) {
+        ss_err err = ss_list_push_raw_len(list, piece.ptr, piece.len);
+        if (err) {
+            while (list->len > len) ss_free(ss_list_pop(list));
+            return err;
+        }
+    }
+    return err_none;
+}
+
+// Split the view `v` with the delimiter `del` into a packed list. The
+// pieces and their terminators never take more than the view length
+// plus one bytes, since every piece but the last one is followed by a
+// delimiter, so the data buffer is allocated only once.
+static ss_packed split_packed(ss_view v, const char *del) {
+    ss_packed list = ss_packed_new();
+    if (list == NULL) {
+        return NULL;
+    }
+    if (ss_packed_reserve(list, 0, v.len + 1)) {
+        ss_packed_free(list);
+        return NULL;
+    }
+
+    ss_split_iter it;
+    ss_view piece;
+    ss_split_iter_init_raw_len(&it, v.ptr, v.len, del);
+    while (ss_split_iter_next(&it, &piece)) {
+        if (ss_packed_push_raw_len(list, piece.ptr, piece.len)) {
+            ss_packed_free(list);
+            return NULL;
+        }
+    }
+    return list;
+}
+
+// Split the view `v` with the delimiter `del` into an array of views
+// allocated with `alloc`, counting the pieces first to allocate the
+// array only once.
+static ss_view *split_views(const ss_allocator *alloc, ss_view v, const char *del, int *n) {
+    *n = 0;
+    int count = ss_split_views_into(v, del, NULL, 0);
+    if (count == 0) {
+        return NULL;
+    }
+
+    ss_view *list = ss_malloc(alloc, sizeof(ss_view) * count);
+    if (list == NULL) {
+        return NULL;
+    }
+    *n = ss_split_views_into(v, del, list, count);
+    return list;
+}
+
+/*
+ * Return all the ss substrings generated from splitting the C string `s` on any of the bytes of the
+ * string `chars` (e.g. " \t\n" for whitespace or ",;|" for several separators), instead of a delimiter
+ * string as `ss_split_raw`. The delimiters are looked for in blocks of 16 or 32 bytes with SIMD
+ * instructions when the CPU supports them and `chars` has at most 16 distinct bytes, otherwise with
+ * a lookup table. With the `split_collapse` mode consecutive delimiters are treated as a single one and
+ * delimiters at the ends of `s` produce no empty strings, as in `ss_split_raw`. With the
+ * `split_keep_empty` mode every delimiter ends a field, so empty fields are returned as empty strings
+ * and `k` delimiters always produce `k + 1` strings. An empty `s` produces no strings in both modes,
+ * while an empty (or NULL) `chars` returns only the original string. The array of strings must be
+ * freed after use with the dedicated `ss_list_free` function.
+ *
+ * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss *ss_split_raw_any(const char *s, const char *chars, ss_split_mode mode, int *n) {
+    return split_any(ss_get_allocator(), ss_view_from_raw(s), chars, mode, n);
+}
+
+/*
+ * Split the ss string `s` on any of the bytes of the string `chars` exactly like `ss_split_raw_any`.
+ * The whole string is split, null bytes included. The array of strings must be freed after use with the
+ * dedicated `ss_list_free` function. The `s` string is not modified.
+ *
+ * Returns an array of strings of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss *ss_split_str_any(ss s, const char *chars, ss_split_mode mode, int *n) {
+    return split_any(ss_get_allocator(), ss_view_from_str(s), chars, mode, n);
+}
+
+/*
+ * Split the C string `s` on any of the bytes of the string `chars` like `ss_split_raw_any`, but without
+ * copying the pieces: each piece is returned as a view pointing into `s`, as in `ss_split_raw_views`.
+ * The array must be freed after use with `ss_view_list_free`. If no piece is found the function returns
+ * NULL and `n` is set to zero.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_split_raw_any_views(const char *s, const char *chars, ss_split_mode mode, int *n) {
+    return split_any_views(NULL, ss_view_from_raw(s), chars, mode, n);
+}
+
+/*
+ * Split the C string `s` on any of the bytes of the string `chars` exactly like
+ * `ss_split_raw_any_views`, but allocating the array of views with the provided `alloc` allocator. The
+ * array must be freed after use with `ss_view_list_free_alloc`, passing the same `alloc`. If `alloc` is
+ * NULL the allocator currently set with `ss_set_allocator` is used.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_split_raw_any_views_alloc(const ss_allocator *alloc, const char *s, const char *chars, ss_split_mode mode, int *n) {
+    return split_any_views(alloc, ss_view_from_raw(s), chars, mode, n);
+}
+
+/*
+ * Split the ss string `s` on any of the bytes of the string `chars` exactly like
+ * `ss_split_raw_any_views`, returning views pointing into the buffer of `s`. The whole string is split,
+ * null bytes included. The array must be freed after use with `ss_view_list_free`. The string `s` is
+ * not modified.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_split_str_any_views(ss s, const char *chars, ss_split_mode mode, int *n) {
+    return split_any_views(NULL, ss_view_from_str(s), chars, mode, n);
+}
+
+/*
+ * Split the ss string `s` on any of the bytes of the string `chars` exactly like
+ * `ss_split_str_any_views`, but allocating the array of views with the provided `alloc` allocator. The
+ * array must be freed after use with `ss_view_list_free_alloc`, passing the same `alloc`. If `alloc` is
+ * NULL the allocator currently set with `ss_set_allocator` is used.
+ *
+ * Returns an array of views of length `n` in case of success or NULL in case of allocation failures.
+ */
+ss_view *ss_split_str_any_views_alloc(const ss_allocator *alloc, ss s, const char *chars, ss_split_mode mode, int *n) {
+    return split_any_views(alloc, ss_view_from_str(s), chars, mode, n);
+}
+
+/*
+ * Split the view `v` on any of the bytes of the string `chars` like `ss_split_raw_any_views`, writing
+ * the pieces to the caller provided array `out` of `cap` elements, as in `ss_split_views_into`. Only
+ * the first `cap` pieces are written, while the returned count includes all the pieces. Passing a NULL
+ * `out` and a zero `cap` just counts the pieces. The function never allocates.
+ *
+ * Returns the number of pieces of the view.
+ */
+int ss_split_any_into(ss_view v, const char *chars, ss_split_mode mode, ss_view *out, int cap) {
+    ss_charset set;
+    ss_charset_init(&set, chars);
+    return any_into(&set, v, mode, out, cap);
+}
+
+/*
+ * Split the ss string `s` on any of the bytes of the string `chars` like `ss_split_str_any`, appending
+ * the pieces to the string list `list` (see `ss_list_new`), as in `ss_split_str_list`. The pieces are
+ * new strings without free space, allocated with the allocator of the list. In case of failure the list
+ * is restored to its previous length.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any allocation fails.
+ */
+ss_err ss_split_str_any_list(ss_list list, ss s, const char *chars, ss_split_mode mode) {
+    size_t len = list->len;
+    ss_charset set;
+    any_iter it;
+    ss_view piece;
+
+    ss_charset_init(&set, chars);
+    any_iter_init(&it, &set, ss_view_from_str(s), mode);
+    while (any_iter_next(&it, &piece)) {
+        ss_err err = ss_list_push_raw_len(list, piece.ptr, piece.len);
+        if (err) {
+            while (list->len > len) ss_free(ss_list_pop(list));
+            return err;
+        }
+    }
+    return err_none;
+}
+
+// Initialize the iterator `it` on the pieces of the view `v` delimited
+// by the bytes of `set`. An empty view has no pieces in both modes, so
+// it starts past its end.
+static void any_iter_init(any_iter *it, const ss_charset *set, ss_view v, ss_split_mode mode) {
+    it->set = set;
+    it->str = v.ptr;
+    it->len = v.len;
+    it->pos = v.len == 0 ? 1 : 0;
+    it->mode = mode;
+}
+
+// Set `piece` to the next piece of the iterator `it`, skipping the empty
+// ones in the split_collapse mode. After the last piece, `pos` is past
+// the end of the view. Returns 1 if a piece was found, 0 at the end.
+static int any_iter_next(any_iter *it, ss_view *piece) {
+    while (it->pos <= it->len) {
+        size_t end = it->pos + ss_charset_find(it->set, it->str + it->pos, it->len - it->pos);
+        *piece = ss_view_from_raw_len(it->str + it->pos, end - it->pos);
+        it->pos = end + 1;
+        if (piece->len != 0 || it->mode == split_keep_empty) return 1;
+    }
+    return 0;
+}
+
+// Write the pieces of the view `v` delimited by the bytes of `set` to
+// `out`, up to `cap` of them, and return the number of pieces.
+static int any_into(const ss_charset *set, ss_view v, ss_split_mode mode, ss_view *out, int cap) {
+    any_iter it;
+    ss_view piece;
+    int n = 0;
+
+    any_iter_init(&it, set, v, mode);
+    while (any_iter_next(&it, &piece)) {
+        if (n < cap) out[n] = piece;
+        n++;
+    }
+    return n;
+}
+
+// Split the view `v` on the bytes of `chars` into an array of new
+// strings allocated with `alloc`.
+static ss *split_any(const ss_allocator *alloc, ss_view v, const char *chars, ss_split_mode mode, int *n) {
+    ss_charset set;
+    any_iter it;
+    ss_view piece;
+    ss *str_list = NULL;
+    *n = 0;
+
+    ss_charset_init(&set, chars);
+    any_iter_init(&it, &set, v, mode);
+    while (any_iter_next(&it, &piece)) {
+        ss str = new_piece(alloc, 0, piece.ptr, piece.len);
+        if (str == NULL) {
+            ss_list_free_alloc(alloc, str_list, *n);
+            *n = 0;
+            return NULL;
+        }
+        str_list = concat_to_ss_list(alloc, str_list, n, str);
+        if (str_list == NULL) {
+            return NULL;
+        }
+    }
+    return str_list;
+}
+
+// Split the view `v` on the bytes of `chars` into an array of views,
+// counting the pieces first to allocate the array only once.
+static ss_view *split_any_views(const ss_allocator *alloc, ss_view v, const char *chars, ss_split_mode mode, int *n) {
+    ss_charset set;
+    ss_charset_init(&set, chars);
+
+    *n = 0;
+    int count = any_into(&set, v, mode, NULL, 0);
+    if (count == 0) {
+        return NULL;
+    }
+
+    ss_view *list = ss_malloc(alloc, sizeof(ss_view) * count);
+    if (list == NULL) {
+        return NULL;
+    }
+    *n = any_into(&set, v, mode, list, count);
+    return list;
 }
 
 /*
@@ -134,7 +747,19 @@ ss_err ss_join_raw_cat(ss s, const char **str, int n, const char *sep) {
  * Returns the joined string in case of success or NULL in case of allocation errors.
  */
 ss ss_join_raw(const char **str, int n, const char *sep) {
-    ss s1 = ss_new_empty();
+    return ss_join_raw_alloc(NULL, str, n, sep);
+}
+
+/*
+ * Join an array of C strings `str` of length `n` exactly like `ss_join_raw`, but allocating the
+ * resulting string with the provided `alloc` allocator. If `alloc` is NULL the allocator currently
+ * set with `ss_set_allocator` is used. The returned string must be freed after use with the provided
+ * `ss_free` function.
+ *
+ * Returns the joined string in case of success or NULL in case of allocation errors.
+ */
+ss ss_join_raw_alloc(const ss_allocator *alloc, const char **str, int n, const char *sep) {
+    ss s1 = ss_new_from_raw_len_free_alloc(alloc, "", 0, 0);
     if (s1 == NULL) return NULL;
 
     ss_err err = ss_join_raw_cat(s1, str, n, sep);
@@ -173,7 +798,19 @@ ss_err ss_join_str_cat(ss s, ss *str, int n, const char *sep) {
  * Returns the joined string in case of success or NULL in case of allocation errors.
  */
 ss ss_join_str(ss *str, int n, const char *sep) {
-    ss s1 = ss_new_empty();
+    return ss_join_str_alloc(NULL, str, n, sep);
+}
+
+/*
+ * Join an array of ss strings `str` of length `n` exactly like `ss_join_str`, but allocating the
+ * resulting string with the provided `alloc` allocator. If `alloc` is NULL the allocator currently
+ * set with `ss_set_allocator` is used. The returned string must be freed after use with the provided
+ * `ss_free` function.
+ *
+ * Returns the joined string in case of success or NULL in case of allocation errors.
+ */
+ss ss_join_str_alloc(const ss_allocator *alloc, ss *str, int n, const char *sep) {
+    ss s1 = ss_new_from_raw_len_free_alloc(alloc, "", 0, 0);
     if (s1 == NULL) return NULL;
 
     ss_err err = ss_join_str_cat(s1, str, n, sep);
@@ -185,11 +822,286 @@ ss ss_join_str(ss *str, int n, const char *sep) {
 }
 
 /*
- * Deallocate the memory used by a ss string array `list`. The string array and all the
- * contained strings can't be used after being freed.
+ * Join an array of C strings `str` of length `n` using the provided string separator `sep` between them,
+ * then concatenate this string to the provided `s` string, like `ss_join_raw_cat`. Instead of one concat
+ * for each string and separator, the size of the result is computed first, `s` is grown at most once to
+ * the exact size needed, and then the strings and the separators are copied straight into its buffer.
+ * Big results (see `ss_set_join_parallel`) are copied by several threads, each one filling its own part
+ * of the buffer. A NULL `sep` is treated as an empty separator. The `s` string is modified in place.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of failure
+ * the `s` string is still valid and must be freed after use.
+ */
+ss_err ss_join_raw_sized_cat(ss s, const char **str, int n, const char *sep) {
+    join_src src = {.kind = join_raw, .raw = str, .n = n > 0 ? n : 0};
+    return join_sized_cat(s, &src, sep);
+}
+
+/*
+ * Join an array of C strings `str` of length `n` using the provided string separator `sep` between
+ * them, exactly like `ss_join_raw_sized_cat`. The resulting (joined) string is returned as a new ss
+ * string, allocated once with the exact size of the result. The returned string must be freed after
+ * use with the provided `ss_free` function.
+ *
+ * Returns the joined string in case of success or NULL in case of allocation errors.
+ */
+ss ss_join_raw_sized(const char **str, int n, const char *sep) {
+    join_src src = {.kind = join_raw, .raw = str, .n = n > 0 ? n : 0};
+    return join_sized(NULL, &src, sep);
+}
+
+/*
+ * Join an array of ss strings `str` of length `n` using the provided string separator `sep` between
+ * them, then concatenate this string to the provided `s` string, computing the size of the result first
+ * and copying the strings straight into the buffer of `s`, exactly like `ss_join_raw_sized_cat`. The `s`
+ * string is modified in place.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of failure
+ * the `s` string is still valid and must be freed after use.
+ */
+ss_err ss_join_str_sized_cat(ss s, ss *str, int n, const char *sep) {
+    join_src src = {.kind = join_str, .str = str, .n = n > 0 ? n : 0};
+    return join_sized_cat(s, &src, sep);
+}
+
+/*
+ * Join an array of ss strings `str` of length `n` using the provided string separator `sep` between
+ * them, exactly like `ss_join_str_sized_cat`. The resulting (joined) string is returned as a new ss
+ * string, allocated once with the exact size of the result. The returned string must be freed after
+ * use with the provided `ss_free` function.
+ *
+ * Returns the joined string in case of success or NULL in case of allocation errors.
+ */
+ss ss_join_str_sized(ss *str, int n, const char *sep) {
+    join_src src = {.kind = join_str, .str = str, .n = n > 0 ? n : 0};
+    return join_sized(NULL, &src, sep);
+}
+
+/*
+ * Join the pieces of the packed list `list` using the provided string separator `sep` between them, then
+ * concatenate this string to the provided `s` string. The size of the result is computed up front, so
+ * `s` is grown at most once, as in `ss_join_raw_sized_cat`. The `s` string is modified in place, while
+ * the list is not modified.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of failure
+ * the `s` string is still valid and must be freed after use.
+ */
+ss_err ss_join_packed_cat(ss s, ss_packed list, const char *sep) {
+    join_src src = {.kind = join_packed, .packed = list, .n = ss_packed_len(list)};
+    return join_sized_cat(s, &src, sep);
+}
+
+/*
+ * Join the pieces of the packed list `list` using the provided string separator `sep` between them. The
+ * resulting (joined) string is returned as a new ss string, allocated once with the exact size of the
+ * result. The returned string must be freed after use with the provided `ss_free` function.
+ *
+ * Returns the joined string in case of success or NULL in case of allocation errors.
+ */
+ss ss_join_packed(ss_packed list, const char *sep) {
+    join_src src = {.kind = join_packed, .packed = list, .n = ss_packed_len(list)};
+    return join_sized(NULL, &src, sep);
+}
+
+/*
+ * Join the strings of the string list `list` using the provided string separator `sep` between them,
+ * then concatenate this string to the provided `s` string. It is a shorthand for `ss_join_str_sized_cat`
+ * on the strings of the list. The `s` string is modified in place, while the list is not modified.
+ *
+ * Returns `err_none` (zero) in case of success or an error if any reallocation fails. In case of failure
+ * the `s` string is still valid and must be freed after use.
+ */
+ss_err ss_join_list_cat(ss s, ss_list list, const char *sep) {
+    join_src src = {.kind = join_str, .str = list->items, .n = list->len};
+    return join_sized_cat(s, &src, sep);
+}
+
+/*
+ * Join the strings of the string list `list` using the provided string separator `sep` between them.
+ * The resulting (joined) string is returned as a new ss string, allocated once with the exact size of
+ * the result with the allocator of the list. The returned string must be freed after use with the
+ * provided `ss_free` function.
+ *
+ * Returns the joined string in case of success or NULL in case of allocation errors.
+ */
+ss ss_join_list(ss_list list, const char *sep) {
+    join_src src = {.kind = join_str, .str = list->items, .n = list->len};
+    return join_sized(list->alloc, &src, sep);
+}
+
+/*
+ * Set when the sized join functions (`ss_join_raw_sized_cat` and the following ones) copy the pieces
+ * with more threads: results of at least `threshold` bytes are split in up to `max_threads` parts, with
+ * about the same number of pieces, copied in parallel. Copying is bound by the memory bandwidth, so it
+ * pays off only for results of several megabytes. Passing `max_threads` <= 1 disables the parallel copy.
+ * The default is 4 threads above 4 MiB. The function is not thread safe and should be called before
+ * joining strings, usually at program startup.
+ */
+void ss_set_join_parallel(size_t threshold, int max_threads) {
+    join_threshold = threshold;
+    join_threads = max_threads < 1 ? 1 : max_threads > JOIN_MAX_THREADS ? JOIN_MAX_THREADS : max_threads;
+}
+
+// Return the piece at position `i` of the pieces to join.
+static ss_view piece_at(const join_src *src, size_t i) {
+    switch (src->kind) {
+        case join_raw:
+            return ss_view_from_raw(src->raw[i]);
+        case join_str:
+            return ss_view_from_str(src->str[i]);
+        case join_packed:
+        default:
+            return ss_packed_get(src->packed, i);
+    }
+}
+
+// Compute the size of the joined pieces of `src` and split them in up to
+// `join_threads` parts of about the same number of pieces, setting the
+// position of each part in the result. Small results get a single part.
+// Returns the size of the result.
+static size_t plan_join(const join_src *src, const char *sep, join_part *parts, int *n_parts) {
+    size_t sep_len = sep != NULL ? strlen(sep) : 0;
+    size_t count = (size_t)join_threads < src->n ? (size_t)join_threads : src->n;
+    if (count == 0) count = 1;
+
+    size_t total = 0;
+    size_t k = 0;
+    for (size_t i = 0; i < src->n; i++) {
+        if (k < count && i == src->n * k / count) {
+            parts[k].from = i;
+            parts[k].offset = total;
+            k++;
+        }
+        if (i != 0) total += sep_len;
+        total += piece_at(src, i).len;
+    }
+
+    for (size_t j = 0; j < count; j++) {
+        parts[j].src = src;
+        parts[j].sep = sep;
+        parts[j].sep_len = sep_len;
+        parts[j].to = j + 1 < count ? parts[j + 1].from : src->n;
+    }
+    if (src->n == 0) parts[0].from = parts[0].offset = 0;
+
+    if (count > 1 && total < join_threshold) {
+        parts[0].to = src->n;
+        count = 1;
+    }
+    *n_parts = (int)count;
+    return total;
+}
+
+// Copy the pieces and the separators of the part `arg` (a join_part)
+// to its position in the buffer `dst` of the part.
+static void *copy_part(void *arg) {
+    join_part *part = arg;
+    char *dst = part->dst + part->offset;
+    for (size_t i = part->from; i < part->to; i++) {
+        if (i != 0 && part->sep_len != 0) {
+            memcpy(dst, part->sep, part->sep_len);
+            dst += part->sep_len;
+        }
+        ss_view piece = piece_at(part->src, i);
+        memcpy(dst, piece.ptr, piece.len);
+        dst += piece.len;
+    }
+    return NULL;
+}
+
+// Copy the planned parts to `dst`, the first one in the calling thread
+// and the others in new threads. Parts whose thread can't be started are
+// copied by the calling thread.
+static void copy_parts(char *dst, join_part *parts, int n_parts) {
+    pthread_t threads[JOIN_MAX_THREADS];
+    int started[JOIN_MAX_THREADS] = {0};
+
+    for (int i = 0; i < n_parts; i++) parts[i].dst = dst;
+    for (int i = 1; i < n_parts; i++) {
+        started[i] = pthread_create(&threads[i], NULL, copy_part, &parts[i]) == 0;
+    }
+    copy_part(&parts[0]);
+    for (int i = 1; i < n_parts; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+        else copy_part(&parts[i]);
+    }
+}
+
+// Join the pieces of `src` with the separator `sep` at the end of `s`,
+// growing it at most once to the exact size of the result.
+static ss_err join_sized_cat(ss s, const join_src *src, const char *sep) {
+    join_part parts[JOIN_MAX_THREADS];
+    int n_parts;
+    size_t total = plan_join(src, sep, parts, &n_parts);
+
+    ss_err err = ss_reserve_free_space(s, total);
+    if (err) {
+        return err;
+    }
+
+    copy_parts(s->buf + s->len, parts, n_parts);
+    s->len += total;
+    s->free -= total;
+    s->buf[s->len] = END_STRING;
+    return err_none;
+}
+
+// Join the pieces of `src` with the separator `sep` in a new string
+// allocated with `alloc`, with the exact size of the result.
+static ss join_sized(const ss_allocator *alloc, const join_src *src, const char *sep) {
+    join_part parts[JOIN_MAX_THREADS];
+    int n_parts;
+    size_t total = plan_join(src, sep, parts, &n_parts);
+
+    ss s = ss_new_from_raw_len_free_alloc(alloc, "", 0, total);
+    if (s == NULL) {
+        return NULL;
+    }
+
+    copy_parts(s->buf, parts, n_parts);
+    s->len = total;
+    s->free = 0;
+    s->buf[total] = END_STRING;
+    return s;
+}
+
+/*
+ * Deallocate the memory used by a ss string array `list`. The strings are freed with their own
+ * allocator, while the array itself is freed with the allocator set with `ss_set_allocator`, the one
+ * used by the split functions without the `_alloc` suffix. Arrays allocated with another allocator,
+ * like the ones of `ss_split_raw_alloc`, must be freed with `ss_list_free_alloc`. The string array and
+ * all the contained strings can't be used after being freed.
  */
 void ss_list_free(ss *list, const int n) {
+    ss_list_free_alloc(NULL, list, n);
+}
+
+/*
+ * Deallocate the memory used by a ss string array `list` like `ss_list_free`, but freeing the array
+ * itself with the `alloc` allocator it was created with. The strings are still freed with their own
+ * allocator. If `alloc` is NULL the allocator currently set with `ss_set_allocator` is used.
+ */
+void ss_list_free_alloc(const ss_allocator *alloc, ss *list, const int n) {
     for (int i = 0; i < n; i++) ss_free(list[i]);
-    free(list);
+    ss_dealloc(alloc, list);
+}
+
+/*
+ * Deallocate the array of views `list` returned by `ss_split_raw_views` and `ss_split_str_views`,
+ * with the allocator set with `ss_set_allocator`. Unlike strings, arrays of views don't remember the
+ * allocator they were created with, so the global allocator must not change while they are alive.
+ * The viewed strings are not touched, since they don't belong to the array. Passing NULL is a no-op.
+ */
+void ss_view_list_free(ss_view *list) {
+    ss_view_list_free_alloc(NULL, list);
+}
+
+/*
+ * Deallocate the array of views `list` returned by `ss_split_raw_views_alloc` and the other `_alloc`
+ * view functions, with the `alloc` allocator the array was created with. If `alloc` is NULL the
+ * allocator currently set with `ss_set_allocator` is used. Passing a NULL `list` is a no-op.
+ */
+void ss_view_list_free_alloc(const ss_allocator *alloc, ss_view *list) {
+    ss_dealloc(alloc, list);
 }
 
@@ -2,12 +2,74 @@
 #ifndef SS_STRING_SPLIT_H
 #define SS_STRING_SPLIT_H
 
+#include "string_view.h"
+#include "string_packed.h"
+#include "string_list.h"
+#include "string_searcher.h"
+
+typedef enum ss_split_mode {
+    split_collapse = 0,
+    split_keep_empty = 1
+} ss_split_mode;
+
+typedef struct ss_split_iter {
+    // Private state, not part of the public API.
+    const char *str;
+    size_t len;
+    const char *del;
+    ss_searcher searcher;
+    size_t pos;
+} ss_split_iter;
+
 ss *ss_split_raw(const char *s, const char  *del, int *n);
+ss *ss_split_raw_alloc(const ss_allocator *alloc, const char *s, const char *del, int *n);
+ss *ss_split_raw_intern(const char *s, const char *del, int *n);
 ss *ss_split_str(ss s, const char  *del, int *n);
+ss *ss_split_str_alloc(const ss_allocator *alloc, ss s, const char *del, int *n);
+ss_view *ss_split_raw_views(const char *s, const char *del, int *n);
+ss_view *ss_split_raw_views_alloc(const ss_allocator *alloc, const char *s, const char *del, int *n);
+ss_view *ss_split_str_views(ss s, const char *del, int *n);
+ss_view *ss_split_str_views_alloc(const ss_allocator *alloc, ss s, const char *del, int *n);
+int ss_split_views_into(ss_view v, const char *del, ss_view *out, int cap);
+ss_packed ss_split_raw_packed(const char *s, const char *del);
+ss_packed ss_split_str_packed(ss s, const char *del);
+ss_err ss_split_raw_list(ss_list list, const char *s, const char *del);
+ss_err ss_split_str_list(ss_list list, ss s, const char *del);
+ss *ss_split_raw_searcher(const char *s, ss_searcher del, int *n);
+ss *ss_split_str_searcher(ss s, ss_searcher del, int *n);
+ss_err ss_split_str_searcher_list(ss_list list, ss s, ss_searcher del);
+ss *ss_split_raw_any(const char *s, const char *chars, ss_split_mode mode, int *n);
+ss *ss_split_str_any(ss s, const char *chars, ss_split_mode mode, int *n);
+ss_view *ss_split_raw_any_views(const char *s, const char *chars, ss_split_mode mode, int *n);
+ss_view *ss_split_raw_any_views_alloc(const ss_allocator *alloc, const char *s, const char *chars, ss_split_mode mode, int *n);
+ss_view *ss_split_str_any_views(ss s, const char *chars, ss_split_mode mode, int *n);
+ss_view *ss_split_str_any_views_alloc(const ss_allocator *alloc, ss s, const char *chars, ss_split_mode mode, int *n);
+int ss_split_any_into(ss_view v, const char *chars, ss_split_mode mode, ss_view *out, int cap);
+ss_err ss_split_str_any_list(ss_list list, ss s, const char *chars, ss_split_mode mode);
+void ss_split_iter_init_raw_len(ss_split_iter *it, const char *s, size_t len, const char *del);
+void ss_split_iter_init_raw(ss_split_iter *it, const char *s, const char *del);
+void ss_split_iter_init_str(ss_split_iter *it, ss s, const char *del);
+void ss_split_iter_init_searcher(ss_split_iter *it, const char *s, size_t len, ss_searcher del);
+int ss_split_iter_next(ss_split_iter *it, ss_view *piece);
+void ss_split_iter_reset(ss_split_iter *it);
 ss_err ss_join_raw_cat(ss s, const char **str, int n, const char *sep);
 ss ss_join_raw(const char **str, int n, const char *sep);
+ss ss_join_raw_alloc(const ss_allocator *alloc, const char **str, int n, const char *sep);
 ss_err ss_join_str_cat(ss s, ss *str, int n, const char *sep);
 ss ss_join_str(ss *str, int n, const char *sep);
+ss ss_join_str_alloc(const ss_allocator *alloc, ss *str, int n, const char *sep);
+ss_err ss_join_raw_sized_cat(ss s, const char **str, int n, const char *sep);
+ss ss_join_raw_sized(const char **str, int n, const char *sep);
+ss_err ss_join_str_sized_cat(ss s, ss *str, int n, const char *sep);
+ss ss_join_str_sized(ss *str, int n, const char *sep);
+ss_err ss_join_packed_cat(ss s, ss_packed list, const char *sep);
+ss ss_join_packed(ss_packed list, const char *sep);
+ss_err ss_join_list_cat(ss s, ss_list list, const char *sep);
+ss ss_join_list(ss_list list, const char *sep);
+void ss_set_join_parallel(size_t threshold, int max_threads);
 void ss_list_free(ss *list, int n);
+void ss_list_free_alloc(const ss_allocator *alloc, ss *list, int n);
+void ss_view_list_free(ss_view *list);
+void ss_view_list_free_alloc(const ss_allocator *alloc, ss_view *list);
 
 #endif
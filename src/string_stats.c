@@ -0,0 +1,139 @@
+#include <stdlib.h>
+#include <string.h>
+#include "options.h"
+#include "string_stats.h"
+#include "stats.h"
+
+#ifdef SS_STATS
+
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Counters of one thread. Only the owner thread writes them, so they
+// are updated without atomic read-modify-write instructions. Other
+// threads only read them when taking a snapshot. The base holds the
+// counters left by the previous owners when the block is reused, it's
+// read and written only by the owner thread.
+typedef struct stats_block {
+    _Atomic long long counters[stat_count];
+    long long base[stat_count];
+    atomic_int in_use;
+    struct stats_block *next;
+} stats_block;
+
+// All the blocks ever created. Blocks are never removed: when a thread
+// exits its block is released and reused by the next new thread, so
+// that the counts of the finished threads still show up in the totals.
+static _Atomic(stats_block *) blocks = NULL;
+static _Thread_local stats_block *local_block = NULL;
+static pthread_key_t block_key;
+static pthread_once_t block_key_once = PTHREAD_ONCE_INIT;
+
+static void release_block(void *block) {
+    atomic_store_explicit(&((stats_block *)block)->in_use, 0, memory_order_release);
+}
+
+static void create_block_key(void) {
+    pthread_key_create(&block_key, release_block);
+}
+
+// Get the block of the calling thread, reusing a released block or
+// creating a new one on the first use.
+static stats_block *thread_block(void) {
+    if (local_block != NULL) return local_block;
+
+    stats_block *block = atomic_load_explicit(&blocks, memory_order_acquire);
+    for (; block != NULL; block = block->next) {
+        int free_block = 0;
+        if (atomic_compare_exchange_strong(&block->in_use, &free_block, 1)) break;
+    }
+    if (block != NULL) {
+        for (int i = 0; i < stat_count; i++) {
+            block->base[i] = atomic_load_explicit(&block->counters[i], memory_order_relaxed);
+        }
+    }
+
+    if (block == NULL) {
+        // The standard allocator is used directly, the library
+        // allocator would count its own allocations.
+        block = calloc(1, sizeof(stats_block));
+        if (block == NULL) return NULL;
+        atomic_init(&block->in_use, 1);
+        block->next = atomic_load_explicit(&blocks, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak(&blocks, &block->next, block));
+    }
+
+    pthread_once(&block_key_once, create_block_key);
+    pthread_setspecific(block_key, block);
+    local_block = block;
+    return block;
+}
+
+void ss_stat_add(ss_stat stat, long long n) {
+    stats_block *block = thread_block();
+    if (block == NULL) return;
+    long long value = atomic_load_explicit(&block->counters[stat], memory_order_relaxed);
+    atomic_store_explicit(&block->counters[stat], value + n, memory_order_relaxed);
+}
+
+static void fill_stats(ss_stats *stats, const long long *counters) {
+    stats->n_malloc = (size_t)counters[stat_n_malloc];
+    stats->malloc_bytes = (size_t)counters[stat_malloc_bytes];
+    stats->n_realloc = (size_t)counters[stat_n_realloc];
+    stats->realloc_bytes = (size_t)counters[stat_realloc_bytes];
+    stats->n_concat_realloc = (size_t)counters[stat_n_concat_realloc];
+    stats->n_prepend_realloc = (size_t)counters[stat_n_prepend_realloc];
+    stats->memmove_bytes = (size_t)counters[stat_memmove_bytes];
+    stats->n_live = counters[stat_n_live];
+}
+
+/*
+ * Fill `stats` with the library statistics aggregated over all the threads, including the threads
+ * already terminated. The statistics count the allocations and reallocations (number of calls and
+ * requested bytes), the reallocations triggered by concatenations and prepends, the bytes moved
+ * inside the string buffers by prepends, slices and trims, and the number of strings currently
+ * alive. The counters are updated by each thread on its own without synchronization, so the
+ * snapshot is a consistent view only when the other threads are not working on strings. The
+ * counters are available only if the library is compiled with the SS_STATS option, otherwise the
+ * function fills `stats` with zeros. Taking the difference of two snapshots allows to measure a
+ * region of code.
+ */
+void ss_stats_get(ss_stats *stats) {
+    long long counters[stat_count] = {0};
+    stats_block *block = atomic_load_explicit(&blocks, memory_order_acquire);
+    for (; block != NULL; block = block->next) {
+        for (int i = 0; i < stat_count; i++) {
+            counters[i] += atomic_load_explicit(&block->counters[i], memory_order_relaxed);
+        }
+    }
+    fill_stats(stats, counters);
+}
+
+/*
+ * Fill `stats` with the library statistics of the calling thread only (see `ss_stats_get` for the
+ * collected statistics), counting only the work done since the thread started. The count of live
+ * strings can be negative if the thread frees strings created by other threads. If the library is not compiled with the SS_STATS option, the function
+ * fills `stats` with zeros.
+ */
+void ss_stats_get_thread(ss_stats *stats) {
+    long long counters[stat_count] = {0};
+    stats_block *block = thread_block();
+    if (block != NULL) {
+        for (int i = 0; i < stat_count; i++) {
+            counters[i] = atomic_load_explicit(&block->counters[i], memory_order_relaxed) - block->base[i];
+        }
+    }
+    fill_stats(stats, counters);
+}
+
+#else
+
+void ss_stats_get(ss_stats *stats) {
+    memset(stats, 0, sizeof(ss_stats));
+}
+
+void ss_stats_get_thread(ss_stats *stats) {
+    memset(stats, 0, sizeof(ss_stats));
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef SS_STRING_STATS_H
+#define SS_STRING_STATS_H
+
+#include <stddef.h>
+
+typedef struct ss_stats {
+    size_t n_malloc;
+    size_t malloc_bytes;
+    size_t n_realloc;
+    size_t realloc_bytes;
+    size_t n_concat_realloc;
+    size_t n_prepend_realloc;
+    size_t memmove_bytes;
+    long long n_live;
+} ss_stats;
+
+void ss_stats_get(ss_stats *stats);
+void ss_stats_get_thread(ss_stats *stats);
+
+#endif
@@ -0,0 +1,184 @@
+#include <string.h>
+#include "string.h"
+#include "string_view.h"
+#include "search.h"
+
+static int in_cutset(const char *cutset, char c);
+
+/*
+ * Build a view of the `len` bytes starting at `s`. A view is a borrowed, read-only window on memory
+ * owned by someone else (a C string, a ss string, a file buffer): it holds only a pointer and a
+ * length, it's passed by value and it's never allocated nor freed. The viewed bytes don't need to be
+ * null terminated and they may contain null bytes. The view is valid as long as the viewed memory
+ * is valid and not modified: views of a ss string are invalidated by any operation that may move
+ * its buffer (concat, prepend, grow, ...). If `s` is NULL an empty view is returned.
+ *
+ * Returns the view of the provided bytes.
+ */
+ss_view ss_view_from_raw_len(const char *s, size_t len) {
+    if (s == NULL) return (ss_view){.ptr = "", .len = 0};
+    return (ss_view){.ptr = s, .len = len};
+}
+
+/*
+ * Build a view of the null terminated C string `s`, without its null terminator. It is a shorthand
+ * for `ss_view_from_raw_len(s, strlen(s))`. If `s` is NULL an empty view is returned.
+ *
+ * Returns the view of the provided C string.
+ */
+ss_view ss_view_from_raw(const char *s) {
+    if (s == NULL) return ss_view_from_raw_len(NULL, 0);
+    return ss_view_from_raw_len(s, strlen(s));
+}
+
+/*
+ * Build a view of the whole content of the ss string `s`. The view is invalidated by any operation
+ * that may move or modify the buffer of `s`. The string `s` is not modified.
+ *
+ * Returns the view of the string content.
+ */
+ss_view ss_view_from_str(ss s) {
+    return ss_view_from_raw_len(s->buf, s->len);
+}
+
+/*
+ * Return the sub-view of the view `v` starting from the position `str_index` (inclusive) and ending
+ * at `end_index` (not inclusive), with the same rules of `ss_slice`: if `str_index` is >= of the view
+ * length or `end_index` is < of `str_index` the view is returned unchanged, while an `end_index` greater
+ * than the view length is reduced to be equal to it. No byte is copied or moved.
+ *
+ * Returns the sliced view.
+ */
+ss_view ss_view_slice(ss_view v, size_t str_index, size_t end_index) {
+    if (str_index >= v.len) return v;
+    if (end_index < str_index) return v;
+    if (end_index > v.len) end_index = v.len;
+    return (ss_view){.ptr = v.ptr + str_index, .len = end_index - str_index};
+}
+
+/*
+ * Returns the position (0-indexed) of the first occurrence of the null terminated string `needle` in
+ * the view `v`. Returns -1 if no occurrence is found or if `needle` is NULL or an empty string. Unlike
+ * `ss_index`, the search is bounded by the view length and it doesn't stop at null bytes.
+ */
+size_t ss_view_index(ss_view v, const char *needle) {
+    if (needle == NULL || *needle == '\0') return -1;
+    return ss_search(v.ptr, v.len, needle, strlen(needle));
+}
+
+/*
+ * Returns the position (0-indexed) of the last occurrence of the null terminated string `needle` in
+ * the view `v`. Returns -1 if no occurrence is found or if `needle` is NULL or an empty string.
+ */
+size_t ss_view_index_last(ss_view v, const char *needle) {
+    if (needle == NULL || *needle == '\0') return -1;
+    return ss_search_last(v.ptr, v.len, needle, strlen(needle));
+}
+
+/*
+ * Compare the bytes of the views `v1` and `v2` lexicographically, as unsigned chars. A view that is
+ * a prefix of the other one sorts first.
+ *
+ * Returns a negative number if `v1` sorts before `v2`, zero if they are equal and a positive number
+ * if `v1` sorts after `v2`.
+ */
+int ss_view_compare(ss_view v1, ss_view v2) {
+    size_t len = v1.len < v2.len ? v1.len : v2.len;
+    int cmp = len != 0 ? memcmp(v1.ptr, v2.ptr, len) : 0;
+    if (cmp != 0) return cmp;
+    if (v1.len == v2.len) return 0;
+    return v1.len < v2.len ? -1 : 1;
+}
+
+/*
+ * Returns 1 if the view `v` has exactly the same content of the null terminated string `s`, 0
+ * otherwise. It's useful to match tokens against keywords. A NULL `s` is equal to an empty view.
+ */
+int ss_view_equal_raw(ss_view v, const char *s) {
+    return ss_view_compare(v, ss_view_from_raw(s)) == 0;
+}
+
+/*
+ * Return the sub-view of the view `v` without the characters contained in the `cutset` string at its
+ * start and at its end. If all the characters are trimmed the result is an empty view.
+ *
+ * Returns the trimmed view.
+ */
+ss_view ss_view_trim(ss_view v, const char *cutset) {
+    return ss_view_trim_right(ss_view_trim_left(v, cutset), cutset);
+}
+
+/*
+ * Return the sub-view of the view `v` without the characters contained in the `cutset` string at
+ * its start. If all the characters are trimmed the result is an empty view.
+ *
+ * Returns the trimmed view.
+ */
+ss_view ss_view_trim_left(ss_view v, const char *cutset) {
+    size_t start = 0;
+    while (start < v.len && in_cutset(cutset, v.ptr[start])) start++;
+    return (ss_view){.ptr = v.ptr + start, .len = v.len - start};
+}
+
+/*
+ * Return the sub-view of the view `v` without the characters contained in the `cutset` string at
+ * its end. If all the characters are trimmed the result is an empty view.
+ *
+ * Returns the trimmed view.
+ */
+ss_view ss_view_trim_right(ss_view v, const char *cutset) {
+    size_t len = v.len;
+    while (len > 0 && in_cutset(cutset, v.ptr[len - 1])) len--;
+    return (ss_view){.ptr = v.ptr, .len = len};
+}
+
+/*
+ * Split the view `v` around the first occurrence of the delimiter string `del`: `before` is set to the
+ * view of the bytes preceding the delimiter and `after` to the view of the bytes following it. If the
+ * delimiter is empty or it doesn't match, `before` is set to the whole view and `after` to an empty
+ * view at its end. Calling the function again on `after` yields the following pieces, which allows to
+ * tokenize a buffer without any allocation. Either `before` or `after` can be NULL.
+ *
+ * Returns 1 if the delimiter was found, 0 otherwise.
+ */
+int ss_view_cut(ss_view v, const char *del, ss_view *before, ss_view *after) {
+    size_t del_len = del != NULL ? strlen(del) : 0;
+    size_t pos = del_len != 0 ? ss_search(v.ptr, v.len, del, del_len) : (size_t)-1;
+    if (pos == (size_t)-1) {
+        if (before != NULL) *before = v;
+        if (after != NULL) *after = (ss_view){.ptr = v.ptr + v.len, .len = 0};
+        return 0;
+    }
+
+    if (before != NULL) *before = (ss_view){.ptr = v.ptr, .len = pos};
+    if (after != NULL) *after = (ss_view){.ptr = v.ptr + pos + del_len, .len = v.len - pos - del_len};
+    return 1;
+}
+
+/*
+ * Build a new ss string copying the content of the view `v`, for when a view must outlive the memory
+ * it points to. The string has no free space, since copies of tokens are rarely modified, and it's
+ * allocated with the allocator set with `ss_set_allocator`. It must be freed after use with `ss_free`.
+ *
+ * Returns the new string or NULL if the allocation fails.
+ */
+ss ss_view_to_ss(ss_view v) {
+    return ss_view_to_ss_alloc(NULL, v);
+}
+
+/*
+ * Build a new ss string copying the content of the view `v` exactly like `ss_view_to_ss`, but
+ * allocating it with the provided `alloc` allocator. If `alloc` is NULL the allocator
+ * currently set with `ss_set_allocator` is used. The string must be freed after use with `ss_free`.
+ *
+ * Returns the new string or NULL if the allocation fails.
+ */
+ss ss_view_to_ss_alloc(const ss_allocator *alloc, ss_view v) {
+    return ss_new_from_raw_len_free_alloc(alloc, v.ptr, v.len, 0);
+}
+
+// Returns 1 if the char `c` is in the `cutset` string. The null
+// terminator of the cutset doesn't count, views may hold null bytes.
+static int in_cutset(const char *cutset, char c) {
+    return c != '\0' && strchr(cutset, c) != NULL;
+}
@@ -0,0 +1,26 @@
+#ifndef SS_STRING_VIEW_H
+#define SS_STRING_VIEW_H
+
+#include "string.h"
+
+typedef struct ss_view {
+    const char *ptr;
+    size_t len;
+} ss_view;
+
+ss_view ss_view_from_raw_len(const char *s, size_t len);
+ss_view ss_view_from_raw(const char *s);
+ss_view ss_view_from_str(ss s);
+ss_view ss_view_slice(ss_view v, size_t str_index, size_t end_index);
+size_t ss_view_index(ss_view v, const char *needle);
+size_t ss_view_index_last(ss_view v, const char *needle);
+int ss_view_compare(ss_view v1, ss_view v2);
+int ss_view_equal_raw(ss_view v, const char *s);
+ss_view ss_view_trim(ss_view v, const char *cutset);
+ss_view ss_view_trim_left(ss_view v, const char *cutset);
+ss_view ss_view_trim_right(ss_view v, const char *cutset);
+int ss_view_cut(ss_view v, const char *del, ss_view *before, ss_view *after);
+ss ss_view_to_ss(ss_view v);
+ss ss_view_to_ss_alloc(const ss_allocator *alloc, ss_view v);
+
+#endif
@@ -2,6 +2,16 @@
 #include "string_err_test.h"
 #include "string_fmt_test.h"
 #include "string_split_test.h"
+#include "string_alloc_test.h"
+#include "string_stats_test.h"
+#include "string_compact_test.h"
+#include "string_intern_test.h"
+#include "string_rope_test.h"
+#include "string_view_test.h"
+#include "string_packed_test.h"
+#include "string_list_test.h"
+#include "string_matcher_test.h"
+#include "string_searcher_test.h"
 #include "framework/framework.h"
 
 int main(void) {
@@ -11,14 +21,22 @@ int main(void) {
     test_ss_new_from_raw();
     test_ss_new_empty_with_free();
     test_ss_new_empty();
+    test_ss_new_on_buf();
     test_ss_clone();
+    test_ss_clone_shared();
     test_ss_set_free_space();
     test_ss_reserve_free_space();
+    test_ss_reserve_front_space();
+    test_ss_set_offset_mode();
+    test_ss_set_growth();
+    test_ss_set_growth_str();
     test_ss_grow();
     test_ss_shrink();
     test_ss_clear();
     test_ss_index();
     test_ss_index_last();
+    test_ss_index_from();
+    test_ss_index_last_before();
     test_ss_concat_raw_len();
     test_ss_concat_raw();
     test_ss_concat_str();
@@ -44,10 +62,113 @@ int main(void) {
     // string_split.c
     test_ss_split_raw();
     test_ss_split_str();
+    test_ss_split_raw_views();
+    test_ss_split_str_views();
+    test_ss_split_views_into();
+    test_ss_split_raw_packed();
+    test_ss_split_raw_list();
+    test_ss_split_iter();
+    test_ss_split_raw_any();
+    test_ss_split_any_views();
     test_ss_join_raw_cat();
     test_ss_join_raw();
     test_ss_join_str_cat();
     test_ss_join_str();
+    test_ss_join_list();
+    test_ss_join_packed();
+    test_ss_join_sized();
+
+    // string_alloc.c
+    test_ss_set_allocator();
+    test_ss_get_allocator();
+    test_ss_new_from_raw_len_free_alloc();
+    test_ss_split_raw_alloc();
+    test_ss_split_raw_views_alloc();
+    test_ss_packed_new_alloc();
+    test_ss_join_raw_alloc();
+    test_ss_sprintf_alloc();
+    test_ss_compact_new_from_raw_len_free_alloc();
+    test_ss_set_mmap_threshold();
+    test_ss_set_mmap_huge_pages();
+    test_ss_arena_new();
+    test_ss_arena_allocator();
+    test_ss_arena_reset();
+    test_ss_arena_free();
+
+    // string_compact.c
+    test_ss_compact_new_from_raw_len_free();
+    test_ss_compact_new_from_raw();
+    test_ss_compact_from_ss();
+    test_ss_compact_to_ss();
+    test_ss_compact_set_free_space();
+    test_ss_compact_grow();
+    test_ss_compact_concat_raw_len();
+    test_ss_compact_free();
+
+    // string_intern.c
+    test_ss_intern_raw_len();
+    test_ss_intern_str();
+    test_ss_intern_get_stats();
+    test_ss_intern_reset();
+    test_ss_split_raw_intern();
+
+    // string_rope.c
+    test_ss_rope_new();
+    test_ss_rope_concat_raw_len();
+    test_ss_rope_prepend_raw_len();
+    test_ss_rope_insert_raw_len();
+    test_ss_rope_delete();
+    test_ss_rope_slice();
+    test_ss_rope_each_chunk();
+    test_ss_rope_flatten();
+    test_ss_rope_to_ss();
+
+    // string_view.c
+    test_ss_view_from_raw_len();
+    test_ss_view_from_str();
+    test_ss_view_slice();
+    test_ss_view_index();
+    test_ss_view_index_last();
+    test_ss_view_compare();
+    test_ss_view_trim();
+    test_ss_view_cut();
+    test_ss_view_to_ss();
+
+    // string_packed.c
+    test_ss_packed_new();
+    test_ss_packed_reserve();
+    test_ss_packed_push_raw_len();
+    test_ss_packed_get();
+    test_ss_packed_each();
+    test_ss_packed_sort();
+    test_ss_packed_to_views();
+    test_ss_packed_clear();
+
+    // string_list.c
+    test_ss_list_new();
+    test_ss_list_reserve();
+    test_ss_list_push();
+    test_ss_list_push_raw_len();
+    test_ss_list_pop();
+    test_ss_list_clear();
+
+    // string_searcher.c
+    test_ss_searcher_new();
+    test_ss_searcher_find();
+    test_ss_searcher_find_next();
+    test_ss_searcher_count();
+    test_ss_split_raw_searcher();
+
+    // string_matcher.c
+    test_ss_matcher_new();
+    test_ss_matcher_new_list();
+    test_ss_matcher_find();
+    test_ss_matcher_each();
+    test_ss_matcher_count();
+
+    // string_stats.c
+    test_ss_stats_get();
+    test_ss_stats_get_thread();
 
     return test_report();
 }
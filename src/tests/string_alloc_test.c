@@ -0,0 +1,427 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "../string.h"
+#include "../string_fmt.h"
+#include "../string_split.h"
+#include "../string_view.h"
+#include "../string_packed.h"
+#include "../string_alloc.h"
+#include "../string_compact.h"
+#include "framework/framework.h"
+#include "string_alloc_test.h"
+
+// Allocator counting the live allocations in its context, used
+// to check that all the memory goes through the allocator and
+// that every allocated block is also freed.
+typedef struct counting_ctx {
+    int n_malloc;
+    int n_realloc;
+    int n_live;
+} counting_ctx;
+
+static void *counting_malloc(void *ctx, size_t size);
+static void *counting_realloc(void *ctx, void *ptr, size_t size);
+static void counting_free(void *ctx, void *ptr);
+
+static ss_allocator new_counting_allocator(counting_ctx *ctx) {
+    *ctx = (counting_ctx){0};
+    return (ss_allocator){
+        .malloc = counting_malloc,
+        .realloc = counting_realloc,
+        .free = counting_free,
+        .ctx = ctx
+    };
+}
+
+void test_ss_set_allocator(void) {
+    test_group("ss_set_allocator");
+
+    test_subgroup("custom global allocator");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    ss_set_allocator(&alloc);
+    ss s = ss_new_from_raw("ehy, how are you doing?");
+    test_cond("should have allocated with the global allocator", ctx.n_malloc > 0);
+    int n_alloc = ctx.n_malloc + ctx.n_realloc;
+    ss_concat_raw(s, " I'm fine, thanks! What about you?");
+    test_cond("should have grown with the global allocator", ctx.n_malloc + ctx.n_realloc > n_alloc);
+    test_strings("should have correct string", "ehy, how are you doing? I'm fine, thanks! What about you?", s->buf);
+
+    test_subgroup("compact strings");
+    n_alloc = ctx.n_malloc + ctx.n_realloc;
+    ss_compact c = ss_compact_new_from_raw("ehy, how are you doing?");
+    ss_compact_concat_raw(&c, " I'm fine, thanks! What about you?");
+    test_equal("should allocate and grow with the global allocator", n_alloc + 2, ctx.n_malloc + ctx.n_realloc);
+
+    test_subgroup("restore default allocator");
+    ss_set_allocator(NULL);
+    int n_malloc = ctx.n_malloc;
+    ss s2 = ss_new_from_raw("ehy, how are you doing?");
+    test_equal("shouldn't use the previous allocator", n_malloc, ctx.n_malloc);
+    ss_free(s2);
+
+    test_subgroup("strings keep their allocator");
+    ss_free(s);
+    ss_compact_free_alloc(&alloc, c);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+}
+
+void test_ss_get_allocator(void) {
+    test_group("ss_get_allocator");
+
+    test_subgroup("default allocator");
+    const ss_allocator *def = ss_get_allocator();
+    test_cond("should return an allocator", def != NULL && def->malloc != NULL);
+
+    test_subgroup("custom allocator");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    ss_set_allocator(&alloc);
+    test_cond("should return the custom allocator", ss_get_allocator() == &alloc);
+    ss_set_allocator(NULL);
+    test_cond("should return the default allocator", ss_get_allocator() == def);
+}
+
+void test_ss_new_from_raw_len_free_alloc(void) {
+    test_group("ss_new_from_raw_len_free_alloc");
+
+    test_subgroup("small string");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    ss s = ss_new_from_raw_len_free_alloc(&alloc, "testing", 7, 0);
+    test_equal("should have correct len", 7, s->len);
+    test_equal("should have correct free", 0, s->free);
+    test_strings("should have correct string", "testing", s->buf);
+    test_equal("should allocate only the struct", 1, ctx.n_live);
+    ss_free(s);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+
+    test_subgroup("growth and clone");
+    s = ss_new_from_raw_len_free_alloc(&alloc, "testing", 7, 20);
+    ss_concat_raw(s, ", testing the custom allocator");
+    int n_malloc = ctx.n_malloc;
+    ss s2 = ss_clone(s);
+    test_strings("should have correct string", "testing, testing the custom allocator", s->buf);
+    test_strings("should have cloned string", s->buf, s2->buf);
+    test_cond("should allocate the clone with the allocator", ctx.n_malloc > n_malloc);
+    ss_free(s);
+    ss_free(s2);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+
+    test_subgroup("NULL allocator");
+    s = ss_new_from_raw_len_free_alloc(NULL, "testing", 7, 7);
+    test_strings("should have correct string", "testing", s->buf);
+    ss_free(s);
+}
+
+void test_ss_split_raw_alloc(void) {
+    test_group("ss_split_raw_alloc");
+
+    test_subgroup("split in words");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    int n = 0;
+    ss *strings = ss_split_raw_alloc(&alloc, "Ehy how are you?", " ", &n);
+    test_equal("should have correct number of strings", 4, n);
+    test_strings("should have correct first string", "Ehy", strings[0]->buf);
+    test_strings("should have correct last string", "you?", strings[3]->buf);
+    test_equal("should allocate strings and list", 5, ctx.n_live);
+    ss_list_free_alloc(&alloc, strings, n);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+
+    test_subgroup("split ss string");
+    ss s = ss_new_from_raw("Ehy how are you?");
+    strings = ss_split_str_alloc(&alloc, s, " ", &n);
+    test_equal("should have correct number of strings", 4, n);
+    test_equal("should allocate strings and list", 5, ctx.n_live);
+    ss_list_free_alloc(&alloc, strings, n);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+    ss_free(s);
+
+    test_subgroup("list of strings with mixed allocators");
+    strings = malloc(2 * sizeof(ss));
+    strings[0] = ss_new_from_raw_len_free_alloc(&alloc, "Ehy", 3, 0);
+    strings[1] = ss_new_from_raw("how are you?");
+    ss_list_free(strings, 2);
+    test_equal("should free each string with its allocator", 0, ctx.n_live);
+}
+
+void test_ss_split_raw_views_alloc(void) {
+    test_group("ss_split_raw_views_alloc");
+
+    test_subgroup("split in words");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    int n = 0;
+    ss_view *views = ss_split_raw_views_alloc(&alloc, "Ehy how are you?", " ", &n);
+    test_equal("should have correct number of views", 4, n);
+    test_cond("should have correct last view", ss_view_equal_raw(views[3], "you?"));
+    test_equal("should allocate the array with the allocator", 1, ctx.n_live);
+    ss_view_list_free_alloc(&alloc, views);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+
+    test_subgroup("split on any byte");
+    ss s = ss_new_from_raw("Ehy how,are you?");
+    views = ss_split_str_any_views_alloc(&alloc, s, " ,", split_collapse, &n);
+    test_equal("should have correct number of views", 4, n);
+    test_equal("should allocate the array with the allocator", 1, ctx.n_live);
+    ss_view_list_free_alloc(&alloc, views);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+    ss_free(s);
+}
+
+void test_ss_packed_new_alloc(void) {
+    test_group("ss_packed_new_alloc");
+
+    test_subgroup("list and views");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    ss_packed list = ss_packed_new_alloc(&alloc);
+    ss_packed_push_raw(list, "ehy");
+    ss_packed_push_raw(list, "how are you?");
+    int n_live = ctx.n_live;
+    test_cond("should allocate the list with the allocator", n_live > 0);
+    int n = 0;
+    ss_view *views = ss_packed_to_views(list, &n);
+    test_equal("should have all the pieces", 2, n);
+    test_equal("should allocate the views with the allocator", n_live + 1, ctx.n_live);
+
+    test_subgroup("free the views");
+    ss_packed_free_views(list, views);
+    test_equal("should free the views with the allocator of the list", n_live, ctx.n_live);
+    ss_packed_free(list);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+}
+
+void test_ss_join_raw_alloc(void) {
+    test_group("ss_join_raw_alloc");
+
+    test_subgroup("join C strings");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    ss s = ss_join_raw_alloc(&alloc, (const char **)(char *[]){"how", "are", "you?" }, 3, "___");
+    test_strings("should have joined strings", "how___are___you?", s->buf);
+    test_cond("should allocate with the allocator", ctx.n_live > 0);
+    ss_free(s);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+
+    test_subgroup("join ss strings");
+    ss s1 = ss_new_from_raw("how");
+    ss s2 = ss_new_from_raw("are");
+    s = ss_join_str_alloc(&alloc, (ss []){s1, s2}, 2, " ");
+    test_strings("should have joined strings", "how are", s->buf);
+    test_cond("should allocate with the allocator", ctx.n_live > 0);
+    ss_free(s);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+    ss_free(s1);
+    ss_free(s2);
+}
+
+void test_ss_sprintf_alloc(void) {
+    test_group("ss_sprintf_alloc");
+
+    test_subgroup("formatting with arguments");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    ss s = ss_sprintf_alloc(&alloc, "test=%d test=%s", 123, "success");
+    test_strings("should have formatted string", "test=123 test=success", s->buf);
+    test_equal("should keep only the string allocated", 2, ctx.n_live);
+    ss_free(s);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+}
+
+void test_ss_compact_new_from_raw_len_free_alloc(void) {
+    test_group("ss_compact_new_from_raw_len_free_alloc");
+
+    test_subgroup("create, grow and free");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    ss_compact c = ss_compact_new_from_raw_len_free_alloc(&alloc, "testing", 7, 0);
+    test_strings("should have correct string", "testing", c);
+    test_equal("should allocate with the allocator", 1, ctx.n_live);
+    ss_compact_concat_raw_len_alloc(&alloc, &c, ", testing the custom allocator", 30);
+    ss_compact_grow_alloc(&alloc, &c, 300);
+    test_equal("should have correct len", 300, ss_compact_len(c));
+    test_cond("should keep the content", memcmp(c, "testing, testing the custom allocator", 37) == 0);
+    ss_compact_set_free_space_alloc(&alloc, &c, 0);
+    test_equal("should reallocate with the allocator", 3, ctx.n_realloc);
+    ss_compact_free_alloc(&alloc, c);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+
+    test_subgroup("NULL allocator");
+    c = ss_compact_new_from_raw_len_free_alloc(NULL, "testing", 7, 7);
+    test_strings("should have correct string", "testing", c);
+    ss_compact_free_alloc(NULL, c);
+}
+
+void test_ss_set_mmap_threshold(void) {
+    test_group("ss_set_mmap_threshold");
+
+    test_subgroup("big string growth");
+    ss_set_mmap_threshold(8192);
+    ss s = ss_new_from_raw("ehy, how are you doing?");
+    for (int i = 0; i < 1000; i++) ss_concat_raw(s, "0123456789");
+    test_cond("should have page aligned buffer", ((uintptr_t)s->buf & 4095) == 0);
+    test_cond("should have correct length", s->len == 10023);
+    test_cond("should keep the string prefix", memcmp(s->buf, "ehy, how are you doing?", 23) == 0);
+    test_cond("should keep the string suffix", memcmp(s->buf + s->len - 10, "0123456789", 11) == 0);
+
+    test_subgroup("shrink of big string");
+    ss_shrink(s, 5000);
+    ss_concat_raw(s, "!");
+    test_cond("should have correct length", s->len == 5001);
+    test_cond("should have correct string end", memcmp(s->buf + 4999, "6!", 3) == 0);
+    ss_clear(s);
+    test_strings("should clear the string", "", s->buf);
+    ss_free(s);
+
+    test_subgroup("big new string");
+    s = ss_new_from_raw_len_free("ehy", 3, 10000);
+    test_cond("should have page aligned buffer", ((uintptr_t)s->buf & 4095) == 0);
+    test_strings("should have correct string", "ehy", s->buf);
+    ss_free(s);
+
+    test_subgroup("custom allocator");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    s = ss_new_from_raw_len_free_alloc(&alloc, "ehy", 3, 10000);
+    test_cond("should use the custom allocator", ctx.n_malloc >= 1 && ctx.n_live >= 1);
+    ss_free(s);
+    test_cond("should free the memory", ctx.n_live == 0);
+
+    ss_set_mmap_threshold(0);
+}
+
+void test_ss_set_mmap_huge_pages(void) {
+    test_group("ss_set_mmap_huge_pages");
+
+    test_subgroup("big string growth");
+    ss_set_mmap_threshold(8192);
+    ss_set_mmap_huge_pages(1);
+    ss s = ss_new_from_raw("");
+    for (int i = 0; i < 100000; i++) ss_concat_raw(s, "0123456789");
+    test_cond("should have correct length", s->len == 1000000);
+    test_cond("should have correct string end", memcmp(s->buf + s->len - 10, "0123456789", 11) == 0);
+    ss_free(s);
+    ss_set_mmap_huge_pages(0);
+    ss_set_mmap_threshold(0);
+}
+
+void test_ss_arena_new(void) {
+    test_group("ss_arena_new");
+
+    test_subgroup("arena from the global allocator");
+    counting_ctx ctx;
+    ss_allocator alloc = new_counting_allocator(&ctx);
+    ss_set_allocator(&alloc);
+    ss_arena arena = ss_arena_new(1024);
+    ss_set_allocator(NULL);
+    test_cond("should create the arena", arena != NULL);
+    test_equal("should allocate the arena with the global allocator", 1, ctx.n_live);
+
+    test_subgroup("chunks from the global allocator");
+    ss s = ss_new_from_raw_len_free_alloc(ss_arena_allocator(arena), "testing", 7, 7);
+    test_strings("should have correct string", "testing", s->buf);
+    test_equal("should allocate one chunk", 2, ctx.n_live);
+    ss_arena_free(arena);
+    test_equal("should have freed all the memory", 0, ctx.n_live);
+}
+
+void test_ss_arena_allocator(void) {
+    test_group("ss_arena_allocator");
+
+    test_subgroup("strings from the arena");
+    ss_arena arena = ss_arena_new(0);
+    const ss_allocator *alloc = ss_arena_allocator(arena);
+    ss s = ss_new_from_raw_len_free_alloc(alloc, "ehy, how are you doing?", 23, 23);
+    test_strings("should have correct string", "ehy, how are you doing?", s->buf);
+    test_equal("should have correct len", 23, s->len);
+    test_equal("should have correct free", 23, s->free);
+
+    test_subgroup("in place growth of the last block");
+    ss_concat_raw(s, " I'm fine, thanks! What about you?");
+    char *buf = s->buf;
+    ss_grow(s, 200);
+    test_equal("should have grown len", 200, s->len);
+    test_strings("should keep the content", "ehy, how are you doing? I'm fine, thanks! What about you?", s->buf);
+    test_cond("should have grown the buffer in place", s->buf == buf);
+
+    test_subgroup("split, join and format");
+    int n = 0;
+    ss *strings = ss_split_raw_alloc(alloc, "Ehy how are you?", " ", &n);
+    ss joined = ss_join_str_alloc(alloc, strings, n, "_");
+    ss formatted = ss_sprintf_alloc(alloc, "%s=%d", joined->buf, 42);
+    test_equal("should have split strings", 4, n);
+    test_strings("should have joined strings", "Ehy_how_are_you?", joined->buf);
+    test_strings("should have formatted string", "Ehy_how_are_you?=42", formatted->buf);
+
+    test_subgroup("growth beyond the chunk size");
+    ss big = ss_new_from_raw_len_free_alloc(alloc, "", 0, 0);
+    for (int i = 0; i < 10000; i++) ss_concat_raw(big, "0123456789");
+    test_equal("should have correct len", 100000, big->len);
+    test_cond("should have correct content", big->buf[99999] == '9' && big->buf[100000] == END_STRING);
+    ss_arena_free(arena);
+}
+
+void test_ss_arena_reset(void) {
+    test_group("ss_arena_reset");
+
+    test_subgroup("memory reuse");
+    ss_arena arena = ss_arena_new(0);
+    const ss_allocator *alloc = ss_arena_allocator(arena);
+    ss s = ss_new_from_raw_len_free_alloc(alloc, "ehy, how are you doing?", 23, 23);
+    ss_arena_reset(arena);
+    ss s2 = ss_new_from_raw_len_free_alloc(alloc, "I'm fine, thanks!", 17, 17);
+    test_cond("should reuse the arena memory", s == s2);
+    test_strings("should have correct string", "I'm fine, thanks!", s2->buf);
+
+    test_subgroup("reuse of multiple chunks");
+    for (int i = 0; i < 100; i++) ss_new_from_raw_len_free_alloc(alloc, "", 0, 4096);
+    ss_arena_reset(arena);
+    for (int i = 0; i < 100; i++) {
+        ss tmp = ss_new_from_raw_len_free_alloc(alloc, "testing", 7, 4096);
+        if (i == 0) test_cond("should restart from the first chunk", tmp == s);
+    }
+    ss_arena_reset(arena);
+    ss_arena_free(arena);
+}
+
+void test_ss_arena_free(void) {
+    test_group("ss_arena_free");
+
+    test_subgroup("NULL arena");
+    ss_arena_free(NULL);
+    test_success("should be a no-op");
+
+    test_subgroup("strings freed on their own");
+    ss_arena arena = ss_arena_new(0);
+    const ss_allocator *alloc = ss_arena_allocator(arena);
+    ss s = ss_new_from_raw_len_free_alloc(alloc, "ehy, how are you doing?", 23, 23);
+    ss s2 = ss_new_from_raw_len_free_alloc(alloc, "I'm fine, thanks!", 17, 17);
+    ss_free(s);
+    ss_free(s2);
+    ss s3 = ss_new_from_raw_len_free_alloc(alloc, "I'm fine, thanks!", 17, 17);
+    test_strings("should have correct string", "I'm fine, thanks!", s3->buf);
+    ss_arena_free(arena);
+}
+
+static void *counting_malloc(void *ctx, size_t size) {
+    counting_ctx *c = ctx;
+    c->n_malloc++;
+    c->n_live++;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *ctx, void *ptr, size_t size) {
+    counting_ctx *c = ctx;
+    c->n_realloc++;
+    if (ptr == NULL) c->n_live++;
+    return realloc(ptr, size);
+}
+
+static void counting_free(void *ctx, void *ptr) {
+    counting_ctx *c = ctx;
+    c->n_live--;
+    free(ptr);
+}
@@ -0,0 +1,21 @@
+
+#ifndef SS_TESTS_STRING_ALLOC_TEST_H
+#define SS_TESTS_STRING_ALLOC_TEST_H
+
+void test_ss_set_allocator(void);
+void test_ss_get_allocator(void);
+void test_ss_new_from_raw_len_free_alloc(void);
+void test_ss_split_raw_alloc(void);
+void test_ss_split_raw_views_alloc(void);
+void test_ss_packed_new_alloc(void);
+void test_ss_join_raw_alloc(void);
+void test_ss_sprintf_alloc(void);
+void test_ss_compact_new_from_raw_len_free_alloc(void);
+void test_ss_set_mmap_threshold(void);
+void test_ss_set_mmap_huge_pages(void);
+void test_ss_arena_new(void);
+void test_ss_arena_allocator(void);
+void test_ss_arena_reset(void);
+void test_ss_arena_free(void);
+
+#endif
@@ -0,0 +1,136 @@
+#include <string.h>
+#include "../string.h"
+#include "../string_compact.h"
+#include "framework/framework.h"
+#include "string_compact_test.h"
+
+void test_ss_compact_new_from_raw_len_free(void) {
+    test_group("ss_compact_new_from_raw_len_free");
+
+    test_subgroup("short string");
+    ss_compact s = ss_compact_new_from_raw_len_free("ehy, how are you doing?", 23, 10);
+    test_strings("should have correct string", "ehy, how are you doing?", s);
+    test_cond("should have correct length", ss_compact_len(s) == 23);
+    test_cond("should have correct free space", ss_compact_free_space(s) == 10);
+    test_cond("should have 8 bits header", ss_compact_header_size(s) == 3);
+    ss_compact_free(s);
+
+    test_subgroup("wider headers");
+    s = ss_compact_new_from_raw_len_free("ehy", 3, 300);
+    test_cond("should have 16 bits header", ss_compact_header_size(s) == 5);
+    test_cond("should have correct free space", ss_compact_free_space(s) == 300);
+    ss_compact_free(s);
+    s = ss_compact_new_from_raw_len_free("ehy", 3, 70000);
+    test_cond("should have 32 bits header", ss_compact_header_size(s) == 9);
+    test_cond("should have correct free space", ss_compact_free_space(s) == 70000);
+    ss_compact_free(s);
+
+    test_subgroup("NULL init string");
+    s = ss_compact_new_from_raw_len_free(NULL, 10, 10);
+    test_strings("should be empty", "", s);
+    test_cond("should have zero length", ss_compact_len(s) == 0);
+    ss_compact_free(s);
+}
+
+void test_ss_compact_new_from_raw(void) {
+    test_group("ss_compact_new_from_raw");
+
+    test_subgroup("exact allocation");
+    ss_compact s = ss_compact_new_from_raw("ehy, how are you doing?");
+    test_strings("should have correct string", "ehy, how are you doing?", s);
+    test_cond("should have correct length", ss_compact_len(s) == 23);
+    test_cond("should have no free space", ss_compact_free_space(s) == 0);
+    ss_compact_free(s);
+}
+
+void test_ss_compact_from_ss(void) {
+    test_group("ss_compact_from_ss");
+
+    test_subgroup("copy of ss string");
+    ss str = ss_new_from_raw("ehy, how are you doing?");
+    ss_compact s = ss_compact_from_ss(str);
+    test_strings("should have correct string", "ehy, how are you doing?", s);
+    test_cond("should have correct length", ss_compact_len(s) == 23);
+    ss_free(str);
+    ss_compact_free(s);
+}
+
+void test_ss_compact_to_ss(void) {
+    test_group("ss_compact_to_ss");
+
+    test_subgroup("copy of compact string");
+    ss_compact s = ss_compact_new_from_raw("ehy, how are you doing?");
+    ss str = ss_compact_to_ss(s);
+    test_strings("should have correct string", "ehy, how are you doing?", str->buf);
+    test_cond("should have correct length", str->len == 23);
+    ss_free(str);
+    ss_compact_free(s);
+}
+
+void test_ss_compact_set_free_space(void) {
+    test_group("ss_compact_set_free_space");
+
+    test_subgroup("header promotion");
+    ss_compact s = ss_compact_new_from_raw("ehy, how are you doing?");
+    ss_compact_set_free_space(&s, 1000);
+    test_strings("should keep the string", "ehy, how are you doing?", s);
+    test_cond("should have correct free space", ss_compact_free_space(s) == 1000);
+    test_cond("should have 16 bits header", ss_compact_header_size(s) == 5);
+
+    test_subgroup("header demotion");
+    ss_compact_set_free_space(&s, 0);
+    test_strings("should keep the string", "ehy, how are you doing?", s);
+    test_cond("should have correct length", ss_compact_len(s) == 23);
+    test_cond("should have no free space", ss_compact_free_space(s) == 0);
+    test_cond("should have 8 bits header", ss_compact_header_size(s) == 3);
+    ss_compact_free(s);
+}
+
+void test_ss_compact_grow(void) {
+    test_group("ss_compact_grow");
+
+    test_subgroup("growth within free space");
+    ss_compact s = ss_compact_new_from_raw_len_free("ehy", 3, 10);
+    ss_compact_grow(&s, 8);
+    test_cond("should have correct length", ss_compact_len(s) == 8);
+    test_cond("should have correct free space", ss_compact_free_space(s) == 5);
+    test_cond("should set new bytes to zero", memcmp(s, "ehy\0\0\0\0\0\0", 9) == 0);
+
+    test_subgroup("growth with promotion");
+    ss_compact_grow(&s, 200);
+    test_cond("should have correct length", ss_compact_len(s) == 200);
+    test_cond("should have correct free space", ss_compact_free_space(s) == 200);
+    test_cond("should have 16 bits header", ss_compact_header_size(s) == 5);
+    test_strings("should keep the string", "ehy", s);
+
+    test_subgroup("smaller length");
+    ss_compact_grow(&s, 10);
+    test_cond("should be a no-op", ss_compact_len(s) == 200);
+    ss_compact_free(s);
+}
+
+void test_ss_compact_concat_raw_len(void) {
+    test_group("ss_compact_concat_raw_len");
+
+    test_subgroup("concat within free space");
+    ss_compact s = ss_compact_new_from_raw_len_free("ehy, ", 5, 20);
+    ss_compact_concat_raw_len(&s, "how are you doing?", 18);
+    test_strings("should have correct string", "ehy, how are you doing?", s);
+    test_cond("should have correct free space", ss_compact_free_space(s) == 2);
+
+    test_subgroup("concat with promotion");
+    for (int i = 0; i < 100; i++) ss_compact_concat_raw(&s, "0123456789");
+    test_cond("should have correct length", ss_compact_len(s) == 1023);
+    test_cond("should have 16 bits header", ss_compact_header_size(s) == 5);
+    test_cond("should keep the string prefix", memcmp(s, "ehy, how are you doing?0123", 27) == 0);
+    test_strings("should have correct string end", "0123456789", s + 1013);
+    ss_compact_free(s);
+}
+
+void test_ss_compact_free(void) {
+    test_group("ss_compact_free");
+
+    test_subgroup("NULL string");
+    ss_compact_free(NULL);
+    test_success("should be a no-op");
+}
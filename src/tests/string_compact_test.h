@@ -0,0 +1,13 @@
+#ifndef SS_TESTS_STRING_COMPACT_TEST_H
+#define SS_TESTS_STRING_COMPACT_TEST_H
+
+void test_ss_compact_new_from_raw_len_free(void);
+void test_ss_compact_new_from_raw(void);
+void test_ss_compact_from_ss(void);
+void test_ss_compact_to_ss(void);
+void test_ss_compact_set_free_space(void);
+void test_ss_compact_grow(void);
+void test_ss_compact_concat_raw_len(void);
+void test_ss_compact_free(void);
+
+#endif
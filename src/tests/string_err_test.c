@@ -18,6 +18,9 @@ void test_ss_error(void) {
     err = err_format;
     str_err = ss_err_str(err);
     test_strings("should have correct 'err alloc' string", "formatting error", str_err);
+    err = err_immutable;
+    str_err = ss_err_str(err);
+    test_strings("should have correct 'err immutable' string", "immutable string error", str_err);
     err = 10;
     str_err = ss_err_str(err);
     test_strings("should have correct 'err unknown' string", "unknown error", str_err);
@@ -93,6 +93,17 @@ void test_ss_sprintf_cat(void) {
     test_equal("should have correct free", 0, s->free);
     ss_free(s);
 
+    test_subgroup("formatting on caller buffer");
+    struct ss hdr;
+    char buf[16];
+    s = ss_new_on_buf(&hdr, buf, sizeof(buf));
+    ss_sprintf_cat(s, "id=%d", 42);
+    test_cond("should keep the caller buffer", s->buf == buf);
+    ss_sprintf_cat(s, " test=%s", "success");
+    test_cond("should move to a heap buffer", s->buf != buf);
+    test_strings("should have formatted string", "id=42 test=success", s->buf);
+    ss_free(s);
+
     test_subgroup("formatting with concat");
     s = ss_new_from_raw("ehy ");
     ss_sprintf_cat(s, "test=%d test=%d", 1231231231, 123123123);
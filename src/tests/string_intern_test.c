@@ -0,0 +1,131 @@
+#include <string.h>
+#include <pthread.h>
+#include "../string.h"
+#include "../string_split.h"
+#include "../string_intern.h"
+#include "framework/framework.h"
+#include "string_intern_test.h"
+
+static void *intern_tokens(void *arg);
+
+void test_ss_intern_raw_len(void) {
+    test_group("ss_intern_raw_len");
+
+    test_subgroup("same content");
+    ss s1 = ss_intern_raw_len("content-type: text/plain", 12);
+    ss s2 = ss_intern_raw("content-type");
+    test_cond("should return the same string", s1 == s2);
+    test_strings("should have correct string", "content-type", s1->buf);
+    test_cond("should return different strings for different content", ss_intern_raw("content") != s1);
+
+    test_subgroup("immutable strings");
+    test_equal("should fail on concat", err_immutable, ss_concat_raw(s1, "-length"));
+    ss_to_upper(s1);
+    ss_trim(s1, "c");
+    test_strings("should keep the content", "content-type", s1->buf);
+    ss_free(s1);
+    test_cond("should survive ss_free", ss_intern_raw("content-type") == s1);
+
+    test_subgroup("many strings");
+    char key[16];
+    for (int i = 0; i < 1000; i++) {
+        int len = sprintf(key, "key-%d", i);
+        ss_intern_raw_len(key, len);
+    }
+    ss s3 = ss_intern_raw("key-500");
+    test_cond("should find strings after growing", s3 == ss_intern_raw("key-500"));
+
+    test_subgroup("concurrent interning");
+    pthread_t threads[4];
+    ss results[4];
+    for (int i = 0; i < 4; i++) pthread_create(&threads[i], NULL, intern_tokens, &results[i]);
+    for (int i = 0; i < 4; i++) pthread_join(threads[i], NULL);
+    int same = 1;
+    for (int i = 1; i < 4; i++) same = same && results[i] == results[0];
+    test_cond("should return the same string to all threads", same);
+    ss_intern_reset();
+}
+
+void test_ss_intern_str(void) {
+    test_group("ss_intern_str");
+
+    test_subgroup("ss content");
+    ss s = ss_new_from_raw("ehy, how are you doing?");
+    ss interned = ss_intern_str(s);
+    test_cond("should return a different string", s != interned);
+    test_cond("should return the canonical string", interned == ss_intern_raw("ehy, how are you doing?"));
+    ss_free(s);
+    ss_intern_reset();
+}
+
+void test_ss_intern_get_stats(void) {
+    test_group("ss_intern_get_stats");
+
+    test_subgroup("memory accounting");
+    ss_intern_stats stats;
+    ss_intern_get_stats(&stats);
+    test_cond("should be empty", stats.n_strings == 0 && stats.string_bytes == 0 && stats.table_bytes == 0);
+    ss_intern_raw("ehy");
+    ss_intern_raw("ehy");
+    ss_intern_raw("ehy, how are you doing? I'm fine, thanks!");
+    ss_intern_get_stats(&stats);
+    test_cond("should count distinct strings", stats.n_strings == 2);
+    test_cond("should count the string bytes", stats.string_bytes == 2 * sizeof(struct ss) + 42);
+    test_cond("should count the table bytes", stats.table_bytes > 0);
+    ss_intern_reset();
+
+    test_subgroup("strings around the inline capacity");
+    char str[SS_INLINE_CAP + 1];
+    memset(str, 'a', sizeof(str));
+    ss_intern_raw_len(str, SS_INLINE_CAP - 1);
+    ss_intern_raw_len(str, SS_INLINE_CAP);
+    ss_intern_get_stats(&stats);
+    test_cond("should count the buffer of the string not fitting the inline array",
+              stats.string_bytes == 2 * sizeof(struct ss) + SS_INLINE_CAP + 1);
+    ss_intern_reset();
+}
+
+void test_ss_intern_reset(void) {
+    test_group("ss_intern_reset");
+
+    test_subgroup("empty table");
+    ss_intern_reset();
+    test_success("should be a no-op");
+
+    test_subgroup("reuse after reset");
+    ss_intern_raw("ehy");
+    ss_intern_reset();
+    ss_intern_stats stats;
+    ss_intern_get_stats(&stats);
+    test_cond("should empty the table", stats.n_strings == 0);
+    test_strings("should intern again", "ehy", ss_intern_raw("ehy")->buf);
+    ss_intern_reset();
+}
+
+void test_ss_split_raw_intern(void) {
+    test_group("ss_split_raw_intern");
+
+    test_subgroup("repeated tokens");
+    int n = 0;
+    ss *list = ss_split_raw_intern("GET,POST,GET,PUT,GET", ",", &n);
+    test_equal("should have 5 strings", 5, n);
+    test_strings("should have correct first string", "GET", list[0]->buf);
+    test_cond("should share repeated tokens", list[0] == list[2] && list[2] == list[4]);
+    test_cond("should return canonical strings", list[1] == ss_intern_raw("POST"));
+    ss_list_free(list, n);
+    ss_intern_stats stats;
+    ss_intern_get_stats(&stats);
+    test_cond("should keep the strings in the table", stats.n_strings == 3);
+    ss_intern_reset();
+}
+
+static void *intern_tokens(void *arg) {
+    ss *result = arg;
+    char key[16];
+    for (int i = 0; i < 200; i++) {
+        int len = sprintf(key, "token-%d", i);
+        ss_intern_raw_len(key, len);
+    }
+    *result = ss_intern_raw("token-100");
+    return NULL;
+}
@@ -0,0 +1,10 @@
+#ifndef SS_TESTS_STRING_INTERN_TEST_H
+#define SS_TESTS_STRING_INTERN_TEST_H
+
+void test_ss_intern_raw_len(void);
+void test_ss_intern_str(void);
+void test_ss_intern_get_stats(void);
+void test_ss_intern_reset(void);
+void test_ss_split_raw_intern(void);
+
+#endif
@@ -0,0 +1,98 @@
+#include "../string.h"
+#include "../string_list.h"
+#include "framework/framework.h"
+#include "string_list_test.h"
+
+void test_ss_list_new(void) {
+    test_group("ss_list_new");
+
+    test_subgroup("empty list");
+    ss_list list = ss_list_new();
+    test_equal("should have no strings", 0, list->len);
+    test_cond("should have no array", list->items == NULL);
+    ss_list_destroy(list);
+}
+
+void test_ss_list_reserve(void) {
+    test_group("ss_list_reserve");
+
+    test_subgroup("push after reserve");
+    ss_list list = ss_list_new();
+    ss_list_reserve(list, 100);
+    ss *items = list->items;
+    for (int i = 0; i < 100; i++) ss_list_push_raw(list, "ehy");
+    test_cond("shouldn't reallocate the array", list->items == items);
+    test_equal("should have correct len", 100, list->len);
+    ss_list_destroy(list);
+}
+
+void test_ss_list_push(void) {
+    test_group("ss_list_push");
+
+    test_subgroup("take ownership");
+    ss_list list = ss_list_new();
+    ss s = ss_new_from_raw("ehy, how are you?");
+    ss_list_push(list, s);
+    test_cond("shouldn't copy the string", list->items[0] == s);
+
+    test_subgroup("geometric growth");
+    size_t reallocs = 0;
+    ss *items = list->items;
+    for (int i = 0; i < 10000; i++) {
+        ss_list_push(list, ss_new_from_raw("0123456789"));
+        if (list->items != items) reallocs++;
+        items = list->items;
+    }
+    test_equal("should have correct len", 10001, list->len);
+    test_cond("should reallocate a logarithmic number of times", reallocs <= 11);
+    test_strings("should keep the first string", "ehy, how are you?", list->items[0]->buf);
+    ss_list_destroy(list);
+}
+
+void test_ss_list_push_raw_len(void) {
+    test_group("ss_list_push_raw_len");
+
+    test_subgroup("copy raw strings");
+    ss_list list = ss_list_new();
+    ss_list_push_raw_len(list, "ehy, how are you?", 3);
+    ss_list_push_raw(list, "how");
+    ss_list_push_raw(list, NULL);
+    test_equal("should have correct len", 2, list->len);
+    test_strings("should copy the first string", "ehy", list->items[0]->buf);
+    test_strings("should copy the second string", "how", list->items[1]->buf);
+    test_equal("should have no free space", 0, list->items[1]->free);
+    ss_list_destroy(list);
+}
+
+void test_ss_list_pop(void) {
+    test_group("ss_list_pop");
+
+    test_subgroup("pop strings");
+    ss_list list = ss_list_new();
+    ss_list_push_raw(list, "ehy");
+    ss_list_push_raw(list, "you");
+    ss s = ss_list_pop(list);
+    test_strings("should return the last string", "you", s->buf);
+    test_equal("should have correct len", 1, list->len);
+    ss_free(s);
+    ss_free(ss_list_pop(list));
+    test_cond("should return NULL on empty list", ss_list_pop(list) == NULL);
+    ss_list_destroy(list);
+}
+
+void test_ss_list_clear(void) {
+    test_group("ss_list_clear");
+
+    test_subgroup("clear and reuse");
+    ss_list list = ss_list_new();
+    for (int i = 0; i < 100; i++) ss_list_push_raw(list, "ehy");
+    ss *items = list->items;
+    for (int j = 0; j < 10; j++) {
+        ss_list_clear(list);
+        for (int i = 0; i < 100; i++) ss_list_push_raw(list, "you");
+    }
+    test_cond("shouldn't reallocate the array", list->items == items);
+    test_equal("should have correct len", 100, list->len);
+    test_strings("should have the new strings", "you", list->items[99]->buf);
+    ss_list_destroy(list);
+}
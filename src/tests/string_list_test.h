@@ -0,0 +1,11 @@
+#ifndef SS_TESTS_STRING_LIST_TEST_H
+#define SS_TESTS_STRING_LIST_TEST_H
+
+void test_ss_list_new(void);
+void test_ss_list_reserve(void);
+void test_ss_list_push(void);
+void test_ss_list_push_raw_len(void);
+void test_ss_list_pop(void);
+void test_ss_list_clear(void);
+
+#endif
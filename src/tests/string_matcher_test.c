@@ -0,0 +1,218 @@
+#include <string.h>
+#include "../string.h"
+#include "../string_list.h"
+#include "../string_matcher.h"
+#include "framework/framework.h"
+#include "string_matcher_test.h"
+
+// Collects the matches reported by ss_matcher_each, stopping after `stop`
+// matches if it's not zero.
+typedef struct collected {
+    ss_match matches[64];
+    int n;
+    int stop;
+} collected;
+
+static int collect(ss_match match, void *ctx) {
+    collected *c = ctx;
+    if (c->n < 64) c->matches[c->n] = match;
+    c->n++;
+    return c->stop != 0 && c->n == c->stop;
+}
+
+// Counts the overlapping occurrences of all the patterns one at a time.
+static size_t naive_count(const char **patterns, int n, ss s) {
+    size_t count = 0;
+    for (int i = 0; i < n; i++) {
+        size_t len = strlen(patterns[i]);
+        if (len == 0) continue;
+        for (size_t pos = 0; pos + len <= s->len; pos++) {
+            if (memcmp(s->buf + pos, patterns[i], len) == 0) count++;
+        }
+    }
+    return count;
+}
+
+void test_ss_matcher_new(void) {
+    test_group("ss_matcher_new");
+
+    test_subgroup("patterns");
+    const char *patterns[] = {"he", "she", "his", "hers"};
+    ss_matcher m = ss_matcher_new(patterns, 4);
+    test_cond("should build the matcher", m != NULL);
+    test_equal("should have correct number of patterns", 4, ss_matcher_len(m));
+    ss_matcher_free(m);
+
+    test_subgroup("no patterns");
+    m = ss_matcher_new(NULL, 0);
+    ss s = ss_new_from_raw("ehy, how are you?");
+    ss_match match;
+    test_cond("should build the matcher", m != NULL);
+    test_cond("shouldn't match", !ss_matcher_find(m, s, &match));
+    test_equal("should count no matches", 0, ss_matcher_count(m, s));
+    ss_matcher_free(m);
+
+    test_subgroup("empty patterns");
+    const char *empty[] = {"", NULL};
+    m = ss_matcher_new(empty, 2);
+    test_equal("should keep the patterns", 2, ss_matcher_len(m));
+    test_cond("shouldn't match", !ss_matcher_find(m, s, &match));
+    ss_matcher_free(m);
+
+    test_subgroup("all bytes");
+    char bytes[256][2];
+    const char *all[255];
+    for (int c = 1; c < 256; c++) {
+        bytes[c][0] = (char)c;
+        bytes[c][1] = '\0';
+        all[c - 1] = bytes[c];
+    }
+    m = ss_matcher_new(all, 255);
+    test_equal("should match every byte", s->len, ss_matcher_count(m, s));
+    ss_matcher_free(m);
+    ss_free(s);
+
+    test_subgroup("free NULL");
+    ss_matcher_free(NULL);
+    test_cond("should be a no-op", 1);
+}
+
+void test_ss_matcher_new_list(void) {
+    test_group("ss_matcher_new_list");
+
+    test_subgroup("patterns with null bytes");
+    ss_list list = ss_list_new();
+    ss_list_push_raw_len(list, "a\0b", 3);
+    ss_list_push_raw(list, "bc");
+    ss_matcher m = ss_matcher_new_list(list);
+    ss s = ss_new_from_raw_len("xxa\0bcx", 7);
+    ss_match match;
+    test_equal("should have correct number of patterns", 2, ss_matcher_len(m));
+    test_cond("should match", ss_matcher_find(m, s, &match));
+    test_equal("should match the first pattern", 0, match.pattern);
+    test_equal("should have correct position", 2, match.pos);
+    test_equal("should have correct length", 3, match.len);
+    test_equal("should count both patterns", 2, ss_matcher_count(m, s));
+    ss_matcher_free(m);
+    ss_list_destroy(list);
+    ss_free(s);
+}
+
+void test_ss_matcher_find(void) {
+    test_group("ss_matcher_find");
+
+    const char *patterns[] = {"he", "she", "his", "hers"};
+    ss_matcher m = ss_matcher_new(patterns, 4);
+    ss_match match;
+
+    test_subgroup("first ending match");
+    ss s = ss_new_from_raw("ushers");
+    test_cond("should match", ss_matcher_find(m, s, &match));
+    test_equal("should prefer the longest pattern", 1, match.pattern);
+    test_equal("should have correct position", 1, match.pos);
+    test_equal("should have correct length", 3, match.len);
+    ss_free(s);
+
+    test_subgroup("no match");
+    s = ss_new_from_raw("ehy, how are you?");
+    match = (ss_match){.pattern = 42, .pos = 42, .len = 42};
+    test_cond("shouldn't match", !ss_matcher_find(m, s, &match));
+    test_equal("shouldn't modify the match", 42, match.pattern);
+    ss_free(s);
+
+    test_subgroup("empty string");
+    s = ss_new_empty();
+    test_cond("shouldn't match", !ss_matcher_find(m, s, &match));
+    ss_free(s);
+
+    test_subgroup("match at the end");
+    s = ss_new_from_raw("xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxhis");
+    test_cond("should match", ss_matcher_find(m, s, &match));
+    test_equal("should match the right pattern", 2, match.pattern);
+    test_equal("should have correct position", s->len - 3, match.pos);
+    ss_free(s);
+
+    test_subgroup("null bytes in the string");
+    s = ss_new_from_raw_len("\0\0\0she", 6);
+    test_cond("should match", ss_matcher_find(m, s, &match));
+    test_equal("should have correct position", 3, match.pos);
+    ss_free(s);
+    ss_matcher_free(m);
+
+    test_subgroup("many first bytes");
+    const char *many[] = {"aq", "bq", "cq", "dq", "eq", "fq", "gq", "hq", "iq",
+                          "jq", "kq", "lq", "mq", "nq", "oq", "pq", "qq", "rq"};
+    m = ss_matcher_new(many, 18);
+    s = ss_new_from_raw("xxxxxxxxxxxxxxxxxxxxxxrq");
+    test_cond("should match", ss_matcher_find(m, s, &match));
+    test_equal("should match the right pattern", 17, match.pattern);
+    test_equal("should have correct position", 22, match.pos);
+    ss_free(s);
+    ss_matcher_free(m);
+}
+
+void test_ss_matcher_each(void) {
+    test_group("ss_matcher_each");
+
+    const char *patterns[] = {"he", "she", "his", "hers", "she"};
+    ss_matcher m = ss_matcher_new(patterns, 5);
+
+    test_subgroup("overlapping matches");
+    ss s = ss_new_from_raw("ushers");
+    collected c = {.n = 0, .stop = 0};
+    test_equal("should return zero", 0, ss_matcher_each(m, s, collect, &c));
+    test_equal("should report all matches", 4, c.n);
+    test_equal("should report the longest pattern first", 1, c.matches[0].pattern);
+    test_equal("should report repeated patterns", 4, c.matches[1].pattern);
+    test_equal("should report the suffix pattern", 0, c.matches[2].pattern);
+    test_equal("should have correct position", 2, c.matches[2].pos);
+    test_equal("should report the last pattern", 3, c.matches[3].pattern);
+    test_equal("should have correct position", 2, c.matches[3].pos);
+
+    test_subgroup("stop");
+    c = (collected){.n = 0, .stop = 2};
+    test_equal("should return the callback value", 1, ss_matcher_each(m, s, collect, &c));
+    test_equal("should stop after the callback", 2, c.n);
+    ss_free(s);
+    ss_matcher_free(m);
+}
+
+void test_ss_matcher_count(void) {
+    test_group("ss_matcher_count");
+
+    test_subgroup("overlapping matches");
+    const char *patterns[] = {"aa", "a", "aaa", "ab", "b"};
+    ss_matcher m = ss_matcher_new(patterns, 5);
+    ss s = ss_new_from_raw("aaaabaaab");
+    test_equal("should count all matches", naive_count(patterns, 5, s), ss_matcher_count(m, s));
+    ss_free(s);
+    ss_matcher_free(m);
+
+    test_subgroup("against naive search");
+    const char *words[] = {"abc", "bca", "cab", "abcabc", "c", "ba", "aab", "cc"};
+    m = ss_matcher_new(words, 8);
+    s = ss_new_empty();
+    unsigned int seed = 1;
+    for (int i = 0; i < 4096; i++) {
+        seed = seed * 1103515245 + 12345;
+        char c = (char)('a' + (seed >> 16) % 3);
+        ss_concat_raw_len(s, &c, 1);
+    }
+    test_equal("should count like the naive search", naive_count(words, 8, s), ss_matcher_count(m, s));
+    ss_free(s);
+    ss_matcher_free(m);
+
+    test_subgroup("text alternately dense and sparse in first bytes");
+    const char *english[] = {"then", "that", "these", "ether", "the"};
+    m = ss_matcher_new(english, 5);
+    s = ss_new_empty();
+    for (int i = 0; i < 8192; i++) {
+        seed = seed * 1103515245 + 12345;
+        const char *alphabet = (i / 256) % 2 == 0 ? "the " : "xyzwtxyzwhxyzw ";
+        char c = alphabet[(seed >> 16) % strlen(alphabet)];
+        ss_concat_raw_len(s, &c, 1);
+    }
+    test_equal("should count like the naive search", naive_count(english, 5, s), ss_matcher_count(m, s));
+    ss_free(s);
+    ss_matcher_free(m);
+}
@@ -0,0 +1,10 @@
+#ifndef SS_TESTS_STRING_MATCHER_TEST_H
+#define SS_TESTS_STRING_MATCHER_TEST_H
+
+void test_ss_matcher_new(void);
+void test_ss_matcher_new_list(void);
+void test_ss_matcher_find(void);
+void test_ss_matcher_each(void);
+void test_ss_matcher_count(void);
+
+#endif
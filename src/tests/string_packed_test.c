@@ -0,0 +1,158 @@
+#include <string.h>
+#include "../string.h"
+#include "../string_packed.h"
+#include "../string_split.h"
+#include "framework/framework.h"
+#include "string_packed_test.h"
+
+static int count_piece(const char *piece, size_t len, void *ctx);
+static int stop_piece(const char *piece, size_t len, void *ctx);
+
+void test_ss_packed_new(void) {
+    test_group("ss_packed_new");
+
+    test_subgroup("empty list");
+    ss_packed list = ss_packed_new();
+    test_equal("should have no pieces", 0, ss_packed_len(list));
+    test_equal("should have no bytes", 0, ss_packed_bytes(list));
+    ss_packed_free(list);
+}
+
+void test_ss_packed_reserve(void) {
+    test_group("ss_packed_reserve");
+
+    test_subgroup("push after reserve");
+    ss_packed list = ss_packed_new();
+    ss_packed_reserve(list, 100, 1000);
+    ss_packed_push_raw(list, "ehy");
+    ss_view first = ss_packed_get(list, 0);
+    for (int i = 0; i < 99; i++) ss_packed_push_raw(list, "0123456789");
+    test_cond("shouldn't move the buffer", first.ptr == ss_packed_get(list, 0).ptr);
+    test_equal("should have correct len", 100, ss_packed_len(list));
+    test_equal("should have correct bytes", 993, ss_packed_bytes(list));
+    ss_packed_free(list);
+}
+
+void test_ss_packed_push_raw_len(void) {
+    test_group("ss_packed_push_raw_len");
+
+    test_subgroup("push pieces");
+    ss_packed list = ss_packed_new();
+    ss_packed_push_raw_len(list, "ehy, how are you?", 3);
+    ss_packed_push_raw(list, "how");
+    ss_packed_push_raw(list, NULL);
+    ss_packed_push_raw(list, "");
+    ss s = ss_new_from_raw("are you?");
+    ss_packed_push_str(list, s);
+    ss_free(s);
+    test_equal("should have correct len", 4, ss_packed_len(list));
+    test_equal("should have correct bytes", 14, ss_packed_bytes(list));
+
+    test_subgroup("many pieces");
+    for (int i = 0; i < 10000; i++) ss_packed_push_raw(list, "0123456789");
+    test_equal("should have correct len", 10004, ss_packed_len(list));
+    test_cond("should keep the first piece", ss_view_equal_raw(ss_packed_get(list, 0), "ehy"));
+    test_cond("should have the last piece", ss_view_equal_raw(ss_packed_get(list, 10003), "0123456789"));
+    ss_packed_free(list);
+}
+
+void test_ss_packed_get(void) {
+    test_group("ss_packed_get");
+
+    test_subgroup("contiguous pieces");
+    ss_packed list = ss_packed_new();
+    ss_packed_push_raw(list, "ehy");
+    ss_packed_push_raw(list, "");
+    ss_packed_push_raw(list, "you");
+    ss_view v0 = ss_packed_get(list, 0);
+    ss_view v1 = ss_packed_get(list, 1);
+    ss_view v2 = ss_packed_get(list, 2);
+    test_cond("should get the pieces", ss_view_equal_raw(v0, "ehy") && v1.len == 0 && ss_view_equal_raw(v2, "you"));
+    test_cond("should store the pieces back to back", v1.ptr == v0.ptr + 4 && v2.ptr == v1.ptr + 1);
+    test_strings("should null terminate the pieces", "you", v2.ptr);
+
+    test_subgroup("out of range");
+    test_equal("should return an empty view", 0, ss_packed_get(list, 3).len);
+    ss_packed_free(list);
+}
+
+void test_ss_packed_each(void) {
+    test_group("ss_packed_each");
+
+    test_subgroup("all pieces");
+    ss_packed list = ss_packed_new();
+    ss_packed_push_raw(list, "ehy");
+    ss_packed_push_raw(list, "how");
+    ss_packed_push_raw(list, "are you?");
+    size_t total = 0;
+    test_equal("should return zero", 0, ss_packed_each(list, count_piece, &total));
+    test_equal("should visit all the pieces", 14, total);
+
+    test_subgroup("stop early");
+    int calls = 0;
+    test_equal("should return the stop value", 1, ss_packed_each(list, stop_piece, &calls));
+    test_equal("should stop after the first piece", 1, calls);
+    ss_packed_free(list);
+}
+
+void test_ss_packed_sort(void) {
+    test_group("ss_packed_sort");
+
+    test_subgroup("sort pieces");
+    ss_packed list = ss_split_raw_packed("pear,apple,fig,apples,,banana,fig", ",");
+    ss_packed_sort(list);
+    ss s = ss_join_packed(list, " ");
+    test_strings("should sort the pieces", "apple apples banana fig fig pear", s->buf);
+    ss_free(s);
+    ss_view first = ss_packed_get(list, 0);
+    test_cond("should keep the pieces back to back", ss_packed_get(list, 1).ptr == first.ptr + 6);
+    test_strings("should keep the terminators", "apple", first.ptr);
+    ss_packed_free(list);
+}
+
+void test_ss_packed_to_views(void) {
+    test_group("ss_packed_to_views");
+    int n = 0;
+
+    test_subgroup("zero-copy views");
+    ss_packed list = ss_split_raw_packed("ehy how are you?", " ");
+    ss_view *views = ss_packed_to_views(list, &n);
+    test_equal("should have all the pieces", 4, n);
+    test_cond("should point into the list", views[3].ptr == ss_packed_get(list, 3).ptr);
+    test_cond("should have correct pieces", ss_view_equal_raw(views[0], "ehy") && ss_view_equal_raw(views[3], "you?"));
+    ss_packed_free_views(list, views);
+
+    test_subgroup("empty list");
+    ss_packed_clear(list);
+    test_cond("should return NULL", ss_packed_to_views(list, &n) == NULL);
+    test_equal("should have no pieces", 0, n);
+    ss_packed_free(list);
+}
+
+void test_ss_packed_clear(void) {
+    test_group("ss_packed_clear");
+
+    test_subgroup("reuse the list");
+    ss_packed list = ss_packed_new();
+    for (int i = 0; i < 100; i++) ss_packed_push_raw(list, "0123456789");
+    const char *data = ss_packed_get(list, 0).ptr;
+    ss_packed_clear(list);
+    test_equal("should have no pieces", 0, ss_packed_len(list));
+    for (int i = 0; i < 100; i++) ss_packed_push_raw(list, "9876543210");
+    test_cond("should reuse the buffer", ss_packed_get(list, 0).ptr == data);
+    test_cond("should have the new pieces", ss_view_equal_raw(ss_packed_get(list, 99), "9876543210"));
+    ss_packed_free(list);
+}
+
+static int count_piece(const char *piece, size_t len, void *ctx) {
+    (void)piece;
+    *(size_t *)ctx += len;
+    return 0;
+}
+
+static int stop_piece(const char *piece, size_t len, void *ctx) {
+    (void)piece;
+    (void)len;
+    (*(int *)ctx)++;
+    return 1;
+}
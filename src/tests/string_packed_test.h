@@ -0,0 +1,13 @@
+#ifndef SS_TESTS_STRING_PACKED_TEST_H
+#define SS_TESTS_STRING_PACKED_TEST_H
+
+void test_ss_packed_new(void);
+void test_ss_packed_reserve(void);
+void test_ss_packed_push_raw_len(void);
+void test_ss_packed_get(void);
+void test_ss_packed_each(void);
+void test_ss_packed_sort(void);
+void test_ss_packed_to_views(void);
+void test_ss_packed_clear(void);
+
+#endif
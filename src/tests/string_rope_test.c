@@ -0,0 +1,184 @@
+#include <string.h>
+#include "../string.h"
+#include "../string_rope.h"
+#include "framework/framework.h"
+#include "string_rope_test.h"
+
+static int count_chunk(const char *chunk, size_t len, void *ctx);
+static int stop_chunk(const char *chunk, size_t len, void *ctx);
+
+void test_ss_rope_new(void) {
+    test_group("ss_rope_new");
+
+    test_subgroup("empty rope");
+    ss_rope rope = ss_rope_new();
+    test_cond("should have length 0", ss_rope_len(rope) == 0);
+    test_strings("should flatten to empty string", "", ss_rope_flatten(rope)->buf);
+    ss_rope_free(rope);
+}
+
+void test_ss_rope_concat_raw_len(void) {
+    test_group("ss_rope_concat_raw_len");
+
+    test_subgroup("small pieces");
+    ss_rope rope = ss_rope_new();
+    ss_rope_concat_raw_len(rope, "ehy, how are you doing?", 4);
+    ss_rope_concat_raw(rope, "how are you doing?");
+    test_cond("should have correct length", ss_rope_len(rope) == 22);
+    test_strings("should have correct string", "ehy,how are you doing?", ss_rope_flatten(rope)->buf);
+
+    test_subgroup("many pieces");
+    for (int i = 0; i < 1000; i++) ss_rope_concat_raw(rope, "0123456789");
+    ss flat = ss_rope_flatten(rope);
+    test_cond("should have correct length", flat->len == 10022);
+    test_cond("should keep the prefix", memcmp(flat->buf, "ehy,how are you doing?0123", 26) == 0);
+    test_strings("should have correct end", "0123456789", flat->buf + 10012);
+    ss_rope_free(rope);
+}
+
+void test_ss_rope_prepend_raw_len(void) {
+    test_group("ss_rope_prepend_raw_len");
+
+    test_subgroup("repeated prepends");
+    ss_rope rope = ss_rope_new();
+    ss_rope_concat_raw(rope, "body");
+    for (int i = 0; i < 1000; i++) ss_rope_prepend_raw("[hdr]", rope);
+    ss flat = ss_rope_flatten(rope);
+    test_cond("should have correct length", flat->len == 5004);
+    test_cond("should start with the last prepend", memcmp(flat->buf, "[hdr][hdr]", 10) == 0);
+    test_strings("should end with the original content", "[hdr]body", flat->buf + 4995);
+
+    test_subgroup("big prepend");
+    char big[1024];
+    memset(big, 'x', sizeof(big));
+    ss_rope_prepend_raw_len(big, rope, sizeof(big));
+    test_cond("should have correct length", ss_rope_len(rope) == 6028);
+    flat = ss_rope_flatten(rope);
+    test_cond("should have correct start", flat->buf[0] == 'x' && flat->buf[1023] == 'x');
+    test_cond("should have correct content after", memcmp(flat->buf + 1024, "[hdr]", 5) == 0);
+    ss_rope_free(rope);
+}
+
+void test_ss_rope_insert_raw_len(void) {
+    test_group("ss_rope_insert_raw_len");
+
+    test_subgroup("insert in the middle");
+    ss_rope rope = ss_rope_new();
+    ss_rope_concat_raw(rope, "ehy, are you?");
+    ss_rope_insert_raw_len(rope, 5, "how ", 4);
+    ss_rope_insert_raw_len(rope, 16, " doing", 6);
+    test_strings("should have correct string", "ehy, how are you doing?", ss_rope_flatten(rope)->buf);
+
+    test_subgroup("insert at the boundaries");
+    ss_rope_insert_raw_len(rope, 0, ">> ", 3);
+    ss_rope_insert_raw_len(rope, 1000, " <<", 3);
+    test_strings("should have correct string", ">> ehy, how are you doing? <<", ss_rope_flatten(rope)->buf);
+
+    test_subgroup("insert in many chunks");
+    for (int i = 0; i < 100; i++) ss_rope_insert_raw_len(rope, 3, "-", 1);
+    ss flat = ss_rope_flatten(rope);
+    test_cond("should have correct length", flat->len == 129);
+    test_cond("should have inserted in place", memcmp(flat->buf, ">> ---", 6) == 0 && flat->buf[103] == 'e');
+    ss_rope_free(rope);
+}
+
+void test_ss_rope_delete(void) {
+    test_group("ss_rope_delete");
+
+    test_subgroup("delete across chunks");
+    ss_rope rope = ss_rope_new();
+    ss_rope_concat_raw(rope, "ehy, how are you doing?");
+    ss_rope_insert_raw_len(rope, 4, " hello,", 7);
+    ss_rope_delete(rope, 3, 10);
+    test_strings("should have correct string", "ehyow are you doing?", ss_rope_flatten(rope)->buf);
+
+    test_subgroup("delete up to the end");
+    ss_rope_delete(rope, 13, 100);
+    test_strings("should have correct string", "ehyow are you", ss_rope_flatten(rope)->buf);
+
+    test_subgroup("out of range");
+    ss_rope_delete(rope, 100, 1);
+    test_cond("should be a no-op", ss_rope_len(rope) == 13);
+    ss_rope_free(rope);
+}
+
+void test_ss_rope_slice(void) {
+    test_group("ss_rope_slice");
+
+    test_subgroup("slice across chunks");
+    ss_rope rope = ss_rope_new();
+    ss_rope_concat_raw(rope, "ehy, how");
+    ss_rope_insert_raw_len(rope, 8, " are you doing?", 15);
+    ss_rope_slice(rope, 5, 12);
+    test_strings("should have correct string", "how are", ss_rope_flatten(rope)->buf);
+
+    test_subgroup("invalid indexes");
+    ss_rope_slice(rope, 10, 20);
+    ss_rope_slice(rope, 3, 1);
+    test_strings("should be a no-op", "how are", ss_rope_flatten(rope)->buf);
+    ss_rope_free(rope);
+}
+
+void test_ss_rope_each_chunk(void) {
+    test_group("ss_rope_each_chunk");
+
+    test_subgroup("all chunks");
+    ss_rope rope = ss_rope_new();
+    char big[1024];
+    memset(big, 'x', sizeof(big));
+    ss_rope_concat_raw_len(rope, big, sizeof(big));
+    ss_rope_concat_raw_len(rope, big, sizeof(big));
+    ss_rope_prepend_raw_len(big, rope, sizeof(big));
+    size_t total = 0;
+    int ret = ss_rope_each_chunk(rope, count_chunk, &total);
+    test_cond("should visit all the content", total == 3072);
+    test_equal("should return zero", 0, ret);
+
+    test_subgroup("early stop");
+    total = 0;
+    ret = ss_rope_each_chunk(rope, stop_chunk, &total);
+    test_cond("should stop after the first chunk", total == 1024);
+    test_equal("should return the callback value", 1, ret);
+    ss_rope_free(rope);
+}
+
+void test_ss_rope_flatten(void) {
+    test_group("ss_rope_flatten");
+
+    test_subgroup("repeated calls");
+    ss_rope rope = ss_rope_new();
+    ss_rope_concat_raw(rope, "ehy, ");
+    ss_rope_insert_raw_len(rope, 5, "how are you doing?", 18);
+    ss s1 = ss_rope_flatten(rope);
+    ss s2 = ss_rope_flatten(rope);
+    test_cond("should return the same string", s1 == s2);
+    test_strings("should have correct string", "ehy, how are you doing?", s1->buf);
+    ss_rope_free(rope);
+}
+
+void test_ss_rope_to_ss(void) {
+    test_group("ss_rope_to_ss");
+
+    test_subgroup("independent copy");
+    ss_rope rope = ss_rope_new();
+    ss_rope_concat_raw(rope, "how are you doing?");
+    ss_rope_prepend_raw("ehy, ", rope);
+    ss s = ss_rope_to_ss(rope);
+    test_strings("should have correct string", "ehy, how are you doing?", s->buf);
+    test_equal("should have correct len", 23, s->len);
+    ss_rope_free(rope);
+    test_strings("should survive the rope", "ehy, how are you doing?", s->buf);
+    ss_free(s);
+}
+
+static int count_chunk(const char *chunk, size_t len, void *ctx) {
+    (void)chunk;
+    *(size_t *)ctx += len;
+    return 0;
+}
+
+static int stop_chunk(const char *chunk, size_t len, void *ctx) {
+    (void)chunk;
+    *(size_t *)ctx += len;
+    return 1;
+}
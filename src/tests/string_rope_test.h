@@ -0,0 +1,14 @@
+#ifndef SS_TESTS_STRING_ROPE_TEST_H
+#define SS_TESTS_STRING_ROPE_TEST_H
+
+void test_ss_rope_new(void);
+void test_ss_rope_concat_raw_len(void);
+void test_ss_rope_prepend_raw_len(void);
+void test_ss_rope_insert_raw_len(void);
+void test_ss_rope_delete(void);
+void test_ss_rope_slice(void);
+void test_ss_rope_each_chunk(void);
+void test_ss_rope_flatten(void);
+void test_ss_rope_to_ss(void);
+
+#endif
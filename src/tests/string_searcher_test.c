@@ -0,0 +1,195 @@
+#include <string.h>
+#include "../string.h"
+#include "../string_searcher.h"
+#include "../string_split.h"
+#include "framework/framework.h"
+#include "string_searcher_test.h"
+
+void test_ss_searcher_new(void) {
+    test_group("ss_searcher_new");
+
+    test_subgroup("copy the needle");
+    char needle[] = "how";
+    ss_searcher searcher = ss_searcher_new_raw(needle);
+    needle[0] = 'x';
+    ss s = ss_new_from_raw("Ehy, how are you?");
+    test_equal("should have correct len", 3, ss_searcher_len(searcher));
+    test_equal("should find the original needle", 5, ss_searcher_find(searcher, s));
+    ss_searcher_free(searcher);
+
+    test_subgroup("needle with null bytes");
+    ss n = ss_new_from_raw_len("a\0b", 3);
+    ss h = ss_new_from_raw_len("aa\0a\0b", 6);
+    searcher = ss_searcher_new_str(n);
+    test_equal("should have correct len", 3, ss_searcher_len(searcher));
+    test_equal("should find the needle", 3, ss_searcher_find(searcher, h));
+    ss_searcher_free(searcher);
+    ss_free(n);
+    ss_free(h);
+
+    test_subgroup("empty needle");
+    searcher = ss_searcher_new_raw(NULL);
+    test_equal("should have zero len", 0, ss_searcher_len(searcher));
+    test_equal("shouldn't match", -1, ss_searcher_find(searcher, s));
+    test_equal("should count no matches", 0, ss_searcher_count(searcher, s));
+    ss_searcher_free(searcher);
+    ss_free(s);
+
+    test_subgroup("free NULL");
+    ss_searcher_free(NULL);
+    test_cond("should be a no-op", 1);
+}
+
+void test_ss_searcher_find(void) {
+    test_group("ss_searcher_find");
+
+    test_subgroup("against naive search");
+    ss s = ss_new_empty();
+    unsigned int seed = 1;
+    for (int i = 0; i < 2000; i++) {
+        seed = seed * 1103515245 + 12345;
+        char c = "ab \n"[(seed >> 16) % 4];
+        ss_concat_raw_len(s, &c, 1);
+    }
+    int ok = 1;
+    for (size_t len = 1; len <= 40 && ok; len += 3) {
+        for (size_t from = 0; from + len <= s->len && ok; from += 97) {
+            // Take the needle from the text and change its last byte, so
+            // that it may or may not occur before `from`.
+            char needle[40];
+            memcpy(needle, s->buf + from, len);
+            needle[len - 1] = needle[len - 1] == 'a' ? 'b' : 'a';
+            size_t want = -1;
+            for (size_t pos = 0; pos + len <= s->len && want == (size_t)-1; pos++) {
+                if (memcmp(s->buf + pos, needle, len) == 0) want = pos;
+            }
+            ss_searcher searcher = ss_searcher_new_raw_len(needle, len);
+            ok = ss_searcher_find(searcher, s) == want;
+            ss_searcher_free(searcher);
+        }
+    }
+    ss_free(s);
+    test_cond("should find the first occurrence", ok);
+
+    test_subgroup("periodic text");
+    s = ss_new_empty();
+    for (int i = 0; i < 5000; i++) ss_concat_raw(s, "a");
+    ss_concat_raw(s, "b");
+    ss_searcher searcher = ss_searcher_new_raw("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab");
+    test_equal("should find the needle", 5000 - 34, ss_searcher_find(searcher, s));
+    ss_searcher_free(searcher);
+    searcher = ss_searcher_new_raw("aaaaaaaaaaaaaaaabaaaaaaaaaaaaa");
+    test_equal("shouldn't match", -1, ss_searcher_find(searcher, s));
+    ss_searcher_free(searcher);
+    ss_free(s);
+
+    test_subgroup("raw buffer");
+    searcher = ss_searcher_new_raw("you");
+    const char *buf = "Ehy, how are you?";
+    test_equal("should find in the buffer", 13, ss_searcher_find_raw_len(searcher, buf, strlen(buf)));
+    test_equal("should stop at the length", -1, ss_searcher_find_raw_len(searcher, buf, 15));
+    test_equal("should handle NULL buffers", -1, ss_searcher_find_raw_len(searcher, NULL, 0));
+    ss_searcher_free(searcher);
+}
+
+void test_ss_searcher_find_next(void) {
+    test_group("ss_searcher_find_next");
+
+    ss s = ss_new_from_raw("abababab");
+    ss_searcher searcher = ss_searcher_new_raw("abab");
+
+    test_subgroup("overlapping matches");
+    test_equal("should find the first match", 0, ss_searcher_find_next(searcher, s, 0));
+    test_equal("should find the overlapping match", 2, ss_searcher_find_next(searcher, s, 1));
+    test_equal("should find the last match", 4, ss_searcher_find_next(searcher, s, 4));
+    test_equal("shouldn't match after the last one", -1, ss_searcher_find_next(searcher, s, 5));
+
+    test_subgroup("out of range");
+    test_equal("should accept the length", -1, ss_searcher_find_next(searcher, s, s->len));
+    test_equal("shouldn't match past the length", -1, ss_searcher_find_next(searcher, s, 100));
+
+    test_subgroup("raw buffer");
+    test_equal("should find from the position", 2, ss_searcher_find_next_raw_len(searcher, "abababab", 8, 2));
+    ss_searcher_free(searcher);
+    ss_free(s);
+}
+
+void test_ss_searcher_count(void) {
+    test_group("ss_searcher_count");
+
+    test_subgroup("non-overlapping matches");
+    ss s = ss_new_from_raw("aaaaa");
+    ss_searcher searcher = ss_searcher_new_raw("aa");
+    test_equal("should count non-overlapping matches", 2, ss_searcher_count(searcher, s));
+    ss_searcher_free(searcher);
+    ss_free(s);
+
+    test_subgroup("many strings");
+    searcher = ss_searcher_new_raw(", ");
+    const char *lines[] = {"a, b, c", "no match", ", , ", ""};
+    size_t want[] = {2, 0, 2, 0};
+    int ok = 1;
+    for (int i = 0; i < 4; i++) {
+        ok = ok && ss_searcher_count_raw_len(searcher, lines[i], strlen(lines[i])) == want[i];
+    }
+    test_cond("should count in each string", ok);
+    ss_searcher_free(searcher);
+}
+
+void test_ss_split_raw_searcher(void) {
+    test_group("ss_split_raw_searcher");
+
+    test_subgroup("same pieces of ss_split_raw");
+    ss_searcher searcher = ss_searcher_new_raw("&&");
+    int n;
+    ss *list = ss_split_raw_searcher("&&key=value&&name=ehy&&&&id=42&&", searcher, &n);
+    test_equal("should have correct number of pieces", 3, n);
+    test_strings("should have the first piece", "key=value", list[0]->buf);
+    test_strings("should have the last piece", "id=42", list[2]->buf);
+    ss_list_free(list, n);
+
+    test_subgroup("no match");
+    list = ss_split_raw_searcher("Ehy, how are you?", searcher, &n);
+    test_equal("should return the whole string", 1, n);
+    test_strings("should have the string", "Ehy, how are you?", list[0]->buf);
+    ss_list_free(list, n);
+
+    test_subgroup("null bytes");
+    ss s = ss_new_from_raw_len("a&&b\0c&&", 8);
+    list = ss_split_str_searcher(s, searcher, &n);
+    test_equal("should have correct number of pieces", 2, n);
+    test_equal("should keep the null byte", 3, list[1]->len);
+    ss_list_free(list, n);
+    ss_free(s);
+
+    test_subgroup("reuse the list");
+    ss_list lines = ss_list_new();
+    s = ss_new_from_raw("a&&b&&c");
+    ss_split_str_searcher_list(lines, s, searcher);
+    ss *items = lines->items;
+    ss_list_clear(lines);
+    ss_split_str_searcher_list(lines, s, searcher);
+    test_equal("should have correct len", 3, lines->len);
+    test_strings("should have the pieces", "c", lines->items[2]->buf);
+    test_cond("shouldn't reallocate the array", lines->items == items);
+    ss_list_destroy(lines);
+    ss_free(s);
+
+    test_subgroup("iterator");
+    ss_split_iter it;
+    ss_view piece;
+    ss_split_iter_init_searcher(&it, "x&&&y", 5, searcher);
+    ss_split_iter_next(&it, &piece);
+    test_cond("should yield the first piece", ss_view_equal_raw(piece, "x"));
+    ss_split_iter_next(&it, &piece);
+    test_cond("should yield the second piece", ss_view_equal_raw(piece, "&y"));
+    test_cond("should end", !ss_split_iter_next(&it, &piece));
+    ss_searcher_free(searcher);
+
+    test_subgroup("empty needle");
+    searcher = ss_searcher_new_raw("");
+    list = ss_split_raw_searcher("Ehy", searcher, &n);
+    test_equal("should return the whole string", 1, n);
+    ss_list_free(list, n);
+    ss_searcher_free(searcher);
+}
@@ -0,0 +1,10 @@
+#ifndef SS_TESTS_STRING_SEARCHER_TEST_H
+#define SS_TESTS_STRING_SEARCHER_TEST_H
+
+void test_ss_searcher_new(void);
+void test_ss_searcher_find(void);
+void test_ss_searcher_find_next(void);
+void test_ss_searcher_count(void);
+void test_ss_split_raw_searcher(void);
+
+#endif
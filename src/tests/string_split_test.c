@@ -1,3 +1,4 @@
+#include <string.h>
 #include <strings.h>
 #include "../string.h"
 #include "../string_fmt.h"
@@ -6,6 +7,7 @@
 #include "../private/debug.h"
 
 void test_strings_from_list(ss *got_str_list, int got_str_num, char **want_strings, int want_strings_num);
+void test_views_from_list(ss_view *got_view_list, int got_view_num, char **want_strings, int want_strings_num);
 
 void test_ss_split_raw(void) {
     test_group("ss_split_raw");
@@ -45,6 +47,13 @@ void test_ss_split_raw(void) {
     strings = ss_split_raw("      ", " ", &n);
     test_strings_from_list(strings, n, (char *[]) {}, 0);
     ss_list_free(strings, n);
+
+    test_subgroup("pieces fitting the inline array");
+    strings = ss_split_raw("ehy, how are you doing,fine", ",", &n);
+    test_strings_from_list(strings, n, (char *[]) {"ehy", " how are you doing", "fine"}, 3);
+    test_cond("should store the 18 bytes piece inline", strings[1]->buf == strings[1]->inl);
+    test_equal("should keep the inline space as free", SS_INLINE_CAP - 19, strings[1]->free);
+    ss_list_free(strings, n);
 }
 
 void test_ss_split_str(void) {
@@ -101,6 +110,266 @@ void test_ss_split_str(void) {
     ss_free(s);
 }
 
+void test_ss_split_raw_views(void) {
+    test_group("ss_split_raw_views");
+    int n = 0;
+
+    test_subgroup("split in words");
+    const char *s = "Ehy how are you?";
+    ss_view *views = ss_split_raw_views(s, " ", &n);
+    test_views_from_list(views, n, (char *[]) {"Ehy", "how", "are", "you?"}, 4);
+    test_cond("should point into the string", views[1].ptr == s + 4);
+    ss_view_list_free(views);
+
+    test_subgroup("empty delimiter");
+    views = ss_split_raw_views(s, "", &n);
+    test_views_from_list(views, n, (char *[]) {"Ehy how are you?"}, 1);
+    ss_view_list_free(views);
+
+    test_subgroup("multiple consecutive delimiters");
+    views = ss_split_raw_views("  Ehy  ,, how,are,,  ", ",", &n);
+    test_views_from_list(views, n, (char *[]) {"  Ehy  ", " how", "are", "  "}, 4);
+    ss_view_list_free(views);
+
+    test_subgroup("only consecutive delimiters");
+    views = ss_split_raw_views("     ", " ", &n);
+    test_cond("should return NULL", views == NULL);
+    test_equal("should have no pieces", 0, n);
+}
+
+void test_ss_split_str_views(void) {
+    test_group("ss_split_str_views");
+    int n = 0;
+
+    test_subgroup("multi-char delimiter");
+    ss s = ss_new_from_raw("Ehy\r\nhow\r\n\r\nare you?\r\n");
+    ss_view *views = ss_split_str_views(s, "\r\n", &n);
+    test_views_from_list(views, n, (char *[]) {"Ehy", "how", "are you?"}, 3);
+    test_cond("should point into the buffer", views[2].ptr == s->buf + 12);
+    ss_view_list_free(views);
+    ss_free(s);
+
+    test_subgroup("null bytes");
+    s = ss_new_from_raw_len("Ehy\0how are you?", 16);
+    views = ss_split_str_views(s, " ", &n);
+    test_equal("should split the whole string", 3, n);
+    test_cond("should keep the null byte", views[0].len == 7 && memcmp(views[0].ptr, "Ehy\0how", 7) == 0);
+    ss_view_list_free(views);
+    ss_free(s);
+}
+
+void test_ss_split_views_into(void) {
+    test_group("ss_split_views_into");
+    ss_view views[3];
+    ss_view v = ss_view_from_raw("a,b,,c,d");
+
+    test_subgroup("array big enough");
+    int n = ss_split_views_into(ss_view_slice(v, 0, 6), ",", views, 3);
+    test_views_from_list(views, n, (char *[]) {"a", "b", "c"}, 3);
+
+    test_subgroup("array too small");
+    views[2] = ss_view_from_raw("untouched");
+    n = ss_split_views_into(v, ",", views, 2);
+    test_equal("should count all the pieces", 4, n);
+    test_views_from_list(views, 2, (char *[]) {"a", "b"}, 2);
+    test_cond("shouldn't write past the capacity", ss_view_equal_raw(views[2], "untouched"));
+
+    test_subgroup("count only");
+    test_equal("should count the pieces", 4, ss_split_views_into(v, ",", NULL, 0));
+}
+
+void test_ss_split_raw_packed(void) {
+    test_group("ss_split_raw_packed");
+
+    test_subgroup("split in words");
+    ss_packed list = ss_split_raw_packed("  Ehy how  are you?  ", " ");
+    test_equal("should have correct number of pieces", 4, ss_packed_len(list));
+    test_cond("should have correct pieces", ss_view_equal_raw(ss_packed_get(list, 0), "Ehy") &&
+        ss_view_equal_raw(ss_packed_get(list, 3), "you?"));
+    ss_packed_free(list);
+
+    test_subgroup("empty delimiter");
+    list = ss_split_raw_packed("Ehy how are you?", "");
+    test_equal("should have one piece", 1, ss_packed_len(list));
+    test_cond("should have the whole string", ss_view_equal_raw(ss_packed_get(list, 0), "Ehy how are you?"));
+    ss_packed_free(list);
+
+    test_subgroup("ss string");
+    ss s = ss_new_from_raw("Ehy\r\nhow\r\n\r\nare you?");
+    list = ss_split_str_packed(s, "\r\n");
+    test_equal("should have correct number of pieces", 3, ss_packed_len(list));
+    test_cond("should have correct pieces", ss_view_equal_raw(ss_packed_get(list, 2), "are you?"));
+    ss_packed_free(list);
+    ss_free(s);
+}
+
+void test_ss_split_raw_list(void) {
+    test_group("ss_split_raw_list");
+
+    test_subgroup("split in words");
+    ss_list list = ss_list_new();
+    ss_split_raw_list(list, "  Ehy how  are you?  ", " ");
+    test_equal("should have correct number of pieces", 4, list->len);
+    test_strings("should have the first piece", "Ehy", list->items[0]->buf);
+    test_strings("should have the last piece", "you?", list->items[3]->buf);
+    test_equal("should have no free space", 0, list->items[3]->free);
+
+    test_subgroup("append to the list");
+    ss_split_raw_list(list, "Ehy\r\nhow", "\r\n");
+    test_equal("should append the pieces", 6, list->len);
+    test_strings("should have the last piece", "how", list->items[5]->buf);
+
+    test_subgroup("reuse the list");
+    ss *items = list->items;
+    ss_list_clear(list);
+    ss s = ss_new_from_raw("a,b,,c");
+    ss_split_str_list(list, s, ",");
+    test_equal("should have correct len", 3, list->len);
+    test_strings("should have the pieces", "c", list->items[2]->buf);
+    test_cond("shouldn't reallocate the array", list->items == items);
+    ss_free(s);
+    ss_list_destroy(list);
+}
+
+void test_ss_split_iter(void) {
+    test_group("ss_split_iter");
+    ss_split_iter it;
+    ss_view piece;
+
+    test_subgroup("single-char delimiter");
+    ss_split_iter_init_raw(&it, "  Ehy how  are you?  ", " ");
+    const char *want[] = {"Ehy", "how", "are", "you?"};
+    int n = 0;
+    while (ss_split_iter_next(&it, &piece)) {
+        if (n < 4 && !ss_view_equal_raw(piece, want[n])) break;
+        n++;
+    }
+    test_equal("should yield all the pieces in order", 4, n);
+    test_cond("should keep returning zero at the end", !ss_split_iter_next(&it, &piece));
+    test_equal("should set an empty piece at the end", 0, piece.len);
+
+    test_subgroup("reset");
+    ss_split_iter_reset(&it);
+    test_cond("should yield a piece", ss_split_iter_next(&it, &piece));
+    test_cond("should restart from the first piece", ss_view_equal_raw(piece, "Ehy"));
+
+    test_subgroup("multi-char delimiter");
+    ss s = ss_new_from_raw("key=value&&name=ehy&&&&id=42&&");
+    ss_split_iter_init_str(&it, s, "&&");
+    ss_split_iter_next(&it, &piece);
+    test_cond("should yield the first piece", ss_view_equal_raw(piece, "key=value"));
+    test_cond("should point into the string", piece.ptr == s->buf);
+    ss_split_iter_next(&it, &piece);
+    test_cond("should yield the second piece", ss_view_equal_raw(piece, "name=ehy"));
+    ss_split_iter_next(&it, &piece);
+    test_cond("should skip empty pieces", ss_view_equal_raw(piece, "id=42"));
+    test_cond("should end after trailing delimiters", !ss_split_iter_next(&it, &piece));
+    ss_free(s);
+
+    test_subgroup("empty delimiter");
+    ss_split_iter_init_raw_len(&it, "Ehy how are you?", 7, "");
+    ss_split_iter_next(&it, &piece);
+    test_cond("should yield the whole buffer", ss_view_equal_raw(piece, "Ehy how"));
+    test_cond("should yield a single piece", !ss_split_iter_next(&it, &piece));
+
+    test_subgroup("empty string");
+    ss_split_iter_init_raw(&it, "", ",");
+    test_cond("should yield no pieces", !ss_split_iter_next(&it, &piece));
+}
+
+void test_ss_split_raw_any(void) {
+    test_group("ss_split_raw_any");
+    int n;
+
+    test_subgroup("collapse delimiters");
+    ss *list = ss_split_raw_any(" Ehy,how;; are|you? ", " ,;|", split_collapse, &n);
+    test_strings_from_list(list, n, (char *[]) {"Ehy", "how", "are", "you?"}, 4);
+    ss_list_free(list, n);
+
+    test_subgroup("keep empty fields");
+    list = ss_split_raw_any("a,b;;c,", ",;", split_keep_empty, &n);
+    test_equal("should have correct number of pieces", 5, n);
+    test_strings("should have the first piece", "a", list[0]->buf);
+    test_strings("should keep the empty piece", "", list[2]->buf);
+    test_strings("should have the fourth piece", "c", list[3]->buf);
+    test_strings("should keep the trailing empty piece", "", list[4]->buf);
+    ss_list_free(list, n);
+
+    test_subgroup("line endings");
+    list = ss_split_raw_any("one\r\ntwo\nthree\r\n", "\r\n", split_collapse, &n);
+    test_strings_from_list(list, n, (char *[]) {"one", "two", "three"}, 3);
+    ss_list_free(list, n);
+
+    test_subgroup("empty string and empty set");
+    list = ss_split_raw_any("", ",", split_keep_empty, &n);
+    test_equal("should have no pieces", 0, n);
+    test_cond("should return NULL", list == NULL);
+    list = ss_split_raw_any("a,b", "", split_keep_empty, &n);
+    test_strings_from_list(list, n, (char *[]) {"a,b"}, 1);
+    ss_list_free(list, n);
+
+    test_subgroup("only delimiters");
+    list = ss_split_raw_any(",;,", ",;", split_collapse, &n);
+    test_equal("should have no pieces if collapsing", 0, n);
+    ss_list_free(list, n);
+    list = ss_split_raw_any(",;,", ",;", split_keep_empty, &n);
+    test_equal("should have an empty piece for each field", 4, n);
+    ss_list_free(list, n);
+}
+
+void test_ss_split_any_views(void) {
+    test_group("ss_split_str_any_views / ss_split_any_into");
+    ss_view views[8];
+    int n;
+
+    test_subgroup("split a string with null bytes");
+    ss s = ss_new_from_raw_len("a b\0c\td", 7);
+    ss_view *list = ss_split_str_any_views(s, " \t", split_collapse, &n);
+    test_equal("should have correct number of pieces", 3, n);
+    test_equal("should keep the null byte", 3, list[1].len);
+    test_cond("should point into the string", list[0].ptr == s->buf);
+    ss_view_list_free(list);
+    ss_free(s);
+
+    test_subgroup("raw views");
+    list = ss_split_raw_any_views("x=1&y=2", "=&", split_collapse, &n);
+    test_views_from_list(list, n, (char *[]) {"x", "1", "y", "2"}, 4);
+    ss_view_list_free(list);
+
+    test_subgroup("split into an array");
+    n = ss_split_any_into(ss_view_from_raw("a|b||c"), "|", split_keep_empty, views, 2);
+    test_equal("should count all the pieces", 4, n);
+    test_views_from_list(views, 2, (char *[]) {"a", "b"}, 2);
+
+    test_subgroup("delimiters in long buffers");
+    // Put a single delimiter at each position of a buffer longer than
+    // the SIMD blocks, then check where the first piece ends.
+    char buf[100];
+    int ok = 1;
+    const char *sets[] = {";", ";,", "\t\n\r ;,", "abcdefghijklmnopqrstuvwxyz;"};
+    for (int k = 0; k < 4; k++) {
+        for (int pos = 0; pos < (int)sizeof(buf); pos++) {
+            memset(buf, '_', sizeof(buf));
+            buf[pos] = ';';
+            n = ss_split_any_into(ss_view_from_raw_len(buf, sizeof(buf)), sets[k], split_keep_empty, views, 8);
+            if (n != 2 || views[0].len != (size_t)pos || views[1].len != sizeof(buf) - pos - 1) ok = 0;
+        }
+        memset(buf, '_', sizeof(buf));
+        n = ss_split_any_into(ss_view_from_raw_len(buf, sizeof(buf)), sets[k], split_keep_empty, views, 8);
+        if (n != 1 || views[0].len != sizeof(buf)) ok = 0;
+    }
+    test_cond("should find the delimiter at any position", ok);
+
+    test_subgroup("split into a list");
+    ss_list str_list = ss_list_new();
+    s = ss_new_from_raw("1 2  3");
+    ss_split_str_any_list(str_list, s, " ", split_keep_empty);
+    test_equal("should have correct number of pieces", 4, str_list->len);
+    test_strings("should have the empty piece", "", str_list->items[2]->buf);
+    ss_free(s);
+    ss_list_destroy(str_list);
+}
+
 void test_ss_join_raw_cat(void) {
     test_group("ss_join_raw_cat");
 
@@ -319,6 +588,135 @@ void test_ss_join_str(void) {
     ss_free(s3);
 }
 
+void test_ss_join_list(void) {
+    test_group("ss_join_list");
+
+    test_subgroup("join strings");
+    ss_list list = ss_list_new();
+    ss_split_raw_list(list, "Ehy how are you?", " ");
+    ss s = ss_join_list(list, ", ");
+    test_strings("should have correct string", "Ehy, how, are, you?", s->buf);
+
+    test_subgroup("join and concat");
+    ss_join_list_cat(s, list, "");
+    test_strings("should have correct string", "Ehy, how, are, you?Ehyhowareyou?", s->buf);
+    ss_free(s);
+
+    test_subgroup("NULL separator");
+    s = ss_join_list(list, NULL);
+    test_strings("should join without separator", "Ehyhowareyou?", s->buf);
+    ss_join_list_cat(s, list, NULL);
+    test_strings("should concat without separator", "Ehyhowareyou?Ehyhowareyou?", s->buf);
+    ss_free(s);
+    ss_list_destroy(list);
+}
+
+void test_ss_join_packed(void) {
+    test_group("ss_join_packed");
+
+    test_subgroup("join pieces");
+    ss_packed list = ss_split_raw_packed("Ehy how are you?", " ");
+    ss s = ss_join_packed(list, ", ");
+    test_strings("should have correct string", "Ehy, how, are, you?", s->buf);
+    test_equal("should allocate the exact size", 0, s->free);
+
+    test_subgroup("join and concat");
+    ss_join_packed_cat(s, list, "");
+    test_strings("should have correct string", "Ehy, how, are, you?Ehyhowareyou?", s->buf);
+    ss_free(s);
+
+    test_subgroup("empty list");
+    ss_packed_clear(list);
+    s = ss_join_packed(list, ", ");
+    test_strings("should be empty", "", s->buf);
+    ss_free(s);
+    ss_packed_free(list);
+}
+
+void test_ss_join_sized(void) {
+    test_group("ss_join_raw_sized / ss_join_str_sized");
+
+    test_subgroup("join C strings");
+    const char *raw[] = {"Ehy", "how", NULL, "are", "you?"};
+    ss s = ss_join_raw_sized(raw, 5, " ");
+    test_strings("should have correct string", "Ehy how  are you?", s->buf);
+    test_equal("should have correct length", 17, s->len);
+    test_equal("should allocate the exact size", 0, s->free);
+
+    test_subgroup("join and concat C strings");
+    ss_err err = ss_join_raw_sized_cat(s, raw, 2, "-");
+    test_equal("should not return errors", err_none, err);
+    test_strings("should have correct string", "Ehy how  are you?Ehy-how", s->buf);
+    test_equal("should grow to the exact size", 0, s->free);
+    ss_free(s);
+
+    test_subgroup("join ss strings");
+    ss str[] = {ss_new_from_raw("one"), ss_new_from_raw(""), ss_new_from_raw("three")};
+    s = ss_join_str_sized(str, 3, ", ");
+    test_strings("should have correct string", "one, , three", s->buf);
+    test_equal("should allocate the exact size", 0, s->free);
+
+    test_subgroup("join and concat in the free space");
+    ss_reserve_free_space(s, 100);
+    size_t free = s->free;
+    err = ss_join_str_sized_cat(s, str, 3, "");
+    test_equal("should not return errors", err_none, err);
+    test_strings("should have correct string", "one, , threeonethree", s->buf);
+    test_equal("should use the free space", free - 8, s->free);
+    ss_free(s);
+
+    test_subgroup("join shared string");
+    s = ss_new_from_raw("start:");
+    ss copy = ss_clone_shared(s);
+    ss_join_str_sized_cat(copy, str, 3, "|");
+    test_strings("should modify the joined string", "start:one||three", copy->buf);
+    test_strings("should not modify the other string", "start:", s->buf);
+    ss_free(copy);
+    ss_free(s);
+    for (int i = 0; i < 3; i++) ss_free(str[i]);
+
+    test_subgroup("NULL separator");
+    s = ss_join_raw_sized(raw, 5, NULL);
+    test_strings("should join without separator", "Ehyhowareyou?", s->buf);
+    ss str2[] = {ss_new_from_raw("one"), ss_new_from_raw("two")};
+    ss_join_str_sized_cat(s, str2, 2, NULL);
+    test_strings("should concat without separator", "Ehyhowareyou?onetwo", s->buf);
+    ss_free(s);
+    ss_packed packed = ss_split_raw_packed("a b c", " ");
+    s = ss_join_packed(packed, NULL);
+    test_strings("should join packed pieces without separator", "abc", s->buf);
+    ss_free(s);
+    ss_packed_free(packed);
+    for (int i = 0; i < 2; i++) ss_free(str2[i]);
+
+    test_subgroup("empty array");
+    s = ss_join_raw_sized(raw, 0, ", ");
+    test_strings("should be empty", "", s->buf);
+    test_equal("should have zero length", 0, s->len);
+    ss_free(s);
+
+    test_subgroup("parallel copy");
+    ss_set_join_parallel(64, 3);
+    ss words = ss_new_from_raw("start");
+    for (int i = 0; i < 100; i++) ss_concat_raw(words, " abc def ghi");
+    ss_list list = ss_list_new();
+    ss_split_str_list(list, words, " ");
+    s = ss_join_list(list, " ");
+    test_equal("should have correct length", words->len, s->len);
+    test_strings("should have correct string", words->buf, s->buf);
+    test_equal("should allocate the exact size", 0, s->free);
+    ss_free(s);
+
+    test_subgroup("parallel copy of a few pieces");
+    s = ss_join_raw_sized(raw, 2, "--------------------------------------------------------------------");
+    test_strings("should have correct string",
+                 "Ehy--------------------------------------------------------------------how", s->buf);
+    ss_free(s);
+    ss_set_join_parallel(4 << 20, 4);
+    ss_list_destroy(list);
+    ss_free(words);
+}
+
 
 void test_strings_from_list(ss *got_str_list, int got_str_num, char **want_strings, int want_strings_num) {
     if (got_str_num != want_strings_num) {
@@ -339,10 +737,15 @@ void test_strings_from_list(ss *got_str_list, int got_str_num, char **want_strin
             return;
         }
 
-        if (strlen(want_strings[i]) != got_str_list[i]->len || got_str_list[i]->free != got_str_list[i]->len) {
+        // Pieces reserve as much free space as their length, but the ones
+        // fitting the inline array only keep the space left there.
+        size_t want_len = strlen(want_strings[i]);
+        size_t want_free = want_len;
+        if (want_len + 1 <= SS_INLINE_CAP && 2 * want_len + 1 > SS_INLINE_CAP) want_free = SS_INLINE_CAP - want_len - 1;
+        if (want_len != got_str_list[i]->len || got_str_list[i]->free != want_free) {
             ss s = ss_sprintf(
                 "want len: %d, got len: %d, want free: %d, got free %d",
-                strlen(want_strings[i]), got_str_list[i]->len, got_str_list[i]->len, got_str_list[i]->free
+                want_len, got_str_list[i]->len, want_free, got_str_list[i]->free
            );
             test_failure(s->buf);
             ss_free(s);
@@ -352,6 +755,28 @@ void test_strings_from_list(ss *got_str_list, int got_str_num, char **want_strin
 
     test_success("should have correct number of strings");
     test_success("should have correct and equal strings");
-    test_success("should have len = free");
+    test_success("should have correct free space");
 }
 
+void test_views_from_list(ss_view *got_view_list, int got_view_num, char **want_strings, int want_strings_num) {
+    if (got_view_num != want_strings_num) {
+        ss s = ss_sprintf(
+                "should have correct number of views: want '%d', got '%d'",
+                want_strings_num, got_view_num
+        );
+        test_failure(s->buf);
+        ss_free(s);
+        return;
+    }
+
+    for (int i = 0; i < got_view_num; i++) {
+        if (!ss_view_equal_raw(got_view_list[i], want_strings[i])) {
+            ss s = ss_sprintf("want '%s', got '%.*s'", want_strings[i], (int)got_view_list[i].len, got_view_list[i].ptr);
+            test_failure(s->buf);
+            ss_free(s);
+            return;
+        }
+    }
+
+    test_success("should have correct views");
+}
@@ -4,9 +4,20 @@
 
 void test_ss_split_raw(void);
 void test_ss_split_str(void);
+void test_ss_split_raw_views(void);
+void test_ss_split_str_views(void);
+void test_ss_split_views_into(void);
+void test_ss_split_raw_packed(void);
+void test_ss_split_raw_list(void);
+void test_ss_split_iter(void);
+void test_ss_split_raw_any(void);
+void test_ss_split_any_views(void);
 void test_ss_join_raw_cat(void);
 void test_ss_join_raw(void);
 void test_ss_join_str_cat(void);
 void test_ss_join_str(void);
+void test_ss_join_list(void);
+void test_ss_join_packed(void);
+void test_ss_join_sized(void);
 
 #endif
@@ -0,0 +1,111 @@
+#include "options.h"
+#include "../string.h"
+#include "../string_stats.h"
+#include "framework/framework.h"
+#include "string_stats_test.h"
+
+#ifdef SS_STATS
+
+#include <pthread.h>
+
+static void *create_strings(void *arg);
+static void *get_thread_stats(void *arg);
+
+void test_ss_stats_get(void) {
+    test_group("ss_stats_get");
+
+    test_subgroup("string operations");
+    ss_stats before, after;
+    ss_stats_get(&before);
+    ss s = ss_new_from_raw_len_free("ehy, how are you doing?", 23, 0);
+    ss_prepend_raw("Hello! ", s);
+    ss_concat_raw(s, " I'm fine, thanks! What about you, man?");
+    ss_slice(s, 7, s->len);
+    ss_trim(s, "e");
+    ss_stats_get(&after);
+    test_cond("should count the allocations", after.n_malloc > before.n_malloc);
+    test_cond("should count the allocated bytes", after.malloc_bytes > before.malloc_bytes);
+    test_cond("should count the concat reallocs", after.n_concat_realloc == before.n_concat_realloc + 1);
+    test_cond("should count the prepend reallocs", after.n_prepend_realloc == before.n_prepend_realloc + 1);
+    test_cond("should count the moved bytes", after.memmove_bytes == before.memmove_bytes + 23 + 62 + 61);
+    test_cond("should count the live strings", after.n_live == before.n_live + 1);
+    ss_free(s);
+    ss_stats_get(&after);
+    test_cond("should count the freed strings", after.n_live == before.n_live);
+
+    test_subgroup("multiple threads");
+    ss_stats_get(&before);
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) pthread_create(&threads[i], NULL, create_strings, NULL);
+    for (int i = 0; i < 4; i++) pthread_join(threads[i], NULL);
+    ss_stats_get(&after);
+    test_cond("should aggregate the counters of all threads", after.n_concat_realloc >= before.n_concat_realloc + 400);
+    test_cond("should keep the live strings count", after.n_live == before.n_live);
+}
+
+void test_ss_stats_get_thread(void) {
+    test_group("ss_stats_get_thread");
+
+    test_subgroup("other threads");
+    ss_stats before, after;
+    ss_stats_get_thread(&before);
+    pthread_t thread;
+    pthread_create(&thread, NULL, create_strings, NULL);
+    pthread_join(thread, NULL);
+    ss_stats_get_thread(&after);
+    test_cond("should not count other threads", after.n_malloc == before.n_malloc);
+
+    test_subgroup("calling thread");
+    ss s = ss_new_from_raw("ehy, how are you doing?");
+    ss_stats_get_thread(&after);
+    test_cond("should count the calling thread", after.n_live == before.n_live + 1);
+    ss_free(s);
+
+    test_subgroup("new thread after terminated threads");
+    pthread_create(&thread, NULL, create_strings, NULL);
+    pthread_join(thread, NULL);
+    pthread_create(&thread, NULL, get_thread_stats, &after);
+    pthread_join(thread, NULL);
+    test_cond("should start from zero", after.n_malloc == 0 && after.n_concat_realloc == 0);
+    test_cond("should have no live strings", after.n_live == 0);
+}
+
+static void *create_strings(void *arg) {
+    for (int i = 0; i < 100; i++) {
+        ss s = ss_new_from_raw_len_free("", 0, 0);
+        ss_concat_raw(s, "ehy, how are you doing?");
+        ss_free(s);
+    }
+    return arg;
+}
+
+static void *get_thread_stats(void *arg) {
+    ss_stats_get_thread(arg);
+    return arg;
+}
+
+#else
+
+void test_ss_stats_get(void) {
+    test_group("ss_stats_get");
+
+    test_subgroup("statistics disabled");
+    ss_stats stats;
+    ss s = ss_new_from_raw("ehy, how are you doing?");
+    ss_stats_get(&stats);
+    test_cond("should have zero counters", stats.n_malloc == 0 && stats.n_live == 0);
+    ss_free(s);
+}
+
+void test_ss_stats_get_thread(void) {
+    test_group("ss_stats_get_thread");
+
+    test_subgroup("statistics disabled");
+    ss_stats stats;
+    ss s = ss_new_from_raw("ehy, how are you doing?");
+    ss_stats_get_thread(&stats);
+    test_cond("should have zero counters", stats.n_malloc == 0 && stats.n_live == 0);
+    ss_free(s);
+}
+
+#endif
@@ -0,0 +1,7 @@
+#ifndef SS_TESTS_STRING_STATS_TEST_H
+#define SS_TESTS_STRING_STATS_TEST_H
+
+void test_ss_stats_get(void);
+void test_ss_stats_get_thread(void);
+
+#endif
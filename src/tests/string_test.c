@@ -1,4 +1,6 @@
 #include <strings.h>
+#include <string.h>
+#include "options.h"
 #include "../string.h"
 #include "framework/framework.h"
 #include "../private/debug.h"
@@ -40,6 +42,38 @@ void test_ss_new_from_raw_len_free(void) {
     test_equal("should have correct free", 0, s->free);
     test_strings("should have correct string", s->buf, "tes");
     ss_free(s);
+
+    test_subgroup("small string");
+    s = ss_new_from_raw_len_free("testing", 7, SS_INLINE_CAP - 8);
+    test_equal("should have correct len", 7, s->len);
+    test_equal("should have correct free", SS_INLINE_CAP - 8, s->free);
+    test_strings("should have correct string", s->buf, "testing");
+    test_cond("should store the string inline", s->buf == s->inl);
+    ss_free(s);
+
+    test_subgroup("string bigger than inline capacity");
+    s = ss_new_from_raw_len_free("testing", 7, SS_INLINE_CAP - 7);
+    test_equal("should have correct len", 7, s->len);
+    test_equal("should have correct free", SS_INLINE_CAP - 7, s->free);
+    test_strings("should have correct string", s->buf, "testing");
+    test_cond("shouldn't store the string inline", s->buf != s->inl);
+    ss_free(s);
+#ifdef SS_SINGLE_ALLOC
+
+    test_subgroup("single allocation");
+    s = ss_new_from_raw_len_free("ehy, how are you doing?", 23, 10);
+    test_cond("should store the buffer right after the struct", s->buf == (char *)(s + 1));
+    ss_set_free_space(s, 4);
+    test_equal("should reduce free", 4, s->free);
+    test_cond("should shrink the buffer in place", s->buf == (char *)(s + 1));
+    ss_concat_raw_len(s, " I'm fine, thanks! What about you?", 34);
+    test_strings("should have correct string", "ehy, how are you doing? I'm fine, thanks! What about you?", s->buf);
+    test_cond("should move the buffer out of the struct", s->buf != (char *)(s + 1));
+    ss_set_free_space(s, 100);
+    test_equal("should have correct free", 100, s->free);
+    test_strings("should keep the string", "ehy, how are you doing? I'm fine, thanks! What about you?", s->buf);
+    ss_free(s);
+#endif
 }
 
 void test_ss_new_from_raw_len(void) {
@@ -94,9 +128,22 @@ void test_ss_new_from_raw(void) {
     test_subgroup("non empty string");
     s = ss_new_from_raw(" \\!ehy you__\n");
     test_equal("should have correct len", 13, s->len);
-    test_equal("should have correct free", 13, s->free);
+    test_equal("should have correct free", SS_INLINE_CAP - 14, s->free);
     test_strings("should have correct string", s->buf, " \\!ehy you__\n");
     ss_free(s);
+
+    test_subgroup("string filling the inline array");
+    s = ss_new_from_raw("ehy, how are you?!!!");
+    test_equal("should have correct len", 20, s->len);
+    test_equal("should keep the inline space as free", SS_INLINE_CAP - 21, s->free);
+    test_cond("should store the string inline", s->buf == s->inl);
+    ss_free(s);
+
+    test_subgroup("string bigger than inline capacity");
+    s = ss_new_from_raw("ehy, how are you? I'm fine");
+    test_equal("should have correct free", 26, s->free);
+    test_cond("shouldn't store the string inline", s->buf != s->inl);
+    ss_free(s);
 }
 
 void test_ss_new_empty_with_free(void) {
@@ -128,6 +175,38 @@ void test_ss_new_empty(void) {
     ss_free(s);
 }
 
+void test_ss_new_on_buf(void) {
+    test_group("ss_new_on_buf");
+
+    test_subgroup("caller provided memory");
+    struct ss hdr;
+    char buf[32];
+    ss s = ss_new_on_buf(&hdr, buf, sizeof(buf));
+    test_cond("should use the provided struct", s == &hdr);
+    test_cond("should use the provided buffer", s->buf == buf);
+    test_equal("should have len 0", 0, s->len);
+    test_equal("should have free 31", 31, s->free);
+
+    test_subgroup("operations within the buffer");
+    ss_concat_raw(s, "  Ehy, how are you doing?");
+    ss_trim(s, " ");
+    ss_to_lower(s);
+    ss_slice(s, 5, s->len);
+    test_cond("should keep the provided buffer", s->buf == buf);
+    test_strings("should have correct string", "how are you doing?", s->buf);
+    test_equal("should find substrings", 4, ss_index(s, "are"));
+
+    test_subgroup("spill to heap");
+    ss_concat_raw(s, " I'm fine, thanks!");
+    test_cond("should move to a heap buffer", s->buf != buf);
+    test_strings("should have correct string", "how are you doing? I'm fine, thanks!", s->buf);
+    ss_free(s);
+    test_success("should free only the heap buffer");
+
+    test_subgroup("invalid arguments");
+    test_cond("should return NULL on empty buffer", ss_new_on_buf(&hdr, buf, 0) == NULL);
+}
+
 void test_ss_clone(void) {
     test_group("ss_clone");
 
@@ -148,6 +227,52 @@ void test_ss_clone(void) {
     ss_free(s2);
 }
 
+void test_ss_clone_shared(void) {
+    test_group("ss_clone_shared");
+
+    test_subgroup("shared buffer");
+    ss s1 = ss_new_from_raw("ehy, how are you doing? I'm fine, thanks!");
+    ss s2 = ss_clone_shared(s1);
+    ss s3 = ss_clone_shared(s1);
+    test_cond("should share the buffer", s1->buf == s2->buf && s2->buf == s3->buf);
+    test_equal("should have same len", s1->len, s2->len);
+    test_equal("should have same free", s1->free, s2->free);
+    test_strings("should have same string", s1->buf, s3->buf);
+
+    test_subgroup("detach on concat");
+    ss_concat_raw(s2, " And you?");
+    test_cond("should have own buffer", s2->buf != s1->buf);
+    test_strings("should have concatenated string", "ehy, how are you doing? I'm fine, thanks! And you?", s2->buf);
+    test_strings("should leave the other strings untouched", "ehy, how are you doing? I'm fine, thanks!", s1->buf);
+
+    test_subgroup("detach on in place mutations");
+    ss_to_upper(s3);
+    test_strings("should have uppercase string", "EHY, HOW ARE YOU DOING? I'M FINE, THANKS!", s3->buf);
+    test_strings("should leave the other strings untouched", "ehy, how are you doing? I'm fine, thanks!", s1->buf);
+    ss_free(s3);
+    s3 = ss_clone_shared(s1);
+    ss_slice(s3, 5, 8);
+    test_strings("should have sliced string", "how", s3->buf);
+    ss_trim(s1, "eh!");
+    test_strings("should have trimmed string", "y, how are you doing? I'm fine, thanks", s1->buf);
+    ss_free(s3);
+    ss_free(s2);
+
+    test_subgroup("release order");
+    s2 = ss_clone_shared(s1);
+    ss_free(s1);
+    test_strings("should survive the original string", "y, how are you doing? I'm fine, thanks", s2->buf);
+    ss_free(s2);
+
+    test_subgroup("inline string");
+    s1 = ss_new_from_raw("ehy");
+    s2 = ss_clone_shared(s1);
+    test_cond("should copy the buffer", s1->buf != s2->buf);
+    test_strings("should have same string", s1->buf, s2->buf);
+    ss_free(s1);
+    ss_free(s2);
+}
+
 void test_ss_set_free_space(void) {
     test_group("ss_set_free_space");
 
@@ -196,6 +321,208 @@ void test_ss_reserve_free_space(void) {
     ss_free(s);
 }
 
+void test_ss_reserve_front_space(void) {
+    test_group("ss_reserve_front_space");
+
+    test_subgroup("prepend in front space");
+    ss s = ss_new_from_raw("ehy, how are you doing? I'm fine, thanks!");
+    ss_reserve_front_space(s, 16);
+    char *buf = s->buf;
+    size_t free = s->free;
+    ss_prepend_raw("[len=41]", s);
+    test_cond("shouldn't move the content", s->buf == buf - 8);
+    test_equal("shouldn't change free", free, s->free);
+    test_strings("should have correct string", "[len=41]ehy, how are you doing? I'm fine, thanks!", s->buf);
+
+    test_subgroup("front growth");
+    for (int i = 0; i < 1000; i++) ss_prepend_raw("[hdr]", s);
+    test_equal("should have correct len", 5049, s->len);
+    test_cond("should start with the last prepend", memcmp(s->buf, "[hdr][hdr]", 10) == 0);
+    test_strings("should end with the original content", "[hdr][len=41]ehy, how are you doing? I'm fine, thanks!", s->buf + 4995);
+
+    test_subgroup("tail operations");
+    ss_concat_raw(s, " Bye!");
+    ss_grow(s, 6000);
+    test_equal("should have correct len", 6000, s->len);
+    test_cond("should keep the content", memcmp(s->buf + 5049, " Bye!", 5) == 0);
+    ss_free(s);
+
+    test_subgroup("inline string");
+    s = ss_new_from_raw("ehy");
+    ss_reserve_front_space(s, 4);
+    ss_prepend_raw("oh, ", s);
+    test_strings("should have correct string", "oh, ehy", s->buf);
+    ss_free(s);
+}
+
+void test_ss_set_offset_mode(void) {
+    test_group("ss_set_offset_mode");
+
+    test_subgroup("slice and trim");
+    ss s = ss_new_from_raw("  ehy, how are you doing? I'm fine, thanks!");
+    ss_set_offset_mode(s, 1);
+    char *buf = s->buf;
+    ss_trim_left(s, " ");
+    test_cond("trim left shouldn't move the content", s->buf == buf + 2);
+    test_strings("should have correct string", "ehy, how are you doing? I'm fine, thanks!", s->buf);
+    test_equal("shouldn't change free", 43, s->free);
+    ss_slice(s, 5, 23);
+    test_cond("slice shouldn't move the content", s->buf == buf + 7);
+    test_strings("should have correct string", "how are you doing?", s->buf);
+    test_equal("should have correct free", 61, s->free);
+    ss_trim(s, "h?");
+    test_strings("should have correct string", "ow are you doing", s->buf);
+
+    test_subgroup("prepend in reclaimed space");
+    ss_prepend_raw("h", s);
+    test_cond("shouldn't move the content", s->buf == buf + 7);
+    test_strings("should have correct string", "how are you doing", s->buf);
+
+    test_subgroup("compaction on growth");
+    ss_concat_raw(s, "? I'm fine, thanks! Bye! See you tomorrow! Have a nice day! Ciao!!");
+    test_cond("should compact in place", s->buf == buf);
+    test_strings("should have correct string", "how are you doing? I'm fine, thanks! Bye! See you tomorrow! Have a nice day! Ciao!!", s->buf);
+    test_equal("should use the reclaimed space", 3, s->free);
+    ss_free(s);
+
+    test_subgroup("compaction threshold");
+    ss_set_compact_threshold(64);
+    s = ss_new_empty_with_free(1000);
+    ss_set_offset_mode(s, 1);
+    buf = s->buf;
+    for (int i = 0; i < 100; i++) ss_concat_raw(s, "line\n");
+    ss_slice(s, 40, s->len);
+    test_cond("should keep the offset below the threshold", s->buf == buf + 40);
+    ss_slice(s, 40, s->len);
+    test_cond("should keep the offset below the string length", s->buf == buf + 80);
+    while (s->len > 80) ss_slice(s, 5, s->len);
+    test_cond("should compact past the threshold and the string length", s->buf - buf < 80);
+    test_equal("should have correct len", 80, s->len);
+    test_equal("should have correct free", 920, s->free + (s->buf - buf));
+    test_cond("should keep the content", memcmp(s->buf, "line\nline\n", 10) == 0);
+    ss_set_compact_threshold(4096);
+    ss_free(s);
+
+    test_subgroup("inline string");
+    s = ss_new_from_raw("  ehy, how are you?");
+    ss_set_offset_mode(s, 1);
+    ss_trim_left(s, " ");
+    test_cond("trim left shouldn't move the content", s->buf == s->inl + 2);
+    ss_prepend_raw("!", s);
+    test_cond("should prepend in the reclaimed space", s->buf == s->inl + 1);
+    test_strings("should have correct string", "!ehy, how are you?", s->buf);
+    ss_concat_raw(s, "!!!");
+    test_cond("should compact in the inline array", s->buf == s->inl);
+    test_strings("should have correct string", "!ehy, how are you?!!!", s->buf);
+    ss_concat_raw(s, " I'm fine");
+    test_cond("should move the string to the heap", s->buf != s->inl);
+    test_strings("should have correct string", "!ehy, how are you?!!! I'm fine", s->buf);
+    ss_free(s);
+
+    test_subgroup("offset mode disabled");
+    s = ss_new_from_raw("  ehy");
+    buf = s->buf;
+    ss_trim_left(s, " ");
+    test_cond("should move the content", s->buf == buf);
+    test_strings("should have correct string", "ehy", s->buf);
+    ss_free(s);
+}
+
+void test_ss_set_growth(void) {
+    test_group("ss_set_growth");
+
+    test_subgroup("exact growth");
+    ss_set_growth(&(ss_growth){.kind = growth_exact});
+    ss s = ss_new_from_raw("ehy you");
+    test_equal("constructor shouldn't reserve free space", 0, s->free);
+    ss_concat_raw(s, "!!!");
+    test_equal("should have correct len", 10, s->len);
+    test_equal("should grow exactly", 0, s->free);
+    test_strings("should have concat strings", "ehy you!!!", s->buf);
+    ss_free(s);
+
+    test_subgroup("geometric growth");
+    ss_set_growth(&(ss_growth){.kind = growth_geometric, .factor = 1.5});
+    s = ss_new_from_raw_len_free("ehy you", 7, 0);
+    ss_concat_raw(s, "!!!");
+    test_equal("should have correct len", 10, s->len);
+    test_equal("should grow by the factor", 5, s->free);
+    ss_free(s);
+
+    test_subgroup("capped growth");
+    ss_set_growth(&(ss_growth){.kind = growth_capped, .limit = 20});
+    s = ss_new_from_raw_len_free("ehy you", 7, 0);
+    ss_concat_raw(s, "!!!");
+    test_equal("should double below the limit", 10, s->free);
+    ss_concat_raw(s, "0123456789012345678901234567890123456789");
+    test_equal("should have correct len", 50, s->len);
+    test_equal("should grow linearly above the limit", 20, s->free);
+    ss_free(s);
+
+    test_subgroup("size class growth");
+    ss_set_growth(&(ss_growth){.kind = growth_size_class});
+    s = ss_new_from_raw_len_free("ehy you", 7, 0);
+    ss_concat_raw(s, "!!!");
+    test_equal("should round to 16 bytes", 15, s->len + s->free);
+    ss_grow(s, 200);
+    test_equal("should round to the size class", 223, s->len + s->free);
+    ss_grow(s, 5000);
+    test_equal("should round to pages", 8191, s->len + s->free);
+    ss_free(s);
+
+    test_subgroup("default growth");
+    ss_set_growth(NULL);
+    s = ss_new_from_raw("ehy you");
+    test_equal("constructor should reserve len bytes", 7, s->free);
+    ss_concat_raw(s, "!!! how are you?");
+    test_equal("should have correct len", 23, s->len);
+    test_equal("should double allocated space", 23, s->free);
+    ss_free(s);
+}
+
+void test_ss_set_growth_str(void) {
+    test_group("ss_set_growth_str");
+
+    test_subgroup("string policy");
+    ss_growth exact = {.kind = growth_exact};
+    ss s = ss_new_from_raw("ehy you");
+    ss_set_growth_str(s, &exact);
+    ss_concat_raw(s, "!!! how are you?");
+    test_equal("should have correct len", 23, s->len);
+    test_equal("should follow the string policy", 0, s->free);
+
+    test_subgroup("inherited by clones");
+    ss clone = ss_clone(s);
+    ss_concat_raw(clone, "!");
+    test_equal("should follow the string policy", 0, clone->free);
+    ss_free(clone);
+
+    test_subgroup("back to default policy");
+    ss_set_growth_str(s, NULL);
+    ss_concat_raw(s, "!");
+    test_equal("should follow the default policy", 24, s->free);
+    ss_free(s);
+
+    test_subgroup("inline string");
+    s = ss_new_from_raw("ehy you");
+    test_equal("should succeed", err_none, ss_set_growth_str(s, &exact));
+    test_cond("should move the string out of the inline array", s->buf != s->inl);
+    test_strings("should have correct string", "ehy you", s->buf);
+    test_equal("should keep free", 7, s->free);
+    clone = ss_clone(s);
+    test_cond("clone shouldn't be stored inline", clone->buf != clone->inl);
+    ss_concat_raw(clone, " all right? I'm fine, thanks!");
+    test_equal("clone should follow the string policy", 0, clone->free);
+    ss_free(clone);
+    ss_free(s);
+
+    test_subgroup("inline string with default policy");
+    s = ss_new_from_raw("ehy you");
+    test_equal("should succeed", err_none, ss_set_growth_str(s, NULL));
+    test_cond("should keep the string inline", s->buf == s->inl);
+    ss_free(s);
+}
+
 void test_ss_grow(void) {
     test_group("ss_grow");
 
@@ -293,7 +620,45 @@ void test_ss_index(void) {
     test_subgroup("multiple char, match at end");
     i = ss_index(s, "eHy");
     test_equal("should have found first occurrence at  end", 12, i);
+    ss_free(s);
 
+    test_subgroup("null bytes");
+    s = ss_new_from_raw_len("ab\0cd\0ef", 8);
+    test_equal("should search after null bytes", 6, ss_index(s, "ef"));
+    test_equal("should search after null bytes (one char)", 7, ss_index(s, "f"));
+    ss_free(s);
+
+    test_subgroup("needles at any position of long strings");
+    // Put each needle at each position of a string longer than the SIMD
+    // blocks, after a partial match, and check that it's found there.
+    const char *needles[] = {"xy", "xyz", "xyzxyw", "x0123456789abcdefghijklmnopqrstuvwxyz012345678y"};
+    char buf[200];
+    int ok = 1;
+    for (int k = 0; k < 4; k++) {
+        size_t len = strlen(needles[k]);
+        for (size_t pos = 0; pos + len <= sizeof(buf); pos++) {
+            memset(buf, '-', sizeof(buf));
+            if (pos >= len) memcpy(buf + pos - len, needles[k], len - 1);
+            memcpy(buf + pos, needles[k], len);
+            s = ss_new_from_raw_len(buf, sizeof(buf));
+            if (ss_index(s, needles[k]) != pos) ok = 0;
+            ss_free(s);
+        }
+    }
+    test_cond("should find the first occurrence", ok);
+
+    test_subgroup("periodic string");
+    // Each candidate matches the first and the last byte of the needle
+    // and fails in the middle, which switches to the Two-Way search.
+    s = ss_new_empty_with_free(100000);
+    for (int j = 0; j < 100000 / 4; j++) ss_concat_raw(s, "aaaa");
+    char needle[202];
+    memset(needle, 'a', 201);
+    needle[100] = 'b';
+    needle[201] = '\0';
+    test_equal("should have found no occurrence", -1, ss_index(s, needle));
+    s->buf[50000] = 'b';
+    test_equal("should have found the occurrence", 50000 - 100, ss_index(s, needle));
     ss_free(s);
 }
 
@@ -325,6 +690,104 @@ void test_ss_index_last(void) {
     test_subgroup("multiple char, match at end");
     i = ss_index_last(s, "Ehy");
     test_equal("should have found last occurrence", 8, i);
+    ss_free(s);
+
+    test_subgroup("null bytes");
+    s = ss_new_from_raw_len("ef\0ab\0ef\0", 9);
+    test_equal("should search the whole string", 6, ss_index_last(s, "ef"));
+    test_equal("should search the whole string (one char)", 7, ss_index_last(s, "f"));
+    ss_free(s);
+
+    test_subgroup("needles at any position of long strings");
+    // Put each needle at each position of a string longer than the SIMD
+    // blocks, before a partial match, and check that it's found there.
+    const char *needles[] = {"xy", "xyz", "xyzxyw", "x0123456789abcdefghijklmnopqrstuvwxyz012345678y"};
+    char buf[200];
+    int ok = 1;
+    for (int k = 0; k < 4; k++) {
+        size_t len = strlen(needles[k]);
+        for (size_t pos = 0; pos + len <= sizeof(buf); pos++) {
+            memset(buf, '-', sizeof(buf));
+            memcpy(buf + pos, needles[k], len);
+            if (pos + 2 * len <= sizeof(buf)) memcpy(buf + pos + len + 1, needles[k] + 1, len - 1);
+            s = ss_new_from_raw_len(buf, sizeof(buf));
+            if (ss_index_last(s, needles[k]) != pos) ok = 0;
+            ss_free(s);
+        }
+    }
+    test_cond("should find the last occurrence", ok);
+
+    test_subgroup("periodic string");
+    s = ss_new_empty_with_free(100000);
+    for (int j = 0; j < 100000 / 4; j++) ss_concat_raw(s, "aaaa");
+    char needle[202];
+    memset(needle, 'a', 201);
+    needle[100] = 'b';
+    needle[201] = '\0';
+    test_equal("should have found no occurrence", -1, ss_index_last(s, needle));
+    s->buf[50000] = 'b';
+    test_equal("should have found the occurrence", 50000 - 100, ss_index_last(s, needle));
+    ss_free(s);
+}
+
+void test_ss_index_from(void) {
+    test_group("ss_index_from");
+
+    ss s = ss_new_from_raw("abcabcabc");
+
+    test_subgroup("iterate the occurrences");
+    size_t i = ss_index_from(s, "abc", 0);
+    test_equal("should find the first occurrence", 0, i);
+    i = ss_index_from(s, "abc", i + 1);
+    test_equal("should find the second occurrence", 3, i);
+    i = ss_index_from(s, "abc", i + 1);
+    test_equal("should find the third occurrence", 6, i);
+    i = ss_index_from(s, "abc", i + 1);
+    test_equal("should end the occurrences", -1, i);
+
+    test_subgroup("overlapping occurrences");
+    ss_free(s);
+    s = ss_new_from_raw("aaaa");
+    test_equal("should find overlapping occurrence", 1, ss_index_from(s, "aa", 1));
+    test_equal("should find occurrence at the end", 2, ss_index_from(s, "aa", 2));
+    test_equal("should not find occurrence past the end", -1, ss_index_from(s, "aa", 3));
+
+    test_subgroup("position out of range");
+    test_equal("should find no occurrence at the end", -1, ss_index_from(s, "a", 4));
+    test_equal("should find no occurrence past the end", -1, ss_index_from(s, "a", 10));
+    test_equal("should find no occurrence of empty needle", -1, ss_index_from(s, "", 0));
+
+    ss_free(s);
+}
+
+void test_ss_index_last_before(void) {
+    test_group("ss_index_last_before");
+
+    ss s = ss_new_from_raw("abcabcabc");
+
+    test_subgroup("iterate the occurrences backward");
+    size_t i = ss_index_last_before(s, "abc", s->len);
+    test_equal("should find the last occurrence", 6, i);
+    i = ss_index_last_before(s, "abc", i);
+    test_equal("should find the second occurrence", 3, i);
+    i = ss_index_last_before(s, "abc", i);
+    test_equal("should find the first occurrence", 0, i);
+    i = ss_index_last_before(s, "abc", i);
+    test_equal("should end the occurrences", -1, i);
+
+    test_subgroup("occurrences ending at the position");
+    test_equal("should find occurrence ending at the position", 3, ss_index_last_before(s, "abc", 6));
+    test_equal("should skip occurrence crossing the position", 3, ss_index_last_before(s, "abc", 8));
+
+    test_subgroup("overlapping occurrences");
+    ss_free(s);
+    s = ss_new_from_raw("aaaa");
+    test_equal("should find overlapping occurrence", 1, ss_index_last_before(s, "aa", 3));
+
+    test_subgroup("position out of range");
+    test_equal("should search the whole string", 2, ss_index_last_before(s, "aa", 10));
+    test_equal("should find no occurrence in an empty prefix", -1, ss_index_last_before(s, "a", 0));
+    test_equal("should find no occurrence of empty needle", -1, ss_index_last_before(s, "", 4));
 
     ss_free(s);
 }
@@ -356,6 +819,24 @@ void test_ss_concat_raw_len(void) {
     test_strings("should have concat strings", "See you later!!!", s->buf);
     ss_free(s);
 
+    test_subgroup("inline string growing within inline capacity");
+    s = ss_new_from_raw("Ehy");
+    ss_concat_raw_len(s, " you", 4);
+    test_equal("should have extended len", 7, s->len);
+    test_equal("should have changed free", 7, s->free);
+    test_strings("should have concat strings", "Ehy you", s->buf);
+    test_cond("should keep the string inline", s->buf == s->inl);
+    ss_free(s);
+
+    test_subgroup("inline string growing beyond inline capacity");
+    s = ss_new_from_raw("Ehy");
+    ss_concat_raw_len(s, " you, how are you?", 18);
+    test_equal("should have extended len", 21, s->len);
+    test_equal("should have changed free", 21, s->free);
+    test_strings("should have concat strings", "Ehy you, how are you?", s->buf);
+    test_cond("should move the string to the heap", s->buf != s->inl);
+    ss_free(s);
+
     test_subgroup("one empty string");
     s = ss_new_from_raw("See you");
     ss_concat_raw_len(s, "", 0);
@@ -676,7 +1157,7 @@ void test_ss_trim(void) {
     s = ss_new_from_raw("-ey!eyeh?ehy!_hhhh?");
     ss_trim(s, "_h!y?e-?");
     test_equal("should reduce len", 0, s->len);
-    test_equal("should change free", 38, s->free);
+    test_equal("should change free", SS_INLINE_CAP - 1, s->free);
     test_strings("should have trimmed all string", "", s->buf);
     ss_free(s);
 }
@@ -720,7 +1201,7 @@ void test_ss_trim_right(void) {
     s = ss_new_from_raw("-ey!eyeh?ehy!_hhhh?");
     ss_trim_right(s, "_h!y?e-");
     test_equal("should reduce len", 0, s->len);
-    test_equal("shouldn't change free", 38, s->free);
+    test_equal("shouldn't change free", SS_INLINE_CAP - 1, s->free);
     test_strings("should have trimmed all string", "", s->buf);
     ss_free(s);
 }
@@ -764,7 +1245,7 @@ void test_ss_trim_left(void) {
     s = ss_new_from_raw("-ey!eyeh?ehy!_hhhh?");
     ss_trim_left(s, "_h!y?e-");
     test_equal("should reduce len", 0, s->len);
-    test_equal("should change free", 38, s->free);
+    test_equal("should change free", SS_INLINE_CAP - 1, s->free);
     test_strings("should have trimmed all string", "", s->buf);
     ss_free(s);
 }
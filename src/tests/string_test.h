@@ -7,17 +7,25 @@ void test_ss_new_from_raw_len(void);
 void test_ss_new_from_raw(void);
 void test_ss_new_empty_with_free(void);
 void test_ss_new_empty(void);
+void test_ss_new_on_buf(void);
 void test_ss_clone(void);
+void test_ss_clone_shared(void);
 
+void test_ss_set_growth(void);
+void test_ss_set_growth_str(void);
 void test_ss_grow(void);
 void test_ss_shrink(void);
 void test_ss_clear(void);
 
 void test_ss_set_free_space(void);
 void test_ss_reserve_free_space(void);
+void test_ss_reserve_front_space(void);
+void test_ss_set_offset_mode(void);
 
 void test_ss_index(void);
 void test_ss_index_last(void);
+void test_ss_index_from(void);
+void test_ss_index_last_before(void);
 
 void test_ss_concat_raw_len(void);
 void test_ss_concat_raw(void);
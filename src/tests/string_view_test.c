@@ -0,0 +1,148 @@
+#include <string.h>
+#include "../string.h"
+#include "../string_view.h"
+#include "framework/framework.h"
+#include "string_view_test.h"
+
+void test_ss_view_from_raw_len(void) {
+    test_group("ss_view_from_raw_len");
+
+    test_subgroup("raw string");
+    const char *s = "ehy, how are you doing?";
+    ss_view v = ss_view_from_raw_len(s, 3);
+    test_cond("should point to the string", v.ptr == s);
+    test_equal("should have correct len", 3, v.len);
+    v = ss_view_from_raw(s);
+    test_equal("should have the string len", 23, v.len);
+
+    test_subgroup("NULL string");
+    v = ss_view_from_raw(NULL);
+    test_equal("should be empty", 0, v.len);
+    test_cond("should have a valid pointer", v.ptr != NULL);
+}
+
+void test_ss_view_from_str(void) {
+    test_group("ss_view_from_str");
+
+    test_subgroup("ss string");
+    ss s = ss_new_from_raw("ehy, how are you doing?");
+    ss_view v = ss_view_from_str(s);
+    test_cond("should point to the buffer", v.ptr == s->buf);
+    test_equal("should have the string len", s->len, v.len);
+    ss_free(s);
+}
+
+void test_ss_view_slice(void) {
+    test_group("ss_view_slice");
+
+    test_subgroup("slice boundaries");
+    ss_view v = ss_view_from_raw("ehy, how are you doing?");
+    ss_view slice = ss_view_slice(v, 5, 8);
+    test_cond("should have correct content", ss_view_equal_raw(slice, "how"));
+    slice = ss_view_slice(v, 17, 100);
+    test_cond("should stop at the view end", ss_view_equal_raw(slice, "doing?"));
+    slice = ss_view_slice(v, 23, 25);
+    test_cond("shouldn't slice past the view end", slice.ptr == v.ptr && slice.len == v.len);
+    slice = ss_view_slice(v, 5, 4);
+    test_cond("shouldn't slice with reversed indexes", slice.ptr == v.ptr && slice.len == v.len);
+}
+
+void test_ss_view_index(void) {
+    test_group("ss_view_index");
+
+    test_subgroup("bounded search");
+    ss_view v = ss_view_from_raw_len("ehy, how are you doing? how", 23);
+    test_equal("should find the first occurrence", 5, ss_view_index(v, "how"));
+    test_equal("should find at the view end", 22, ss_view_index(v, "?"));
+    test_equal("shouldn't search past the view end", -1, ss_view_index(v, "? how"));
+    test_equal("should return -1 for empty needle", -1, ss_view_index(v, ""));
+    test_equal("should return -1 for NULL needle", -1, ss_view_index(v, NULL));
+
+    test_subgroup("null bytes");
+    v = ss_view_from_raw_len("ehy\0you", 7);
+    test_equal("should search past null bytes", 4, ss_view_index(v, "you"));
+}
+
+void test_ss_view_index_last(void) {
+    test_group("ss_view_index_last");
+
+    test_subgroup("bounded search");
+    ss_view v = ss_view_from_raw_len("how are you doing? how", 20);
+    test_equal("should find the last occurrence", 8, ss_view_index_last(v, "you"));
+    test_equal("should find at the view start", 0, ss_view_index_last(v, "how"));
+    test_equal("should return -1 if not found", -1, ss_view_index_last(v, "ehy"));
+    test_equal("should return -1 for empty needle", -1, ss_view_index_last(v, ""));
+}
+
+void test_ss_view_compare(void) {
+    test_group("ss_view_compare");
+
+    test_subgroup("lexicographic order");
+    ss_view ehy = ss_view_from_raw("ehy");
+    test_cond("should be equal", ss_view_compare(ehy, ss_view_from_raw_len("ehy you", 3)) == 0);
+    test_cond("should sort before", ss_view_compare(ehy, ss_view_from_raw("how")) < 0);
+    test_cond("should sort after", ss_view_compare(ehy, ss_view_from_raw("abc")) > 0);
+    test_cond("prefix should sort first", ss_view_compare(ss_view_from_raw("eh"), ehy) < 0);
+    test_cond("should compare as unsigned", ss_view_compare(ss_view_from_raw("\xff"), ehy) > 0);
+
+    test_subgroup("equal to raw");
+    test_cond("should be equal", ss_view_equal_raw(ehy, "ehy"));
+    test_cond("shouldn't be equal", !ss_view_equal_raw(ehy, "eh"));
+    test_cond("empty view should equal NULL", ss_view_equal_raw(ss_view_from_raw(""), NULL));
+}
+
+void test_ss_view_trim(void) {
+    test_group("ss_view_trim");
+
+    test_subgroup("both sides");
+    ss_view v = ss_view_from_raw("  ehy, how are you doing?\n ");
+    test_cond("should trim both sides", ss_view_equal_raw(ss_view_trim(v, " \n"), "ehy, how are you doing?"));
+    test_cond("should trim left", ss_view_equal_raw(ss_view_trim_left(v, " "), "ehy, how are you doing?\n "));
+    test_cond("should trim right", ss_view_equal_raw(ss_view_trim_right(v, " \n?"), "  ehy, how are you doing"));
+
+    test_subgroup("all trimmed");
+    ss_view trimmed = ss_view_trim(ss_view_from_raw("   "), " ");
+    test_equal("should be empty", 0, trimmed.len);
+
+    test_subgroup("null bytes");
+    trimmed = ss_view_trim(ss_view_from_raw_len(" \0ehy", 5), " ");
+    test_equal("shouldn't trim null bytes", 4, trimmed.len);
+}
+
+void test_ss_view_cut(void) {
+    test_group("ss_view_cut");
+
+    test_subgroup("tokenize");
+    ss_view rest = ss_view_from_raw("GET /index.html HTTP/1.1");
+    ss_view token;
+    test_cond("should find the delimiter", ss_view_cut(rest, " ", &token, &rest));
+    test_cond("should have the first token", ss_view_equal_raw(token, "GET"));
+    ss_view_cut(rest, " ", &token, &rest);
+    test_cond("should have the second token", ss_view_equal_raw(token, "/index.html"));
+    test_cond("shouldn't find the delimiter", !ss_view_cut(rest, " ", &token, &rest));
+    test_cond("should have the last token", ss_view_equal_raw(token, "HTTP/1.1"));
+    test_equal("should leave an empty rest", 0, rest.len);
+
+    test_subgroup("multi char delimiter");
+    ss_view key;
+    ss_view value;
+    ss_view_cut(ss_view_from_raw("Host: example.com"), ": ", &key, &value);
+    test_cond("should have the key", ss_view_equal_raw(key, "Host"));
+    test_cond("should have the value", ss_view_equal_raw(value, "example.com"));
+
+    test_subgroup("empty delimiter");
+    test_cond("shouldn't match", !ss_view_cut(value, "", &key, NULL));
+    test_cond("should return the whole view", ss_view_equal_raw(key, "example.com"));
+}
+
+void test_ss_view_to_ss(void) {
+    test_group("ss_view_to_ss");
+
+    test_subgroup("owned copy");
+    ss_view v = ss_view_slice(ss_view_from_raw("ehy, how are you doing?"), 5, 8);
+    ss s = ss_view_to_ss(v);
+    test_strings("should have correct string", "how", s->buf);
+    test_equal("should have correct len", 3, s->len);
+    test_equal("should have no free space", 0, s->free);
+    ss_free(s);
+}
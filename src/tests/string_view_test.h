@@ -0,0 +1,14 @@
+#ifndef SS_TESTS_STRING_VIEW_TEST_H
+#define SS_TESTS_STRING_VIEW_TEST_H
+
+void test_ss_view_from_raw_len(void);
+void test_ss_view_from_str(void);
+void test_ss_view_slice(void);
+void test_ss_view_index(void);
+void test_ss_view_index_last(void);
+void test_ss_view_compare(void);
+void test_ss_view_trim(void);
+void test_ss_view_cut(void);
+void test_ss_view_to_ss(void);
+
+#endif